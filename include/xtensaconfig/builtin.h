@@ -123,7 +123,7 @@
 #define XCHAL_HAVE_WINDOWED		__XCHAL_HAVE_WINDOWED
 
 #undef XCHAL_NUM_AREGS
-#define XCHAL_NUM_AREGS			__XCHAL_NUM_AREGS2
+#define XCHAL_NUM_AREGS			__XCHAL_NUM_AREGS
 
 #undef XCHAL_HAVE_WIDE_BRANCHES
 #define XCHAL_HAVE_WIDE_BRANCHES	__XCHAL_HAVE_WIDE_BRANCHES
@@ -133,16 +133,16 @@
 
 
 #undef XCHAL_ICACHE_SIZE
-#define XCHAL_ICACHE_SIZE		__XCHAL_ICACHE_SIZE6384
+#define XCHAL_ICACHE_SIZE		__XCHAL_ICACHE_SIZE
 
 #undef XCHAL_DCACHE_SIZE
-#define XCHAL_DCACHE_SIZE		__XCHAL_DCACHE_SIZE6384
+#define XCHAL_DCACHE_SIZE		__XCHAL_DCACHE_SIZE
 
 #undef XCHAL_ICACHE_LINESIZE
-#define XCHAL_ICACHE_LINESIZE		__XCHAL_ICACHE_LINESIZE2
+#define XCHAL_ICACHE_LINESIZE		__XCHAL_ICACHE_LINESIZE
 
 #undef XCHAL_DCACHE_LINESIZE
-#define XCHAL_DCACHE_LINESIZE		__XCHAL_DCACHE_LINESIZE2
+#define XCHAL_DCACHE_LINESIZE		__XCHAL_DCACHE_LINESIZE
 
 #undef XCHAL_ICACHE_LINEWIDTH
 #define XCHAL_ICACHE_LINEWIDTH		__XCHAL_ICACHE_LINEWIDTH
@@ -158,7 +158,7 @@
 #define XCHAL_HAVE_MMU			__XCHAL_HAVE_MMU
 
 #undef XCHAL_MMU_MIN_PTE_PAGE_SIZE
-#define XCHAL_MMU_MIN_PTE_PAGE_SIZE	__XCHAL_MMU_MIN_PTE_PAGE_SIZE2
+#define XCHAL_MMU_MIN_PTE_PAGE_SIZE	__XCHAL_MMU_MIN_PTE_PAGE_SIZE
 
 
 #undef XCHAL_HAVE_DEBUG
@@ -0,0 +1,73 @@
+/* Xtensa FLIX bundle packing.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_BUNDLE_H
+#define XTENSA_CONFIG_BUNDLE_H
+
+#include "xtensa-isa.h"
+#include "xtensaconfig/resources.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Formats with more slots than this are never chosen by the packer.  */
+#define XTENSA_BUNDLE_MAX_SLOTS 32
+
+/* The packer precomputes, for every opcode, the set of formats that can
+   hold it and, per format, the mask of slots that accept it.  Packing a
+   group of operations intersects the format sets, walks the surviving
+   formats from the shortest, and assigns slots by bipartite matching
+   over the slot masks.  */
+
+struct xtensa_bundler;
+
+struct xtensa_bundle
+{
+  xtensa_format format;
+  int num_slots;
+  /* Opcode placed in every slot of FORMAT; unused slots hold the
+     format's NOP for that slot.  */
+  xtensa_opcode opcodes[XTENSA_BUNDLE_MAX_SLOTS];
+  /* Index into the packed operations for every slot, or -1 for a NOP.  */
+  int op_index[XTENSA_BUNDLE_MAX_SLOTS];
+};
+
+/* Build the packer tables for ISA on top of RES, which must stay alive
+   as long as the packer.  Returns null if out of memory.  */
+extern struct xtensa_bundler *
+xtensa_bundler_init (xtensa_isa isa, struct xtensa_resources *res);
+extern void xtensa_bundler_free (struct xtensa_bundler *b);
+
+/* Pack the N opcodes in OPCS into the shortest format that holds them
+   all without a functional-unit conflict.  Formats of equal length are
+   tried in order of increasing slot count.  Returns 0 and fills in
+   *BUNDLE on success, or XTENSA_UNDEFINED if no format fits or a slot
+   without an operation has no NOP.  */
+extern int
+xtensa_bundler_pack (struct xtensa_bundler *b, const xtensa_opcode *opcs,
+		     int n, struct xtensa_bundle *bundle);
+
+/* Mask of the slots of FMT that accept OPC, or 0.  */
+extern uint32_t
+xtensa_bundler_slot_mask (const struct xtensa_bundler *b, xtensa_opcode opc,
+			  xtensa_format fmt);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_BUNDLE_H */
@@ -0,0 +1,71 @@
+/* Xtensa configuration compatibility.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_COMPAT_H
+#define XTENSA_CONFIG_COMPAT_H
+
+#include "xtensaconfig/dynconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* How code compiled for one configuration relates to another one.  The
+   xtensa_config fields are split into ABI fields that must match
+   (endianness, ABI, literal placement), optional-instruction fields that
+   code may use only when present, and tuning fields that change the
+   generated code without affecting its validity (fetch width, register
+   count and cache geometry).  The rest (cache line widths and write
+   policy, MMU, debug) do not affect user code.  The scheduling tables a
+   chip library carries tune the code the same way.  */
+
+struct xtensa_sched_tables;
+
+enum xtensa_config_compat
+{
+  XTENSA_CONFIG_INCOMPATIBLE = 0,	/* Code may not run on the other.  */
+  XTENSA_CONFIG_COMPATIBLE,		/* Valid, but may differ.  */
+  XTENSA_CONFIG_IDENTICAL		/* Same code is generated.  */
+};
+
+/* Compare FROM with TO, whose libraries have the scheduling tables
+   FROM_SCHED and TO_SCHED, or null: whether code generated for FROM is
+   valid for TO and whether it is identical to code generated for TO.
+   The relation is not symmetric for COMPATIBLE.  If FIELD is not null,
+   it is set to the name of the first field that lowered the result
+   ("xtensa_sched_tables_data" for the tables), or to null.  */
+extern enum xtensa_config_compat
+xtensa_config_compare (const struct xtensa_config *from,
+		       const struct xtensa_sched_tables *from_sched,
+		       const struct xtensa_config *to,
+		       const struct xtensa_sched_tables *to_sched,
+		       const char **field);
+
+/* Partition the N configurations in CONFIGS, with the scheduling tables
+   in SCHEDS, into classes of identical code generation.  SCHEDS may be
+   null if no library has tables.  CLASS_IDS[i] receives the class of
+   CONFIGS[i]; classes are numbered from 0 in order of first appearance.
+   Returns the number of classes.  */
+extern int
+xtensa_config_classes (const struct xtensa_config *const *configs,
+		       const struct xtensa_sched_tables *const *scheds, int n,
+		       int *class_ids);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_COMPAT_H */
@@ -0,0 +1,76 @@
+/* Xtensa composite register evaluation.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_COMPOSITE_H
+#define XTENSA_CONFIG_COMPOSITE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Composite registers, the xtensa_rmap entries with a mask, are the
+   concatenation of bit ranges of other registers, the first range in
+   the least significant bits.  Chip libraries carry every mask compiled
+   into straight-line shift-and-or code over the register image of
+   xtensaconfig/gpacket.h, and its inverse for writes.  Masks that do
+   not fit in 64 bits or take bits of registers wider than 64 bits or
+   of other composite registers are not compiled; the debugger walks
+   them as before.  */
+
+struct xtensa_composite
+{
+  int reg;				/* Index in xtensa_rmap.  */
+  int bit_size;
+  /* Null if the mask is not compiled.  */
+  uint64_t (*read) (const unsigned char *image);
+  void (*write) (unsigned char *image, uint64_t value);
+};
+
+struct xtensa_composite_table
+{
+  int num_composites;
+  const struct xtensa_composite *composites;
+  int num_regs;				/* Entries of xtensa_rmap.  */
+  const int *composite_of;		/* By rmap index; -1 if none.  */
+  /* Read every compiled composite of IMAGE into VALUES, by composite
+     index, in one pass.  */
+  void (*read_all) (const unsigned char *image, uint64_t *values);
+};
+
+/* Composites of the selected configuration, or null if its library has
+   none.  */
+extern const struct xtensa_composite_table *xtensa_config_composite (void);
+
+/* Read or write composite register REG (an rmap index) of IMAGE.
+   Return 0, or -1 if REG is not a compiled composite.  */
+extern int xtensa_composite_read (const struct xtensa_composite_table *table,
+				  int reg, const void *image,
+				  uint64_t *value);
+extern int xtensa_composite_write (const struct xtensa_composite_table *table,
+				   int reg, void *image, uint64_t value);
+
+/* Read all compiled composites of IMAGE into VALUES, which has
+   TABLE->num_composites entries; the others are left alone.  */
+extern void xtensa_composite_read_all (const struct xtensa_composite_table *table,
+				       const void *image, uint64_t *values);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_COMPOSITE_H */
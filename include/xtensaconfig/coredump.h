@@ -0,0 +1,72 @@
+/* Xtensa core dump reader.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_COREDUMP_H
+#define XTENSA_CONFIG_COREDUMP_H
+
+#include <stddef.h>
+#include "xtensaconfig/gpacket.h"
+#include "xtensaconfig/regindex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Reader of ELF core dumps as ESP-IDF writes them: one NT_PRSTATUS note
+   per task, its pr_reg an xtensa_elf_gregset_t of arch/xtensa.h.  The
+   file is mapped, not read, and the threads point into the mapping.
+   Gregsets are decoded into register images of xtensaconfig/gpacket.h,
+   several threads at a time, with registers found by name through
+   xtensaconfig/regindex.h: the special registers of the gregset, the
+   physical ar0.. registers the configuration has, and a0..a15 taken
+   from them rotated by windowbase, as the debugger does.  */
+
+struct xtensa_core_thread
+{
+  unsigned int pid;		/* pr_pid, the task handle for ESP-IDF.  */
+  const unsigned char *gregs;	/* XTENSA_ELF_NGREG target words.  */
+};
+
+struct xtensa_core
+{
+  const unsigned char *data;
+  size_t size;
+  int big_endian;		/* Byte order of the file.  */
+  int num_threads;
+  const struct xtensa_core_thread *threads;
+};
+
+/* Map and index the core file PATH.  Returns null with errno set if it
+   cannot be read, EINVAL if it is not an Xtensa ELF core.  */
+extern struct xtensa_core *xtensa_core_open (const char *path);
+extern void xtensa_core_close (struct xtensa_core *core);
+
+/* Decode every thread of CORE into IMAGES, the image of thread I at
+   I * STRIDE bytes, each of LAYOUT->image_size bytes and aligned to
+   image_align.  Registers of the image the gregset does not carry are
+   left alone.  NUM_WORKERS threads share the work, as many as the
+   machine has processors if 0.  Returns 0, or -1 if INDEX has no pc
+   register.  */
+extern int xtensa_core_decode (const struct xtensa_core *core,
+			       const struct xtensa_gpacket_layout *layout,
+			       const struct xtensa_regindex *index,
+			       void *images, size_t stride, int num_workers);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_COREDUMP_H */
@@ -0,0 +1,85 @@
+/* Xtensa instruction decoder.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_DECODER_H
+#define XTENSA_CONFIG_DECODER_H
+
+#include "xtensa-isa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Decode and encode whole instructions: format, opcode of every slot and
+   the raw field value of every operand.  Chip libraries carry a decoder
+   compiled against their own tables (xtensa_decoder_ops), with the slot
+   loops unrolled and the slot, format and length functions called
+   directly; the generic decoder goes through the xtensa-isa.h API and is
+   used for chips without one (e.g. big-endian ones).  */
+
+#define XTENSA_DECODED_MAX_SLOTS 16
+#define XTENSA_DECODED_MAX_OPERANDS 16
+/* Words of the on-stack instruction buffers of the generic decoder; ISAs
+   with longer instructions are not decoded.  The specialized decoder
+   uses the chip's own XTENSA_DECODER_INSNBUF_SIZE.  */
+#define XTENSA_DECODED_MAX_INSNBUF_SIZE 8
+
+struct xtensa_decoded_slot
+{
+  xtensa_opcode opcode;		/* XTENSA_UNDEFINED if not decodable.  */
+  /* Field value of every operand of OPCODE, in iclass order; 0 for
+     implicit operands without a field.  */
+  uint32 fields[XTENSA_DECODED_MAX_OPERANDS];
+};
+
+struct xtensa_decoded_insn
+{
+  xtensa_format format;
+  int length;
+  int num_slots;
+  struct xtensa_decoded_slot slots[XTENSA_DECODED_MAX_SLOTS];
+};
+
+struct xtensa_decoder_ops
+{
+  /* Decode the instruction at BUF, which holds LEN bytes.  Returns its
+     length, or XTENSA_UNDEFINED if it is not valid or longer than LEN.  */
+  int (*decode) (xtensa_isa isa, const unsigned char *buf, int len,
+		 struct xtensa_decoded_insn *insn);
+  /* Encode INSN (its format, and opcode and fields of every slot) into
+     BUF, which must hold the format's length.  Returns the length, or
+     XTENSA_UNDEFINED if an opcode does not fit its slot.  */
+  int (*encode) (xtensa_isa isa, const struct xtensa_decoded_insn *insn,
+		 unsigned char *buf);
+};
+
+/* The decoder for ISA: the specialized one of the loaded chip library if
+   ISA is its xtensa_modules, the generic one otherwise.  The chip library
+   is looked up once; safe to call from any thread.  */
+extern const struct xtensa_decoder_ops *xtensa_decoder_select (xtensa_isa isa);
+
+/* Shorthands for xtensa_decoder_select (ISA)->decode / ->encode.  */
+extern int xtensa_decode_insn (xtensa_isa isa, const unsigned char *buf,
+			       int len, struct xtensa_decoded_insn *insn);
+extern int xtensa_encode_insn (xtensa_isa isa,
+			       const struct xtensa_decoded_insn *insn,
+			       unsigned char *buf);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_DECODER_H */
@@ -27,6 +27,9 @@ extern "C" {
 
 void xtensa_reset_config(void);
 const char *xtensaconfig_get_option(void);
+/* Suffix of the per-tool chip library ("gcc" for xtensaconfig-<chip>-gcc.so)
+   or NULL to load the full xtensaconfig-<chip>.so.  */
+const char *xtensaconfig_get_lib_variant(void);
 
 struct xtensa_config {
     unsigned long config_size;
@@ -89,8 +92,35 @@ struct xtensa_config {
 typedef struct xtensa_isa_internal_struct xtensa_isa_internal;
 
 extern const void *xtensa_load_config (const char *name, const void *def);
+/* Like xtensa_load_config, but returns DEF instead of aborting when the
+   library does not provide NAME (e.g. it predates NAME).  */
+extern const void *xtensa_find_config (const char *name, const void *def);
+/* The generated table NAME of the chip library, or null if the library
+   has none; the xtensa_config_* accessors of the debugger tables go
+   through it.  */
+extern const void *xtensa_config_table (const char *name);
 extern struct xtensa_config *xtensa_get_config (int opt_dbg);
 
+/* Start loading the chip library for OPTION on a helper thread, as soon
+   as the tool knows the option.  The first xtensa_load_config waits for
+   it instead of loading synchronously; if it failed or was for another
+   option, the library is loaded as usual.  Does nothing for the default
+   configuration or when the library is already loaded.  */
+extern void xtensa_config_prefetch (const char *option);
+
+/* Serialized form of the current configuration, used to hand it over to
+   another process (e.g. LTO partitions) so that it does not have to load
+   the library again.  The blob carries the option value and the
+   configuration fingerprint (see xtensaconfig/fingerprint.h), which
+   becomes the fingerprint of the installed configuration.
+   xtensa_config_serialize returns the blob size and writes the blob to
+   BUF if SIZE is large enough.  xtensa_config_deserialize installs a
+   blob as the current configuration and returns the number of bytes it
+   used, or 0 if the blob is malformed, older than this library or was
+   made for another option value.  */
+extern size_t xtensa_config_serialize (void *buf, size_t size);
+extern size_t xtensa_config_deserialize (const void *buf, size_t size);
+
 #ifdef XTENSA_CONFIG_DEFINITION
 
 #ifndef XCHAL_HAVE_MUL32_HIGH
@@ -141,6 +171,11 @@ extern struct xtensa_config *xtensa_get_config (int opt_dbg);
 #define XCHAL_MMU_MIN_PTE_PAGE_SIZE 1
 #endif
 
+#endif /* XTENSA_CONFIG_DEFINITION */
+
+/* Every configuration value in struct xtensa_config order.  Users
+   redefine XTENSA_CONFIG_ENTRY to expand each name as they need.  */
+
 #define XTENSA_CONFIG_ENTRY(a) a
 
 #define XTENSA_CONFIG_ENTRY_LIST \
@@ -199,6 +234,8 @@ extern struct xtensa_config *xtensa_get_config (int opt_dbg);
     XTENSA_CONFIG_ENTRY(XTHAL_ABI_WINDOWED), \
     XTENSA_CONFIG_ENTRY(XTHAL_ABI_CALL0)
 
+#ifdef XTENSA_CONFIG_DEFINITION
+
 #define XTENSA_CONFIG_INITIALIZER { \
     sizeof (struct xtensa_config), \
     XTENSA_CONFIG_ENTRY_LIST, \
@@ -0,0 +1,72 @@
+/* Xtensa configuration fingerprint.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_FINGERPRINT_H
+#define XTENSA_CONFIG_FINGERPRINT_H
+
+#include <stddef.h>
+#include "xtensaconfig/dynconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A 128-bit FNV-1a hash over the xtensa_config values, the
+   xtensa_config_strings list and the data of the ISA tables (names,
+   sizes, flags, slot and functional-unit layout; not function
+   addresses).  It only changes when the configuration does, so it can
+   key compiler caches and validate precompiled headers.  Chip libraries
+   carry it precomputed at build time.  */
+
+#define XTENSA_FINGERPRINT_SIZE 16
+#define XTENSA_FINGERPRINT_HEX_SIZE (2 * XTENSA_FINGERPRINT_SIZE + 1)
+
+struct xtensa_fingerprint
+{
+  unsigned char bytes[XTENSA_FINGERPRINT_SIZE];
+};
+
+/* The plain FNV-1a 128 hash of the LEN bytes at DATA, most significant
+   byte first, as the fingerprint builds on it.  */
+extern void
+xtensa_fingerprint_hash (struct xtensa_fingerprint *fp, const void *data,
+			 size_t len);
+
+/* Compute the fingerprint of CONFIG, the null-terminated STRINGS list
+   and ISA, which must point to an xtensa_isa_internal.  STRINGS and ISA
+   may be null.  */
+extern void
+xtensa_fingerprint_compute (struct xtensa_fingerprint *fp,
+			    const struct xtensa_config *config,
+			    const char *const *strings, const void *isa);
+
+/* Format FP as lowercase hex into BUF of XTENSA_FINGERPRINT_HEX_SIZE.  */
+extern void
+xtensa_fingerprint_format (const struct xtensa_fingerprint *fp, char *buf);
+
+/* Fingerprint of the selected configuration.  */
+extern const struct xtensa_fingerprint *xtensa_config_fingerprint (void);
+
+/* Store in FP the fingerprint carried by the xtensa_config_serialize blob
+   BUF of SIZE bytes.  Returns 0 if BUF is not such a blob.  */
+extern int xtensa_config_blob_fingerprint (const void *buf, size_t size,
+					   struct xtensa_fingerprint *fp);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_FINGERPRINT_H */
@@ -0,0 +1,80 @@
+/* Xtensa remote 'g' packet layout.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_GPACKET_H
+#define XTENSA_CONFIG_GPACKET_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Mapping between the binary contents of a 'g' packet, where every
+   xtensa_rmap register sits at its offset in target byte order, and a
+   register image in host byte order, where the registers follow each
+   other in rmap order, each aligned to its align.  Composite registers
+   have no storage and are not part of either.  Chip libraries carry
+   the layout precomputed at build time as runs of registers that are
+   contiguous on both sides: copy runs for a target of the host's byte
+   order, moved with one memcpy each, and swap runs of registers of one
+   size for the other byte order.  */
+
+struct xtensa_gpacket_run
+{
+  unsigned int packet;		/* Offset in the packet.  */
+  unsigned int image;		/* Offset in the image.  */
+  unsigned int length;
+  unsigned int elem;		/* Register size, the unit of swapping.  */
+};
+
+struct xtensa_gpacket_layout
+{
+  int big_endian;		/* Target byte order (xchal_have_be).  */
+  unsigned int packet_size;
+  unsigned int image_size;
+  unsigned int image_align;
+  /* Every register by rmap index as a run of its own, of length 0 for
+     composite registers.  */
+  int num_regs;
+  const struct xtensa_gpacket_run *regs;
+  int num_copy_runs;
+  const struct xtensa_gpacket_run *copy_runs;
+  int num_swap_runs;
+  const struct xtensa_gpacket_run *swap_runs;
+};
+
+/* Layout of the selected configuration, or null if its library has
+   none.  */
+extern const struct xtensa_gpacket_layout *xtensa_config_gpacket (void);
+
+/* Fill IMAGE of LAYOUT->image_size bytes, aligned to image_align, from
+   the LEN bytes of PACKET.  Registers not wholly in a short packet are
+   left alone.  Returns the number of packet bytes used.  */
+extern size_t xtensa_gpacket_unpack (const struct xtensa_gpacket_layout *layout,
+				     const void *packet, size_t len,
+				     void *image);
+
+/* Fill PACKET of LAYOUT->packet_size bytes from IMAGE.  Bytes of PACKET
+   no register covers are left alone.  */
+extern void xtensa_gpacket_pack (const struct xtensa_gpacket_layout *layout,
+				 const void *image, void *packet);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_GPACKET_H */
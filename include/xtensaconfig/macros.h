@@ -0,0 +1,64 @@
+/* Xtensa configuration macro index.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_MACROS_H
+#define XTENSA_CONFIG_MACROS_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The "NAME=VALUE" entries of an xtensa_config_strings list sorted by
+   name, so that a preprocessor that defines the macros on their first
+   use finds each value without scanning the list.  The names and values
+   point into the list.  */
+
+struct xtensa_config_macro
+{
+  const char *name;		/* Not terminated after NAME_LEN bytes.  */
+  size_t name_len;
+  const char *value;
+};
+
+struct xtensa_config_macros
+{
+  size_t num_macros;
+  struct xtensa_config_macro *macros;
+};
+
+/* Index the null-terminated STRINGS into MACROS; entries without '='
+   are left out, and of several with one name the first is kept.
+   Returns 0, or -1 if out of memory.  */
+extern int xtensa_config_macros_init (struct xtensa_config_macros *macros,
+				      const char *const *strings);
+extern void xtensa_config_macros_free (struct xtensa_config_macros *macros);
+
+/* The entry of the LEN bytes NAME in MACROS, or null if there is none.  */
+extern const struct xtensa_config_macro *
+xtensa_config_macros_find (const struct xtensa_config_macros *macros,
+			   const char *name, size_t len);
+
+/* Whether VALUE is a single preprocessing number, which a macro can be
+   defined to without lexing it.  */
+extern int xtensa_config_macro_is_number (const char *value);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_MACROS_H */
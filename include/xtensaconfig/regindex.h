@@ -0,0 +1,74 @@
+/* Xtensa register lookup index.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_REGINDEX_H
+#define XTENSA_CONFIG_REGINDEX_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Hash index over the xtensa_rmap entries by name and by target_number,
+   so looking a register up costs the same whatever the size of the
+   table.  Both tables are open-addressed with linear probing over a
+   power-of-two number of slots, at most half full; where several
+   registers share a name or a target number, the first in rmap order
+   is the one found, as with a scan of the rmap.  Chip libraries carry
+   the index built at build time.  */
+
+struct xtensa_regindex_name
+{
+  const char *name;		/* Null for an empty slot.  */
+  int reg;			/* Index in xtensa_rmap.  */
+};
+
+struct xtensa_regindex_number
+{
+  unsigned int target_number;
+  int reg;			/* -1 for an empty slot.  */
+};
+
+struct xtensa_regindex
+{
+  int num_regs;			/* Entries of xtensa_rmap.  */
+  unsigned int num_slots;	/* Of each table, a power of two.  */
+  const struct xtensa_regindex_name *by_name;
+  const struct xtensa_regindex_number *by_number;
+};
+
+/* Hashes of the index, in src/reghash.c, which the generator that
+   fills the index links as well.  */
+extern uint32_t xtensa_regindex_hash_name (const char *name);
+extern uint32_t xtensa_regindex_hash_number (unsigned int target_number);
+
+/* The rmap index of the register NAME or TARGET_NUMBER in INDEX, or -1
+   if there is none.  */
+extern int xtensa_regindex_find_name (const struct xtensa_regindex *index,
+				      const char *name);
+extern int xtensa_regindex_find_number (const struct xtensa_regindex *index,
+					unsigned int target_number);
+
+/* Index of the selected configuration, or null if its library has none;
+   callers then scan the rmap.  */
+extern const struct xtensa_regindex *xtensa_config_regindex (void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_REGINDEX_H */
@@ -0,0 +1,103 @@
+/* Xtensa register transfer planning.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_REGPLAN_H
+#define XTENSA_CONFIG_REGPLAN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The xtensa_register_t entries of xtensa-tdep.h, which is left to the
+   .c files: it does not build cleanly as ISO C.  */
+struct xtensa_register;
+
+/* Plan the remote protocol packets that read a set of registers of the
+   xtensa_rmap table, e.g. the ones a stop event needs, in as few round
+   trips as the stub allows.  Composite (masked) registers are read
+   through the registers they are made of, registers that are not
+   readable are left out, and registers already known are not read again
+   unless they are volatile.  Registers covered by the stub's 'g' reply
+   are read with one 'g' or with 'p' packets, whichever costs less;
+   registers with a fetch sequence are fetched in batches, one batch per
+   coprocessor and round trip.  GDB register numbers are rmap indices.  */
+
+struct xtensa_regplan_target
+{
+  /* Number of leading rmap entries the 'g' reply carries, at their
+     offsets; 0 if the stub has no usable 'g'.  */
+  int g_regs;
+  /* Packets the stub accepts before it has to reply (1 without
+     pipelining).  */
+  int pipeline_depth;
+  /* Fetch sequences the stub runs in one round trip; 0 if it reads such
+     registers itself with 'p'.  */
+  int fetch_batch;
+  /* Cost of one round trip and of one reply byte, in any unit.  */
+  unsigned int trip_cost;
+  unsigned int byte_cost;
+};
+
+enum xtensa_regplan_kind
+{
+  XTENSA_REGPLAN_G,		/* One 'g' packet.  */
+  XTENSA_REGPLAN_P,		/* One 'p' packet.  */
+  XTENSA_REGPLAN_FETCH		/* One batch of fetch sequences.  */
+};
+
+struct xtensa_regplan_step
+{
+  enum xtensa_regplan_kind kind;
+  /* Round trip of the step; the packets of one trip are sent before
+     waiting for their replies.  */
+  int trip;
+  /* The registers the step reads, REGS[FIRST .. FIRST + COUNT) of the
+     plan; for 'g' only the requested ones.  */
+  int first;
+  int count;
+};
+
+struct xtensa_regplan
+{
+  int num_steps;
+  struct xtensa_regplan_step *steps;
+  int *regs;
+  /* Requested registers that cannot be read.  */
+  int num_unavailable;
+  int *unavailable;
+  /* Totals of the plan.  */
+  int num_trips;
+  unsigned long bytes;
+  unsigned long cost;
+};
+
+/* Plan reading the NUM_NEED registers NEED (rmap indices) of RMAP, which
+   ends with XTREG_END.  VALID, if not null, has one entry per register,
+   non-zero for registers whose value is already known.  Returns null if
+   out of memory.  */
+extern struct xtensa_regplan *
+xtensa_regplan_build (const struct xtensa_register *rmap, const int *need,
+		      int num_need, const unsigned char *valid,
+		      const struct xtensa_regplan_target *target);
+extern void xtensa_regplan_free (struct xtensa_regplan *plan);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_REGPLAN_H */
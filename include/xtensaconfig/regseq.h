@@ -0,0 +1,86 @@
+/* Pre-encoded Xtensa register fetch and store sequences.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_REGSEQ_H
+#define XTENSA_CONFIG_REGSEQ_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The fetch and store strings of the xtensa_rmap registers (e.g.
+   "rur.fcr a3"), assembled at chip build time into instruction bytes in
+   target order, so a debugger can run them on the target without an
+   assembler.  Instructions are separated by ';' or newlines.  Every
+   address register operand is a patch point: the sequence can be
+   rewritten to use other address registers than the ones in the
+   string.  */
+
+#define XTENSA_REGSEQ_PATCH_BITS 8
+/* Address registers an instruction can name.  */
+#define XTENSA_REGSEQ_NUM_AREGS 16
+
+struct xtensa_regseq_patch
+{
+  unsigned char reg;		/* Address register in the string.  */
+  unsigned char num_bits;
+  /* Bit of the sequence holding each bit of the register number, least
+     significant first: bit BITS[I] % 8 of byte BITS[I] / 8.  */
+  unsigned short bits[XTENSA_REGSEQ_PATCH_BITS];
+};
+
+struct xtensa_regseq
+{
+  /* Null if the register has no such string or it could not be
+     assembled.  */
+  const unsigned char *code;
+  unsigned int length;
+  const struct xtensa_regseq_patch *patches;
+  unsigned int num_patches;
+};
+
+struct xtensa_regseq_entry
+{
+  struct xtensa_regseq fetch;
+  struct xtensa_regseq store;
+};
+
+struct xtensa_regseq_table
+{
+  int num_regs;				/* Entries of xtensa_rmap.  */
+  const struct xtensa_regseq_entry *regs;	/* By rmap index.  */
+};
+
+/* Sequences of the selected configuration, or null if its library has
+   none.  */
+extern const struct xtensa_regseq_table *xtensa_config_regseq (void);
+
+/* Copy SEQ to BUF of SIZE bytes, replacing every address register aN of
+   the string with aREGS[N].  REGS has XTENSA_REGSEQ_NUM_AREGS entries
+   and may be null to keep the registers.  Returns the sequence length,
+   or 0 if SEQ is empty, BUF is too small or a register SEQ uses is
+   mapped outside a0 to a15.  */
+extern size_t xtensa_regseq_emit (const struct xtensa_regseq *seq,
+				  const int *regs, unsigned char *buf,
+				  size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_REGSEQ_H */
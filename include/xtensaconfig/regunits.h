@@ -0,0 +1,80 @@
+/* Xtensa register fetch units.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_REGUNITS_H
+#define XTENSA_CONFIG_REGUNITS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* xtensa_register_t of xtensa-tdep.h.  */
+struct xtensa_register;
+
+/* The xtensa_rmap registers partitioned into units a debugger fetches
+   as a whole: one unit per coprocessor, and one per register group for
+   the others.  Only the eager units (the general registers, the address
+   register file and PC) are needed at every stop; the others can be
+   fetched on the first access to one of their registers.  A unit
+   depends on the units that must be fetched before it: the parts of its
+   composite registers, CPENABLE for coprocessors, and the address
+   register file for units with fetch sequences, which clobber address
+   registers.  */
+
+struct xtensa_reg_unit
+{
+  unsigned int group;		/* Union of the registers' groups.  */
+  int coprocessor;		/* As in xtensa_register_t.  */
+  int eager;
+  /* Registers of the unit (rmap indices) and their total size,
+     composite registers taking no space.  */
+  int num_regs;
+  const int *regs;
+  unsigned long bytes;
+  int num_deps;
+  const int *deps;		/* Unit indices.  */
+};
+
+struct xtensa_reg_units
+{
+  int num_units;
+  const struct xtensa_reg_unit *units;
+  int num_regs;
+  const int *unit_of;		/* Unit of each register.  */
+};
+
+/* Partition RMAP, which ends with XTREG_END.  Returns null if out of
+   memory.  */
+extern struct xtensa_reg_units *
+xtensa_reg_units_build (const struct xtensa_register *rmap);
+extern void xtensa_reg_units_free (struct xtensa_reg_units *units);
+
+/* The units to fetch, dependencies first, so that register REG (or all
+   eager units if REG is -1) is available, given LOADED, one flag per
+   unit, which the debugger clears at every stop.  Stores them in ORDER,
+   which has room for every unit, marks them in LOADED and returns their
+   number.  */
+extern int xtensa_reg_units_fault (const struct xtensa_reg_units *units,
+				   int reg, unsigned char *loaded,
+				   int *order);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_REGUNITS_H */
@@ -0,0 +1,77 @@
+/* Xtensa functional-unit resources and slot index.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_RESOURCES_H
+#define XTENSA_CONFIG_RESOURCES_H
+
+#include <stdint.h>
+#include "xtensa-isa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Tables derived once from the ISA: for every opcode, a reservation
+   bitmap with one bit per <functional unit, pipeline stage> pair, and
+   the list of <format, slot> pairs that can encode it.  A bundler uses
+   them to reject impossible bundles and to find candidate slots without
+   walking every format.  The handle is not thread-safe: the conflict
+   check uses scratch space stored in it.  */
+
+struct xtensa_resources;
+
+struct xtensa_slot_ref
+{
+  xtensa_format format;
+  int slot;				/* Slot index within the format.  */
+};
+
+/* Build the tables for ISA.  Returns null if out of memory.  */
+extern struct xtensa_resources *xtensa_resources_init (xtensa_isa isa);
+extern void xtensa_resources_free (struct xtensa_resources *res);
+
+/* Number of pipeline stages covered by the reservation bitmaps and the
+   number of uint64_t words in each bitmap.  Bit (UNIT * STAGES + STAGE)
+   is set when the opcode uses UNIT in STAGE.  */
+extern int xtensa_resources_num_stages (const struct xtensa_resources *res);
+extern int xtensa_resources_num_words (const struct xtensa_resources *res);
+
+/* Reservation bitmap of OPC, or null if OPC is out of range.  */
+extern const uint64_t *
+xtensa_resources_reservation (const struct xtensa_resources *res,
+			      xtensa_opcode opc);
+
+/* Return non-zero if the N opcodes in OPCS cannot issue in the same
+   cycle because together they need more copies of some functional unit
+   in some stage than the processor has.  */
+extern int
+xtensa_resources_conflict (struct xtensa_resources *res,
+			   const xtensa_opcode *opcs, int n);
+
+/* Reverse slot index: the <format, slot> pairs where OPC is encodable,
+   ordered by format and slot.  Returns the number of pairs and stores
+   a pointer to them in *REFS, or XTENSA_UNDEFINED if OPC is out of
+   range.  */
+extern int
+xtensa_resources_slot_refs (const struct xtensa_resources *res,
+			    xtensa_opcode opc,
+			    const struct xtensa_slot_ref **refs);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_RESOURCES_H */
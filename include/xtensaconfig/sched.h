@@ -0,0 +1,126 @@
+/* Xtensa pipeline scheduling model.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_SCHED_H
+#define XTENSA_CONFIG_SCHED_H
+
+#include "xtensa-isa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Per-opcode latency and reservation tables derived from the
+   functional-unit uses of the ISA, plus a small pipeline state that
+   answers "can this opcode issue in the current cycle" the way a DFA
+   does.  They are meant to back the compiler's TARGET_SCHED_* hooks
+   (issue rate, adjust cost, dfa_new_cycle) for the loaded chip.
+
+   An opcode issues in the first stage where it uses a functional unit
+   and its result is available after the last such stage; opcodes that
+   use no unit take one cycle.  Reservations are relative to issue.  */
+
+struct xtensa_sched_model;
+struct xtensa_sched_state;
+
+/* What the model is built from: the issue width and the functional-unit
+   uses of every opcode, numbered as in the ISA.  The generator writes
+   them into the chip library as xtensa_sched_tables_data, so that the
+   compiler gets a model without loading the ISA tables.  */
+struct xtensa_sched_use
+{
+  int unit;
+  int stage;
+};
+
+struct xtensa_sched_opcode
+{
+  const char *name;
+  int num_uses;
+  const struct xtensa_sched_use *uses;
+};
+
+struct xtensa_sched_tables
+{
+  int issue_rate;			/* Largest slot count of a format.  */
+  int num_units;
+  const int *unit_copies;		/* Copies of every functional unit.  */
+  int num_opcodes;
+  const struct xtensa_sched_opcode *opcodes;
+};
+
+struct xtensa_sched_reservation
+{
+  xtensa_funcUnit unit;
+  int cycle;				/* Cycle after issue.  */
+};
+
+/* Build the model of TABLES, which must outlive it.  Returns null if out
+   of memory.  */
+extern struct xtensa_sched_model *
+xtensa_sched_model_init (const struct xtensa_sched_tables *tables);
+extern void xtensa_sched_model_free (struct xtensa_sched_model *model);
+
+/* Maximum number of operations issued per cycle, i.e. the largest slot
+   count of any format.  */
+extern int xtensa_sched_issue_rate (const struct xtensa_sched_model *model);
+
+/* Opcode for the mnemonic NAME, or XTENSA_UNDEFINED.  */
+extern xtensa_opcode
+xtensa_sched_lookup (const struct xtensa_sched_model *model, const char *name);
+
+/* Cycles from issue of OPC until its result can be used, or
+   XTENSA_UNDEFINED if OPC is out of range.  */
+extern int
+xtensa_sched_latency (const struct xtensa_sched_model *model,
+		      xtensa_opcode opc);
+
+/* Reservation table of OPC.  Returns the number of entries and stores
+   a pointer to them in *RES, or XTENSA_UNDEFINED.  */
+extern int
+xtensa_sched_reservations (const struct xtensa_sched_model *model,
+			   xtensa_opcode opc,
+			   const struct xtensa_sched_reservation **res);
+
+/* Pipeline state.  */
+extern struct xtensa_sched_state *
+xtensa_sched_state_alloc (const struct xtensa_sched_model *model);
+extern void xtensa_sched_state_free (struct xtensa_sched_state *state);
+extern void xtensa_sched_state_reset (struct xtensa_sched_state *state);
+
+/* Return non-zero if OPC can issue in the current cycle.  */
+extern int
+xtensa_sched_state_can_issue (const struct xtensa_sched_state *state,
+			      xtensa_opcode opc);
+
+/* Reserve the resources of OPC; it must be able to issue.  */
+extern void
+xtensa_sched_state_issue (struct xtensa_sched_state *state,
+			  xtensa_opcode opc);
+
+extern void xtensa_sched_state_advance (struct xtensa_sched_state *state);
+
+/* Estimate the cycles needed to issue the N opcodes in OPCS in order,
+   counting only issue width and functional-unit hazards.  */
+extern int
+xtensa_sched_estimate_cycles (const struct xtensa_sched_model *model,
+			      const xtensa_opcode *opcs, int n);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_SCHED_H */
@@ -0,0 +1,77 @@
+/* Xtensa configuration load statistics.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_STATS_H
+#define XTENSA_CONFIG_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Phases of loading a chip library, timed with a monotonic clock.
+
+   If XTENSA_CONFIG_TRACE names a file when the first phase ends, every
+   phase is also appended to it as a Chrome trace event, one JSON object
+   per line; several processes may share one file.  "jq -s . FILE" makes
+   it a JSON array that about:tracing and Perfetto load.  Where <sys/sdt.h>
+   is available, each phase boundary is a USDT probe
+   xtensaconfig:phase_begin(phase) / xtensaconfig:phase_end(phase, ns),
+   a no-op unless a tracer such as perf or bpftrace is attached.  */
+
+enum xtensa_config_phase
+{
+  XTENSA_CONFIG_PHASE_PATH,	/* Locating the library directory.  */
+  XTENSA_CONFIG_PHASE_DLOPEN,	/* Loading and relocating the library.  */
+  XTENSA_CONFIG_PHASE_DLSYM,	/* Symbol lookups.  */
+  XTENSA_CONFIG_PHASE_CHECK,	/* Validating xtensa_config.  */
+  XTENSA_CONFIG_NUM_PHASES
+};
+
+struct xtensa_config_stats
+{
+  /* Total time in nanoseconds and number of runs of each phase.  */
+  unsigned long long ns[XTENSA_CONFIG_NUM_PHASES];
+  unsigned int count[XTENSA_CONFIG_NUM_PHASES];
+};
+
+/* Copy the statistics of this process so far, from all threads, to
+   *STATS.  */
+extern void xtensa_config_stats (struct xtensa_config_stats *stats);
+
+/* Name of PHASE, e.g. "dlopen".  */
+extern const char *xtensa_config_phase_name (enum xtensa_config_phase phase);
+
+/* Bracket one run of PHASE; used by the loader.  The value returned by
+   the first is passed to the second.  */
+extern unsigned long long xtensa_config_phase_begin (enum xtensa_config_phase phase);
+extern void xtensa_config_phase_end (enum xtensa_config_phase phase,
+				     unsigned long long start);
+
+/* xtensa_config_phase_end in two steps, for a thread that must leave
+   the statistics and the trace alone: the first returns the length of
+   the run, the second accounts it later.  */
+extern unsigned long long
+xtensa_config_phase_stop (enum xtensa_config_phase phase,
+			  unsigned long long start);
+extern void
+xtensa_config_phase_account (enum xtensa_config_phase phase,
+			     unsigned long long start, unsigned long long ns);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_STATS_H */
@@ -0,0 +1,56 @@
+/* Xtensa GDB target description.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_TDESC_H
+#define XTENSA_CONFIG_TDESC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The GDB target-description XML of the chip, rendered from xtensa_rmap
+   at build time.  Only the raw registers, the ones of the 'g' packet,
+   are listed, numbered in the order of their packet offsets, with their
+   bit size, a type and the GDB register group of their
+   xtensa_register_group_t.  Composite registers and the a0..a15 window
+   are pseudo registers left to the debugger.  Registers are split in
+   features by coprocessor:
+   org.gnu.gdb.xtensa.core for the base registers,
+   org.gnu.gdb.xtensa.ncp for the other non-coprocessor options and
+   org.gnu.gdb.xtensa.cpN for coprocessor N.  */
+
+struct xtensa_tdesc
+{
+  const char *xml;		/* Nul-terminated.  */
+  size_t length;		/* Of XML, without the nul.  */
+  /* CRC-32 of XML as GDB computes it for qCRC (polynomial 0x04c11db7,
+     most significant bit first, initial value 0xffffffff), to key
+     cached copies.  */
+  uint32_t checksum;
+};
+
+/* Target description of the selected configuration, or null if its
+   library has none.  */
+extern const struct xtensa_tdesc *xtensa_config_tdesc (void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_TDESC_H */
@@ -0,0 +1,74 @@
+/* Xtensa configuration traits for C++.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_TRAITS_HPP
+#define XTENSA_CONFIG_TRAITS_HPP
+
+#include <cstring>
+#include <initializer_list>
+
+#include "xtensaconfig/dynconfig.h"
+
+/* The xtensa_config values of every chip as constexpr members, named
+   after the XCHAL_/XSHAL_/XTHAL_ macro without the prefix in lowercase:
+   xtensa::chip<xtensa::esp32s3>::have_windowed.  The specializations
+   and xtensa::all_chips come from the generated xtensaconfig/chips.hpp
+   ("make traits").  */
+
+namespace xtensa
+{
+
+template <typename Tag> struct chip;
+
+template <typename... Tags> struct chip_list {};
+
+}
+
+#include "xtensaconfig/chips.hpp"
+
+namespace xtensa
+{
+
+/* Call F (chip<Tag> ()) for the chip in LIST named NAME; returns false if
+   there is none (e.g. the default configuration), so the caller can fall
+   back to a generic implementation reading xtensa_get_config.  */
+template <typename F, typename... Tags>
+bool
+dispatch (const char *name, F &&f, chip_list<Tags...>)
+{
+  bool found = false;
+
+  if (name == nullptr)
+    return false;
+  (void) std::initializer_list<int> {
+    (!found && std::strcmp (name, chip<Tags>::name) == 0
+     ? (f (chip<Tags> ()), found = true, 0) : 0)...
+  };
+  return found;
+}
+
+/* Call F (chip<Tag> ()) for the chip selected at runtime.  */
+template <typename F>
+bool
+dispatch (F &&f)
+{
+  return dispatch (xtensaconfig_get_option (), f, all_chips ());
+}
+
+}
+
+#endif /* !XTENSA_CONFIG_TRAITS_HPP */
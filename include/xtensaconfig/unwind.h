@@ -0,0 +1,136 @@
+/* Xtensa frame unwinding.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_UNWIND_H
+#define XTENSA_CONFIG_UNWIND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arch/xtensa.h"
+#include "xtensa-isa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Backtrace of windowed ABI code (xthal_abi_windowed) from the registers
+   of a gregset, without scanning code.  The return address of every
+   frame is in its a0, with the caller's window increment in the top two
+   bits.  The caller's a0..a3 are still in the physical ar registers
+   while windowstart has the bit of its window.  Once a window overflow
+   has spilled the frame, they are in the base save area, the 16 bytes
+   below the callee's stack pointer, read with one memory access per
+   frame.  The walk stops at a frame entered other than by a windowed
+   call, such as the first frame of a task, or at a stack pointer that
+   does not grow.  */
+
+struct xtensa_unwind_target
+{
+  int big_endian;		/* Byte order of target memory.  */
+  /* Read LEN bytes of target memory at ADDR into BUF; 0 on success.  */
+  int (*read_memory) (void *ctx, uint32_t addr, void *buf, size_t len);
+  void *ctx;
+};
+
+struct xtensa_unwind_frame
+{
+  uint32_t pc;
+  uint32_t sp;			/* a1.  */
+  uint32_t a[4];		/* a0..a3.  */
+  int window;			/* Window base, in units of 4 registers.  */
+  int spilled;			/* Registers taken from the stack.  */
+};
+
+/* Walk up to MAX_FRAMES frames, frame 0 the one of GREGS, into FRAMES.
+   NUM_AREGS is xchal_num_aregs; gregs->ar holds that many physical
+   registers in host byte order.  Returns the number of frames, or -1 if
+   NUM_AREGS is not 16, 32 or 64.  */
+extern int xtensa_unwind_windowed (const xtensa_elf_gregset_t *gregs,
+				   int num_aregs,
+				   const struct xtensa_unwind_target *target,
+				   struct xtensa_unwind_frame *frames,
+				   int max_frames);
+
+/* Prologue analysis of call0 ABI code (xthal_abi_call0), as debuggers
+   do it: the C0_NREGS address registers are tracked through the
+   instructions from the function entry as the entry value of a register
+   plus a constant, until the first control transfer.  Instructions are
+   read with the ISA decoder of xtensaconfig/decoder.h.  The result is
+   kept per function in a bounded cache, so every backtrace does not
+   decode every prologue again.  Frames of large functions that load
+   their size with l32r are not followed; their CFA is unknown.  */
+
+#define XTENSA_CALL0_MAX_PROLOGUE 128	/* Bytes analyzed at most.  */
+#define XTENSA_CALL0_NOT_SAVED INT32_MAX
+
+struct xtensa_call0_frame
+{
+  uint32_t entry;
+  /* First address past the analyzed instructions; a frame whose pc is
+     below it is still in its prologue and needs xtensa_call0_analyze up
+     to that pc.  */
+  uint32_t prologue_end;
+  /* The CFA, the stack pointer at entry, is CFA_REG plus CFA_OFFSET:
+     a1, or a15 when it is the frame pointer; -1 if not known.  */
+  int cfa_reg;
+  int32_t cfa_offset;
+  int32_t frame_size;		/* Stack the prologue allocates.  */
+  /* Where the prologue saves the entry value of every register, as an
+     offset from the CFA, or XTENSA_CALL0_NOT_SAVED.  */
+  int32_t saved[C0_NREGS];
+};
+
+/* Analyze the LEN bytes of CODE, the function at ENTRY, up to STOP_PC
+   (excluded) or its first control transfer.  Returns 0, or -1 if the
+   first instruction cannot be decoded.  */
+extern int xtensa_call0_analyze (xtensa_isa isa, const unsigned char *code,
+				 size_t len, uint32_t entry, uint32_t stop_pc,
+				 struct xtensa_call0_frame *frame);
+
+/* Cache of analyses by build id and entry address, CAPACITY entries at
+   the most; code is read through TARGET.  Entries keep a copy of the
+   build id; the analyses of images with a longer one are made on every
+   lookup.  Not thread-safe.  */
+
+#define XTENSA_CALL0_MAX_BUILD_ID 64	/* Bytes, a SHA-512 build id.  */
+
+struct xtensa_call0_cache;
+
+extern struct xtensa_call0_cache *
+xtensa_call0_cache_new (xtensa_isa isa,
+			const struct xtensa_unwind_target *target,
+			int capacity);
+extern void xtensa_call0_cache_free (struct xtensa_call0_cache *cache);
+
+/* The analysis of the whole prologue of the function at ENTRY of the
+   image with build id BUILD_ID (LEN bytes, none if 0), from the cache
+   or made now.  Returns 0, or -1 if its code cannot be read or decoded.  */
+extern int xtensa_call0_cache_lookup (struct xtensa_call0_cache *cache,
+				      const void *build_id, size_t len,
+				      uint32_t entry,
+				      struct xtensa_call0_frame *frame);
+
+/* Drop the analyses that read any of the LEN bytes at ADDR, whatever
+   their build id; to be called when the debugger writes code,
+   breakpoints included.  */
+extern void xtensa_call0_cache_invalidate (struct xtensa_call0_cache *cache,
+					   uint32_t addr, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !XTENSA_CONFIG_UNWIND_H */
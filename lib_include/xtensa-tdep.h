@@ -103,7 +103,7 @@ typedef struct
 
 /*  Xtensa register representation.  */
 
-typedef struct 
+typedef struct xtensa_register
 {
   const char *name;            	/* Register name.  */
   int offset;             	/* Offset.  */
@@ -0,0 +1,183 @@
+/* Instruction decoder specialized for one chip.
+
+   Compiled per chip with its xtensa-modules.c on the include path and the
+   generated <chip>-decoder.h force-included.  The chip tables are
+   included here as a private copy: the xtensa_modules definition becomes
+   a static const object nothing else can see or change, so the compiler
+   folds loads through it with constant indices into direct calls of the
+   format, slot and length functions, and drops the parts of the copy it
+   does not use.  The exported xtensa_modules still comes from
+   xtensa-modules.o and is untouched.  */
+
+#include <string.h>
+
+#include "ansidecl.h"
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/decoder.h"
+
+#if XTENSA_DECODER_SUPPORTED
+
+/* xtensa-modules.c only names the type in its final definition.  */
+#define xtensa_modules xtensa_decoder_tables
+#define xtensa_isa_internal static const struct xtensa_isa_internal_struct
+#include "xtensa-modules.c"
+#undef xtensa_isa_internal
+#undef xtensa_modules
+
+#define TABLES (&xtensa_decoder_tables)
+
+typedef xtensa_insnbuf_word insnbuf_t[XTENSA_DECODER_INSNBUF_SIZE];
+
+/* Little-endian byte order of xtensa_insnbuf_from_chars.  */
+static inline void
+insnbuf_from_chars (insnbuf_t insn, const unsigned char *buf, int length)
+{
+  int i;
+
+  memset (insn, 0, sizeof (insnbuf_t));
+  for (i = 0; i < length; i++)
+    insn[i / 4] |= (xtensa_insnbuf_word) buf[i] << ((i & 3) * 8);
+}
+
+static inline void
+insnbuf_to_chars (const insnbuf_t insn, unsigned char *buf, int length)
+{
+  int i;
+
+  for (i = 0; i < length; i++)
+    buf[i] = (insn[i / 4] >> ((i & 3) * 8)) & 0xff;
+}
+
+static inline __attribute__ ((always_inline)) void
+decode_slot (int slot_id, insnbuf_t insn, struct xtensa_decoded_slot *out)
+{
+  xtensa_slot_internal *slot = &TABLES->slots[slot_id];
+  xtensa_iclass_internal *iclass;
+  insnbuf_t slotbuf;
+  int i;
+
+  memset (slotbuf, 0, sizeof (slotbuf));
+  slot->get_fn (insn, slotbuf);
+  out->opcode = slot->opcode_decode_fn (slotbuf);
+  if (out->opcode == XTENSA_UNDEFINED)
+    return;
+
+  iclass = &TABLES->iclasses[TABLES->opcodes[out->opcode].iclass_id];
+  for (i = 0; i < iclass->num_operands; i++)
+    {
+      int field_id = TABLES->operands[iclass->operands[i].u.operand_id].field_id;
+      xtensa_get_field_fn get_fn
+	= field_id == XTENSA_UNDEFINED ? NULL : slot->get_field_fns[field_id];
+
+      out->fields[i] = get_fn ? get_fn (slotbuf) : 0;
+    }
+}
+
+static inline __attribute__ ((always_inline)) int
+encode_slot (int slot_id, insnbuf_t insn, const struct xtensa_decoded_slot *in)
+{
+  xtensa_slot_internal *slot = &TABLES->slots[slot_id];
+  xtensa_iclass_internal *iclass;
+  xtensa_opcode_encode_fn encode_fn;
+  insnbuf_t slotbuf;
+  int i;
+
+  if (in->opcode < 0 || in->opcode >= TABLES->num_opcodes)
+    return 0;
+  encode_fn = TABLES->opcodes[in->opcode].encode_fns[slot_id];
+  if (!encode_fn)
+    return 0;
+
+  memset (slotbuf, 0, sizeof (slotbuf));
+  encode_fn (slotbuf);
+  iclass = &TABLES->iclasses[TABLES->opcodes[in->opcode].iclass_id];
+  for (i = 0; i < iclass->num_operands; i++)
+    {
+      int field_id = TABLES->operands[iclass->operands[i].u.operand_id].field_id;
+      xtensa_set_field_fn set_fn
+	= field_id == XTENSA_UNDEFINED ? NULL : slot->set_field_fns[field_id];
+
+      if (set_fn)
+	set_fn (slotbuf, in->fields[i]);
+    }
+  slot->set_fn (insn, slotbuf);
+  return 1;
+}
+
+static int
+decoder_decode (xtensa_isa isa ATTRIBUTE_UNUSED, const unsigned char *buf,
+		int len, struct xtensa_decoded_insn *insn)
+{
+  insnbuf_t insnbuf;
+  int length;
+
+  if (len < 1)
+    return XTENSA_UNDEFINED;
+  length = TABLES->length_decode_fn (buf);
+  if (length == XTENSA_UNDEFINED || length > len)
+    return XTENSA_UNDEFINED;
+
+  insnbuf_from_chars (insnbuf, buf, length);
+  insn->format = TABLES->format_decode_fn (insnbuf);
+  insn->length = length;
+
+#define DECODE_SLOT(slot, slot_id) \
+  decode_slot (slot_id, insnbuf, &insn->slots[slot]);
+#define DECODE_FORMAT(fmt, fmt_length, fmt_num_slots) \
+    case fmt: \
+      insn->num_slots = fmt_num_slots; \
+      XTENSA_DECODER_FORMAT_SLOTS_##fmt (DECODE_SLOT) \
+      return length;
+
+  switch (insn->format)
+    {
+      XTENSA_DECODER_FORMATS (DECODE_FORMAT)
+    default:
+      return XTENSA_UNDEFINED;
+    }
+
+#undef DECODE_FORMAT
+#undef DECODE_SLOT
+}
+
+static int
+decoder_encode (xtensa_isa isa ATTRIBUTE_UNUSED,
+		const struct xtensa_decoded_insn *insn, unsigned char *buf)
+{
+  insnbuf_t insnbuf;
+
+#define ENCODE_SLOT(slot, slot_id) \
+  if (!encode_slot (slot_id, insnbuf, &insn->slots[slot])) \
+    return XTENSA_UNDEFINED;
+#define ENCODE_FORMAT(fmt, fmt_length, fmt_num_slots) \
+    case fmt: \
+      memset (insnbuf, 0, sizeof (insnbuf)); \
+      TABLES->formats[fmt].encode_fn (insnbuf); \
+      XTENSA_DECODER_FORMAT_SLOTS_##fmt (ENCODE_SLOT) \
+      insnbuf_to_chars (insnbuf, buf, fmt_length); \
+      return fmt_length;
+
+  switch (insn->format)
+    {
+      XTENSA_DECODER_FORMATS (ENCODE_FORMAT)
+    default:
+      return XTENSA_UNDEFINED;
+    }
+
+#undef ENCODE_FORMAT
+#undef ENCODE_SLOT
+}
+
+const struct xtensa_decoder_ops xtensa_decoder_ops =
+{
+  decoder_decode,
+  decoder_encode,
+};
+
+#else /* !XTENSA_DECODER_SUPPORTED */
+
+/* The generic decoder is used for this chip.  */
+typedef int xtensa_decoder_unsupported;
+
+#endif /* !XTENSA_DECODER_SUPPORTED */
@@ -0,0 +1,256 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/bundle.h"
+
+struct xtensa_bundler
+{
+  xtensa_isa_internal *intisa;
+  struct xtensa_resources *res;
+  int fmt_words;
+  // Formats sorted by length, then by number of slots
+  xtensa_format *fmt_order;
+  // num_opcodes masks of fmt_words each: formats that can hold the opcode
+  uint64_t *fmt_masks;
+  // num_opcodes * num_formats slot masks
+  uint32_t *slot_masks;
+  // num_formats * XTENSA_BUNDLE_MAX_SLOTS NOP opcodes
+  xtensa_opcode *nops;
+  uint64_t *cand;
+};
+
+static int format_before(const xtensa_isa_internal *intisa, xtensa_format a, xtensa_format b)
+{
+  const xtensa_format_internal *fa = &intisa->formats[a];
+  const xtensa_format_internal *fb = &intisa->formats[b];
+
+  if (fa->length != fb->length)
+  {
+    return fa->length < fb->length;
+  }
+  return fa->num_slots < fb->num_slots;
+}
+
+// Stable insertion sort of the formats, which are few; equal ones keep
+// their number order
+static void sort_formats(const xtensa_isa_internal *intisa, xtensa_format *order)
+{
+  int i = 0, j = 0;
+
+  for (i = 0; i < intisa->num_formats; i++)
+  {
+    xtensa_format fmt = i;
+
+    for (j = i; j > 0 && format_before(intisa, fmt, order[j - 1]); j--)
+    {
+      order[j] = order[j - 1];
+    }
+    order[j] = fmt;
+  }
+}
+
+static xtensa_opcode lookup_opcode(xtensa_isa_internal *intisa, const char *name)
+{
+  int opc = 0;
+
+  if (!name)
+  {
+    return XTENSA_UNDEFINED;
+  }
+  for (opc = 0; opc < intisa->num_opcodes; opc++)
+  {
+    if (strcasecmp(intisa->opcodes[opc].name, name) == 0)
+    {
+      return opc;
+    }
+  }
+  return XTENSA_UNDEFINED;
+}
+
+struct xtensa_bundler *xtensa_bundler_init(xtensa_isa isa, struct xtensa_resources *res)
+{
+  xtensa_isa_internal *intisa = (xtensa_isa_internal *) isa;
+  struct xtensa_bundler *b = calloc(1, sizeof(*b));
+  int fmt = 0, slot = 0, opc = 0;
+
+  if (!b)
+  {
+    return NULL;
+  }
+  b->intisa = intisa;
+  b->res = res;
+  b->fmt_words = (intisa->num_formats + 63) / 64;
+  b->fmt_order = calloc(intisa->num_formats, sizeof(xtensa_format));
+  b->fmt_masks = calloc((size_t) intisa->num_opcodes * b->fmt_words, sizeof(uint64_t));
+  b->slot_masks = calloc((size_t) intisa->num_opcodes * intisa->num_formats, sizeof(uint32_t));
+  b->nops = calloc((size_t) intisa->num_formats * XTENSA_BUNDLE_MAX_SLOTS, sizeof(xtensa_opcode));
+  b->cand = calloc(b->fmt_words, sizeof(uint64_t));
+  if (!b->fmt_order || !b->fmt_masks || !b->slot_masks || !b->nops || !b->cand)
+  {
+    xtensa_bundler_free(b);
+    return NULL;
+  }
+
+  for (fmt = 0; fmt < intisa->num_formats; fmt++)
+  {
+    for (slot = 0; slot < intisa->formats[fmt].num_slots && slot < XTENSA_BUNDLE_MAX_SLOTS; slot++)
+    {
+      int slot_id = intisa->formats[fmt].slot_id[slot];
+      b->nops[fmt * XTENSA_BUNDLE_MAX_SLOTS + slot] = lookup_opcode(intisa, intisa->slots[slot_id].nop_name);
+    }
+  }
+  sort_formats(intisa, b->fmt_order);
+
+  for (opc = 0; opc < intisa->num_opcodes; opc++)
+  {
+    const struct xtensa_slot_ref *refs = NULL;
+    int i = 0, n = xtensa_resources_slot_refs(res, opc, &refs);
+
+    for (i = 0; i < n; i++)
+    {
+      if (intisa->formats[refs[i].format].num_slots > XTENSA_BUNDLE_MAX_SLOTS)
+      {
+        continue;
+      }
+      b->fmt_masks[(size_t) opc * b->fmt_words + refs[i].format / 64] |= (uint64_t) 1 << (refs[i].format % 64);
+      b->slot_masks[(size_t) opc * intisa->num_formats + refs[i].format] |= (uint32_t) 1 << refs[i].slot;
+    }
+  }
+  return b;
+}
+
+void xtensa_bundler_free(struct xtensa_bundler *b)
+{
+  if (!b)
+  {
+    return;
+  }
+  free(b->fmt_order);
+  free(b->fmt_masks);
+  free(b->slot_masks);
+  free(b->nops);
+  free(b->cand);
+  free(b);
+}
+
+uint32_t xtensa_bundler_slot_mask(const struct xtensa_bundler *b, xtensa_opcode opc, xtensa_format fmt)
+{
+  if (opc < 0 || opc >= b->intisa->num_opcodes || fmt < 0 || fmt >= b->intisa->num_formats)
+  {
+    return 0;
+  }
+  return b->slot_masks[(size_t) opc * b->intisa->num_formats + fmt];
+}
+
+// Kuhn's augmenting path over the slot masks
+static int match_slot(const uint32_t *masks, int op, uint32_t *visited, int *slot_owner)
+{
+  uint32_t free_slots = masks[op] & ~*visited;
+
+  while (free_slots)
+  {
+    int slot = __builtin_ctz(free_slots);
+
+    free_slots &= free_slots - 1;
+    *visited |= (uint32_t) 1 << slot;
+    if (slot_owner[slot] < 0 || match_slot(masks, slot_owner[slot], visited, slot_owner))
+    {
+      slot_owner[slot] = op;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int assign_slots(struct xtensa_bundler *b, xtensa_format fmt, const xtensa_opcode *opcs, int n,
+                        struct xtensa_bundle *bundle)
+{
+  uint32_t masks[XTENSA_BUNDLE_MAX_SLOTS];
+  int slot_owner[XTENSA_BUNDLE_MAX_SLOTS];
+  int num_slots = b->intisa->formats[fmt].num_slots;
+  int i = 0, slot = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    masks[i] = b->slot_masks[(size_t) opcs[i] * b->intisa->num_formats + fmt];
+  }
+  for (slot = 0; slot < num_slots; slot++)
+  {
+    slot_owner[slot] = -1;
+  }
+  for (i = 0; i < n; i++)
+  {
+    uint32_t visited = 0;
+
+    if (!match_slot(masks, i, &visited, slot_owner))
+    {
+      return XTENSA_UNDEFINED;
+    }
+  }
+
+  for (slot = 0; slot < num_slots; slot++)
+  {
+    if (slot_owner[slot] >= 0)
+    {
+      bundle->opcodes[slot] = opcs[slot_owner[slot]];
+    }
+    else if ((bundle->opcodes[slot] = b->nops[fmt * XTENSA_BUNDLE_MAX_SLOTS + slot]) == XTENSA_UNDEFINED)
+    {
+      return XTENSA_UNDEFINED;
+    }
+    bundle->op_index[slot] = slot_owner[slot];
+  }
+  bundle->format = fmt;
+  bundle->num_slots = num_slots;
+  return 0;
+}
+
+int xtensa_bundler_pack(struct xtensa_bundler *b, const xtensa_opcode *opcs, int n, struct xtensa_bundle *bundle)
+{
+  int i = 0, w = 0, k = 0;
+
+  if (n <= 0 || n > XTENSA_BUNDLE_MAX_SLOTS)
+  {
+    return XTENSA_UNDEFINED;
+  }
+
+  for (w = 0; w < b->fmt_words; w++)
+  {
+    b->cand[w] = ~(uint64_t) 0;
+  }
+  for (i = 0; i < n; i++)
+  {
+    if (opcs[i] < 0 || opcs[i] >= b->intisa->num_opcodes)
+    {
+      return XTENSA_UNDEFINED;
+    }
+    for (w = 0; w < b->fmt_words; w++)
+    {
+      b->cand[w] &= b->fmt_masks[(size_t) opcs[i] * b->fmt_words + w];
+    }
+  }
+
+  if (n > 1 && xtensa_resources_conflict(b->res, opcs, n))
+  {
+    return XTENSA_UNDEFINED;
+  }
+
+  for (k = 0; k < b->intisa->num_formats; k++)
+  {
+    xtensa_format fmt = b->fmt_order[k];
+
+    if (!(b->cand[fmt / 64] & ((uint64_t) 1 << (fmt % 64))) || b->intisa->formats[fmt].num_slots < n)
+    {
+      continue;
+    }
+    if (assign_slots(b, fmt, opcs, n, bundle) == 0)
+    {
+      return 0;
+    }
+  }
+  return XTENSA_UNDEFINED;
+}
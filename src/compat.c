@@ -0,0 +1,175 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/compat.h"
+#include "xtensaconfig/sched.h"
+
+enum field_kind
+{
+  FIELD_ABI,     // must be equal for the code to be valid
+  FIELD_OPTION,  // code may use it only if present: valid when from <= to
+  FIELD_TUNING,  // changes the generated code, not its validity
+};
+
+#define FIELD(name, kind) { #name, offsetof(struct xtensa_config, name), kind }
+
+static const struct
+{
+  const char *name;
+  size_t offset;
+  enum field_kind kind;
+} s_fields[] =
+{
+  FIELD(xchal_have_be, FIELD_ABI),
+  FIELD(xshal_abi, FIELD_ABI),
+  FIELD(xthal_abi_windowed, FIELD_ABI),
+  FIELD(xthal_abi_call0, FIELD_ABI),
+  FIELD(xshal_use_absolute_literals, FIELD_ABI),
+  FIELD(xchal_have_density, FIELD_OPTION),
+  FIELD(xchal_have_const16, FIELD_OPTION),
+  FIELD(xchal_have_abs, FIELD_OPTION),
+  FIELD(xchal_have_addx, FIELD_OPTION),
+  FIELD(xchal_have_l32r, FIELD_OPTION),
+  FIELD(xshal_have_text_section_literals, FIELD_OPTION),
+  FIELD(xchal_have_mac16, FIELD_OPTION),
+  FIELD(xchal_have_mul16, FIELD_OPTION),
+  FIELD(xchal_have_mul32, FIELD_OPTION),
+  FIELD(xchal_have_mul32_high, FIELD_OPTION),
+  FIELD(xchal_have_div32, FIELD_OPTION),
+  FIELD(xchal_have_nsa, FIELD_OPTION),
+  FIELD(xchal_have_minmax, FIELD_OPTION),
+  FIELD(xchal_have_sext, FIELD_OPTION),
+  FIELD(xchal_have_loops, FIELD_OPTION),
+  FIELD(xchal_have_threadptr, FIELD_OPTION),
+  FIELD(xchal_have_release_sync, FIELD_OPTION),
+  FIELD(xchal_have_s32c1i, FIELD_OPTION),
+  FIELD(xchal_have_booleans, FIELD_OPTION),
+  FIELD(xchal_have_fp, FIELD_OPTION),
+  FIELD(xchal_have_fp_div, FIELD_OPTION),
+  FIELD(xchal_have_fp_recip, FIELD_OPTION),
+  FIELD(xchal_have_fp_sqrt, FIELD_OPTION),
+  FIELD(xchal_have_fp_rsqrt, FIELD_OPTION),
+  FIELD(xchal_have_fp_postinc, FIELD_OPTION),
+  FIELD(xchal_have_dfp, FIELD_OPTION),
+  FIELD(xchal_have_dfp_div, FIELD_OPTION),
+  FIELD(xchal_have_dfp_recip, FIELD_OPTION),
+  FIELD(xchal_have_dfp_sqrt, FIELD_OPTION),
+  FIELD(xchal_have_dfp_rsqrt, FIELD_OPTION),
+  FIELD(xchal_have_windowed, FIELD_OPTION),
+  FIELD(xchal_have_wide_branches, FIELD_OPTION),
+  FIELD(xchal_have_predicted_branches, FIELD_OPTION),
+  FIELD(xchal_max_instruction_size, FIELD_OPTION),
+  FIELD(xchal_inst_fetch_width, FIELD_TUNING),
+  FIELD(xchal_num_aregs, FIELD_TUNING),
+  FIELD(xchal_icache_size, FIELD_TUNING),
+  FIELD(xchal_icache_linesize, FIELD_TUNING),
+  FIELD(xchal_dcache_size, FIELD_TUNING),
+  FIELD(xchal_dcache_linesize, FIELD_TUNING),
+};
+
+static unsigned int field_value(const struct xtensa_config *config, size_t i)
+{
+  return *(const unsigned int *) ((const char *) config + s_fields[i].offset);
+}
+
+// Whether A and B give the same scheduling model; no tables is the
+// generic model
+static int sched_tables_equal(const struct xtensa_sched_tables *a, const struct xtensa_sched_tables *b)
+{
+  int i = 0, j = 0;
+
+  if (a == NULL || b == NULL)
+  {
+    return a == b;
+  }
+  if (a->issue_rate != b->issue_rate || a->num_units != b->num_units || a->num_opcodes != b->num_opcodes
+      || memcmp(a->unit_copies, b->unit_copies, a->num_units * sizeof(int)) != 0)
+  {
+    return 0;
+  }
+  for (i = 0; i < a->num_opcodes; i++)
+  {
+    const struct xtensa_sched_opcode *p = &a->opcodes[i], *q = &b->opcodes[i];
+
+    if (strcmp(p->name, q->name) != 0 || p->num_uses != q->num_uses)
+    {
+      return 0;
+    }
+    for (j = 0; j < p->num_uses; j++)
+    {
+      if (p->uses[j].unit != q->uses[j].unit || p->uses[j].stage != q->uses[j].stage)
+      {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+enum xtensa_config_compat xtensa_config_compare(const struct xtensa_config *from,
+                                                const struct xtensa_sched_tables *from_sched,
+                                                const struct xtensa_config *to,
+                                                const struct xtensa_sched_tables *to_sched, const char **field)
+{
+  enum xtensa_config_compat result = XTENSA_CONFIG_IDENTICAL;
+  const char *first = NULL;
+  size_t i = 0;
+
+  for (i = 0; i < sizeof(s_fields) / sizeof(s_fields[0]); i++)
+  {
+    unsigned int a = field_value(from, i), b = field_value(to, i);
+
+    if (a == b)
+    {
+      continue;
+    }
+    if (s_fields[i].kind == FIELD_ABI || (s_fields[i].kind == FIELD_OPTION && a > b))
+    {
+      result = XTENSA_CONFIG_INCOMPATIBLE;
+      first = s_fields[i].name;
+      break;
+    }
+    if (result == XTENSA_CONFIG_IDENTICAL)
+    {
+      result = XTENSA_CONFIG_COMPATIBLE;
+      first = s_fields[i].name;
+    }
+  }
+  if (result == XTENSA_CONFIG_IDENTICAL && !sched_tables_equal(from_sched, to_sched))
+  {
+    result = XTENSA_CONFIG_COMPATIBLE;
+    first = "xtensa_sched_tables_data";
+  }
+
+  if (field)
+  {
+    *field = first;
+  }
+  return result;
+}
+
+int xtensa_config_classes(const struct xtensa_config *const *configs,
+                          const struct xtensa_sched_tables *const *scheds, int n, int *class_ids)
+{
+  int num_classes = 0, i = 0, j = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    class_ids[i] = -1;
+    for (j = 0; j < i; j++)
+    {
+      if (xtensa_config_compare(configs[j], scheds ? scheds[j] : NULL, configs[i], scheds ? scheds[i] : NULL, NULL)
+          == XTENSA_CONFIG_IDENTICAL)
+      {
+        class_ids[i] = class_ids[j];
+        break;
+      }
+    }
+    if (class_ids[i] < 0)
+    {
+      class_ids[i] = num_classes++;
+    }
+  }
+  return num_classes;
+}
@@ -0,0 +1,50 @@
+#include <stdint.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/composite.h"
+
+const struct xtensa_composite_table *xtensa_config_composite(void)
+{
+  return xtensa_config_table("xtensa_composite_data");
+}
+
+static const struct xtensa_composite *composite_find(const struct xtensa_composite_table *table, int reg)
+{
+  const struct xtensa_composite *c = NULL;
+
+  if (reg < 0 || reg >= table->num_regs || table->composite_of[reg] < 0)
+  {
+    return NULL;
+  }
+  c = &table->composites[table->composite_of[reg]];
+  return c->read != NULL ? c : NULL;
+}
+
+int xtensa_composite_read(const struct xtensa_composite_table *table, int reg, const void *image, uint64_t *value)
+{
+  const struct xtensa_composite *c = composite_find(table, reg);
+
+  if (c == NULL)
+  {
+    return -1;
+  }
+  *value = c->read(image);
+  return 0;
+}
+
+int xtensa_composite_write(const struct xtensa_composite_table *table, int reg, void *image, uint64_t value)
+{
+  const struct xtensa_composite *c = composite_find(table, reg);
+
+  if (c == NULL)
+  {
+    return -1;
+  }
+  c->write(image, value);
+  return 0;
+}
+
+void xtensa_composite_read_all(const struct xtensa_composite_table *table, const void *image, uint64_t *values)
+{
+  table->read_all(image, values);
+}
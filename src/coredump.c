@@ -0,0 +1,507 @@
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "arch/xtensa.h"
+#include "xtensaconfig/coredump.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define HOST_BIG_ENDIAN 1
+#else
+#define HOST_BIG_ENDIAN 0
+#endif
+
+#define ELF_EM_XTENSA 94
+#define ELF_ET_CORE 4
+#define ELF_PT_NOTE 4
+#define ELF_NT_PRSTATUS 1
+#define ELF32_EHDR_SIZE 52
+#define ELF32_PHDR_SIZE 32
+
+// struct elf_prstatus of a 32-bit target
+#define PRSTATUS_PID 24
+#define PRSTATUS_REG 72
+
+// Words of xtensa_elf_gregset_t
+#define GREG_WORD(field) (offsetof(xtensa_elf_gregset_t, field) / sizeof(xtensa_elf_greg_t))
+
+// Threads a worker takes at the least, so that small cores stay serial
+#define CORE_MIN_THREADS_PER_WORKER 64
+
+struct core_storage
+{
+  struct xtensa_core core;
+  struct xtensa_core_thread *threads;
+  size_t mapped;
+};
+
+static uint32_t core_get(const unsigned char *p, int size, int big_endian)
+{
+  uint32_t v = 0;
+  int i = 0;
+
+  for (i = 0; i < size; i++)
+  {
+    v |= (uint32_t) p[big_endian ? i : size - 1 - i] << (8 * (size - 1 - i));
+  }
+  return v;
+}
+
+// Offset and size of the PHNUM program headers at PHOFF, or -1
+static int core_check_header(const unsigned char *data, size_t size, int *big_endian, uint32_t *phoff,
+                             uint32_t *phnum)
+{
+  if (size < ELF32_EHDR_SIZE || memcmp(data, "\177ELF", 4) != 0 || data[4] != 1 || (data[5] != 1 && data[5] != 2))
+  {
+    return -1;
+  }
+  *big_endian = data[5] == 2;
+  *phoff = core_get(data + 28, 4, *big_endian);
+  *phnum = core_get(data + 44, 2, *big_endian);
+  if (core_get(data + 16, 2, *big_endian) != ELF_ET_CORE || core_get(data + 18, 2, *big_endian) != ELF_EM_XTENSA
+      || core_get(data + 42, 2, *big_endian) != ELF32_PHDR_SIZE || *phoff > size
+      || (size - *phoff) / ELF32_PHDR_SIZE < *phnum)
+  {
+    return -1;
+  }
+  return 0;
+}
+
+// Walk the notes of segment [OFFSET, OFFSET + LENGTH), recording the
+// gregsets in THREADS if not null; returns their number
+static int core_notes(const struct xtensa_core *core, size_t offset, size_t length,
+                      struct xtensa_core_thread *threads)
+{
+  const unsigned char *p = core->data + offset, *end = p + length;
+  int n = 0;
+
+  while (end - p >= 12)
+  {
+    size_t namesz = core_get(p, 4, core->big_endian);
+    size_t descsz = core_get(p + 4, 4, core->big_endian);
+    uint32_t type = core_get(p + 8, 4, core->big_endian);
+    size_t name_space = (namesz + 3) & ~(size_t) 3;
+    size_t desc_space = (descsz + 3) & ~(size_t) 3;
+    const unsigned char *desc = p + 12 + name_space;
+
+    if (name_space > (size_t) (end - p - 12) || desc_space > (size_t) (end - desc))
+    {
+      break;
+    }
+    if (type == ELF_NT_PRSTATUS && descsz >= PRSTATUS_REG + XTENSA_ELF_NGREG * sizeof(xtensa_elf_greg_t))
+    {
+      if (threads != NULL)
+      {
+        threads[n].pid = core_get(desc + PRSTATUS_PID, 4, core->big_endian);
+        threads[n].gregs = desc + PRSTATUS_REG;
+      }
+      n++;
+    }
+    p = desc + desc_space;
+  }
+  return n;
+}
+
+// Count the gregsets of every note segment, then record them
+static int core_index(struct core_storage *storage, uint32_t phoff, uint32_t phnum)
+{
+  struct xtensa_core *core = &storage->core;
+  int pass = 0, n = 0;
+  uint32_t i = 0;
+
+  for (pass = 0; pass < 2; pass++)
+  {
+    for (n = 0, i = 0; i < phnum; i++)
+    {
+      const unsigned char *ph = core->data + phoff + i * ELF32_PHDR_SIZE;
+      uint32_t offset = core_get(ph + 4, 4, core->big_endian);
+      uint32_t filesz = core_get(ph + 16, 4, core->big_endian);
+
+      // Notes of a truncated core are read as far as they go
+      if (core_get(ph, 4, core->big_endian) == ELF_PT_NOTE && offset <= core->size)
+      {
+        filesz = filesz < core->size - offset ? filesz : core->size - offset;
+        n += core_notes(core, offset, filesz, pass ? storage->threads + n : NULL);
+      }
+    }
+    if (pass == 0)
+    {
+      storage->threads = calloc(n > 0 ? n : 1, sizeof(*storage->threads));
+      if (storage->threads == NULL)
+      {
+        return -1;
+      }
+    }
+  }
+  core->num_threads = n;
+  core->threads = storage->threads;
+  return 0;
+}
+
+#ifdef _WIN32
+// No mapping here; the file is read whole
+static int core_map(struct core_storage *storage, const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  unsigned char *data = NULL;
+  long size = 0;
+
+  if (f == NULL)
+  {
+    return -1;
+  }
+  if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0
+      && (data = malloc(size)) != NULL && fread(data, 1, size, f) != (size_t) size)
+  {
+    free(data);
+    data = NULL;
+  }
+  fclose(f);
+  if (data == NULL)
+  {
+    errno = size == 0 ? EINVAL : EIO;
+    return -1;
+  }
+  storage->core.data = data;
+  storage->core.size = size;
+  return 0;
+}
+
+static void core_unmap(struct core_storage *storage)
+{
+  free((void *) storage->core.data);
+}
+#else
+static int core_map(struct core_storage *storage, const char *path)
+{
+  struct stat st;
+  void *data = MAP_FAILED;
+  int fd = open(path, O_RDONLY);
+
+  if (fd < 0)
+  {
+    return -1;
+  }
+  if (fstat(fd, &st) == 0)
+  {
+    errno = EINVAL;
+    data = st.st_size > 0 ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  }
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    return -1;
+  }
+  storage->core.data = data;
+  storage->core.size = storage->mapped = st.st_size;
+  return 0;
+}
+
+static void core_unmap(struct core_storage *storage)
+{
+  munmap((void *) storage->core.data, storage->mapped);
+}
+#endif
+
+struct xtensa_core *xtensa_core_open(const char *path)
+{
+  struct core_storage *storage = calloc(1, sizeof(*storage));
+  uint32_t phoff = 0, phnum = 0;
+
+  if (storage == NULL)
+  {
+    return NULL;
+  }
+  if (core_map(storage, path) != 0)
+  {
+    free(storage);
+    return NULL;
+  }
+  if (core_check_header(storage->core.data, storage->core.size, &storage->core.big_endian, &phoff, &phnum) != 0)
+  {
+    xtensa_core_close(&storage->core);
+    errno = EINVAL;
+    return NULL;
+  }
+  if (core_index(storage, phoff, phnum) != 0)
+  {
+    xtensa_core_close(&storage->core);
+    errno = ENOMEM;
+    return NULL;
+  }
+  return &storage->core;
+}
+
+void xtensa_core_close(struct xtensa_core *core)
+{
+  struct core_storage *storage = (struct core_storage *) core;
+
+  if (core == NULL)
+  {
+    return;
+  }
+  if (core->data != NULL)
+  {
+    core_unmap(storage);
+  }
+  free(storage->threads);
+  free(storage);
+}
+
+// Gregset words and the image offsets they go to, resolved once per decode
+struct core_plan
+{
+  int num_words;
+  unsigned int word[XTENSA_ELF_NGREG];
+  unsigned int image[XTENSA_ELF_NGREG];
+  int num_aregs;			// Physical ar registers, for the rotation
+  int windowed;
+  unsigned int window_image[16];	// a0..a15
+};
+
+static int core_plan_reg(const struct xtensa_gpacket_layout *layout, const struct xtensa_regindex *index,
+                         const char *name, unsigned int *image)
+{
+  int reg = xtensa_regindex_find_name(index, name);
+
+  if (reg < 0 || reg >= layout->num_regs || layout->regs[reg].length != sizeof(xtensa_elf_greg_t))
+  {
+    return -1;
+  }
+  *image = layout->regs[reg].image;
+  return 0;
+}
+
+static void core_plan_word(struct core_plan *plan, const struct xtensa_gpacket_layout *layout,
+                           const struct xtensa_regindex *index, const char *name, unsigned int word)
+{
+  if (core_plan_reg(layout, index, name, &plan->image[plan->num_words]) == 0)
+  {
+    plan->word[plan->num_words++] = word;
+  }
+}
+
+static int core_plan_build(struct core_plan *plan, const struct xtensa_gpacket_layout *layout,
+                           const struct xtensa_regindex *index)
+{
+  char name[8];
+  int i = 0;
+
+  memset(plan, 0, sizeof(*plan));
+  core_plan_word(plan, layout, index, "pc", GREG_WORD(pc));
+  if (plan->num_words == 0)
+  {
+    return -1;
+  }
+  core_plan_word(plan, layout, index, "ps", GREG_WORD(ps));
+  core_plan_word(plan, layout, index, "lbeg", GREG_WORD(lbeg));
+  core_plan_word(plan, layout, index, "lend", GREG_WORD(lend));
+  core_plan_word(plan, layout, index, "lcount", GREG_WORD(lcount));
+  core_plan_word(plan, layout, index, "sar", GREG_WORD(sar));
+  core_plan_word(plan, layout, index, "windowstart", GREG_WORD(windowstart));
+  core_plan_word(plan, layout, index, "windowbase", GREG_WORD(windowbase));
+  core_plan_word(plan, layout, index, "threadptr", GREG_WORD(threadptr));
+  for (i = 0; i < 64; i++)
+  {
+    snprintf(name, sizeof(name), "ar%d", i);
+    if (xtensa_regindex_find_name(index, name) < 0)
+    {
+      break;
+    }
+    core_plan_word(plan, layout, index, name, GREG_WORD(ar) + i);
+  }
+  plan->num_aregs = i;
+
+  plan->windowed = plan->num_aregs >= 16;
+  for (i = 0; i < 16 && plan->windowed; i++)
+  {
+    snprintf(name, sizeof(name), "a%d", i);
+    plan->windowed = core_plan_reg(layout, index, name, &plan->window_image[i]) == 0;
+  }
+  return 0;
+}
+
+// The words of a core of the host's byte order are loaded as they are
+static uint32_t core_greg(const unsigned char *gregs, unsigned int word, int big_endian)
+{
+  uint32_t v = 0;
+
+  if (big_endian != HOST_BIG_ENDIAN)
+  {
+    return core_get(gregs + word * sizeof(xtensa_elf_greg_t), 4, big_endian);
+  }
+  memcpy(&v, gregs + word * sizeof(xtensa_elf_greg_t), sizeof(v));
+  return v;
+}
+
+static void core_decode_thread(const struct core_plan *plan, const unsigned char *gregs, int big_endian,
+                               unsigned char *image)
+{
+  uint32_t v = 0, windowbase = 0;
+  int i = 0;
+
+  for (i = 0; i < plan->num_words; i++)
+  {
+    v = core_greg(gregs, plan->word[i], big_endian);
+    memcpy(image + plan->image[i], &v, sizeof(v));
+  }
+  if (plan->windowed)
+  {
+    windowbase = core_greg(gregs, GREG_WORD(windowbase), big_endian);
+    for (i = 0; i < 16; i++)
+    {
+      v = core_greg(gregs, GREG_WORD(ar) + (windowbase * 4 + i) % plan->num_aregs, big_endian);
+      memcpy(image + plan->window_image[i], &v, sizeof(v));
+    }
+  }
+}
+
+struct core_job
+{
+  const struct xtensa_core *core;
+  const struct core_plan *plan;
+  unsigned char *images;
+  size_t stride;
+  int first;
+  int count;
+#ifndef _WIN32
+  pthread_t thread;
+  int started;
+#endif
+};
+
+static void *core_worker(void *arg)
+{
+  const struct core_job *job = arg;
+  int i = 0;
+
+  for (i = job->first; i < job->first + job->count; i++)
+  {
+    core_decode_thread(job->plan, job->core->threads[i].gregs, job->core->big_endian,
+                       job->images + i * job->stride);
+  }
+  return NULL;
+}
+
+#ifdef _WIN32
+// Decoded in the calling thread
+static void core_run(struct core_job *jobs, int num_jobs)
+{
+  int i = 0;
+
+  for (i = 0; i < num_jobs; i++)
+  {
+    core_worker(&jobs[i]);
+  }
+}
+
+static int core_processors(void)
+{
+  return 1;
+}
+#else
+// The first job runs in the calling thread, and so does any that cannot
+// get a thread of its own
+static void core_run(struct core_job *jobs, int num_jobs)
+{
+  int i = 0;
+
+  for (i = 1; i < num_jobs; i++)
+  {
+    jobs[i].started = pthread_create(&jobs[i].thread, NULL, core_worker, &jobs[i]) == 0;
+  }
+  core_worker(&jobs[0]);
+  for (i = 1; i < num_jobs; i++)
+  {
+    if (jobs[i].started)
+    {
+      pthread_join(jobs[i].thread, NULL);
+    }
+    else
+    {
+      core_worker(&jobs[i]);
+    }
+  }
+}
+
+static int core_processors(void)
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+  return n > 0 ? (int) n : 1;
+}
+#endif
+
+int xtensa_core_decode(const struct xtensa_core *core, const struct xtensa_gpacket_layout *layout,
+                       const struct xtensa_regindex *index, void *images, size_t stride, int num_workers)
+{
+  struct core_plan plan;
+  struct core_job *jobs = NULL;
+  int per_job = 0, i = 0;
+
+  if (core_plan_build(&plan, layout, index) != 0)
+  {
+    return -1;
+  }
+  if (core->num_threads == 0)
+  {
+    return 0;
+  }
+
+  if (num_workers <= 0)
+  {
+    num_workers = core_processors();
+  }
+  if (num_workers > (core->num_threads + CORE_MIN_THREADS_PER_WORKER - 1) / CORE_MIN_THREADS_PER_WORKER)
+  {
+    num_workers = (core->num_threads + CORE_MIN_THREADS_PER_WORKER - 1) / CORE_MIN_THREADS_PER_WORKER;
+  }
+  jobs = calloc(num_workers, sizeof(*jobs));
+  if (jobs == NULL)
+  {
+    num_workers = 1;
+  }
+
+  per_job = (core->num_threads + num_workers - 1) / num_workers;
+  for (i = 0; i < num_workers; i++)
+  {
+    struct core_job job;
+
+    memset(&job, 0, sizeof(job));
+    job.core = core;
+    job.plan = &plan;
+    job.images = images;
+    job.stride = stride;
+    job.first = i * per_job;
+    job.count = per_job;
+    if (job.first + job.count > core->num_threads)
+    {
+      job.count = core->num_threads > job.first ? core->num_threads - job.first : 0;
+    }
+    if (jobs == NULL)
+    {
+      core_worker(&job);
+    }
+    else
+    {
+      jobs[i] = job;
+    }
+  }
+  if (jobs != NULL)
+  {
+    core_run(jobs, num_workers);
+    free(jobs);
+  }
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/decoder.h"
+
+// The chip library's ISA and its decoder, published once looked up; the
+// ISA is stored last, so a reader that sees it also sees the decoder
+static xtensa_isa s_chip_isa;
+static const struct xtensa_decoder_ops *s_chip_ops;
+
+static int generic_decode(xtensa_isa isa, const unsigned char *buf, int len, struct xtensa_decoded_insn *insn)
+{
+  xtensa_insnbuf_word insnbuf[XTENSA_DECODED_MAX_INSNBUF_SIZE];
+  xtensa_insnbuf_word slotbuf[XTENSA_DECODED_MAX_INSNBUF_SIZE];
+  int length = 0, slot = 0, i = 0;
+
+  if (len < 1 || xtensa_insnbuf_size(isa) > XTENSA_DECODED_MAX_INSNBUF_SIZE)
+  {
+    return XTENSA_UNDEFINED;
+  }
+  length = xtensa_isa_length_from_chars(isa, buf);
+  if (length == XTENSA_UNDEFINED || length > len)
+  {
+    return XTENSA_UNDEFINED;
+  }
+
+  xtensa_insnbuf_from_chars(isa, insnbuf, buf, length);
+  insn->format = xtensa_format_decode(isa, insnbuf);
+  if (insn->format == XTENSA_UNDEFINED)
+  {
+    return XTENSA_UNDEFINED;
+  }
+  insn->length = length;
+  insn->num_slots = xtensa_format_num_slots(isa, insn->format);
+  if (insn->num_slots > XTENSA_DECODED_MAX_SLOTS)
+  {
+    return XTENSA_UNDEFINED;
+  }
+
+  for (slot = 0; slot < insn->num_slots; slot++)
+  {
+    struct xtensa_decoded_slot *s = &insn->slots[slot];
+    int num_operands = 0;
+
+    memset(slotbuf, 0, sizeof(slotbuf));
+    xtensa_format_get_slot(isa, insn->format, slot, insnbuf, slotbuf);
+    s->opcode = xtensa_opcode_decode(isa, insn->format, slot, slotbuf);
+    if (s->opcode == XTENSA_UNDEFINED)
+    {
+      continue;
+    }
+    num_operands = xtensa_opcode_num_operands(isa, s->opcode);
+    for (i = 0; i < num_operands && i < XTENSA_DECODED_MAX_OPERANDS; i++)
+    {
+      if (xtensa_operand_get_field(isa, s->opcode, i, insn->format, slot, slotbuf, &s->fields[i]) != 0)
+      {
+        s->fields[i] = 0;
+      }
+    }
+  }
+  return length;
+}
+
+static int generic_encode(xtensa_isa isa, const struct xtensa_decoded_insn *insn, unsigned char *buf)
+{
+  xtensa_insnbuf_word insnbuf[XTENSA_DECODED_MAX_INSNBUF_SIZE];
+  xtensa_insnbuf_word slotbuf[XTENSA_DECODED_MAX_INSNBUF_SIZE];
+  int num_slots = 0, slot = 0, i = 0;
+
+  if (xtensa_insnbuf_size(isa) > XTENSA_DECODED_MAX_INSNBUF_SIZE
+      || xtensa_format_encode(isa, insn->format, insnbuf) != 0)
+  {
+    return XTENSA_UNDEFINED;
+  }
+
+  num_slots = xtensa_format_num_slots(isa, insn->format);
+  for (slot = 0; slot < num_slots && slot < XTENSA_DECODED_MAX_SLOTS; slot++)
+  {
+    const struct xtensa_decoded_slot *s = &insn->slots[slot];
+    int num_operands = 0;
+
+    memset(slotbuf, 0, xtensa_insnbuf_size(isa) * sizeof(xtensa_insnbuf_word));
+    if (xtensa_opcode_encode(isa, insn->format, slot, slotbuf, s->opcode) != 0)
+    {
+      return XTENSA_UNDEFINED;
+    }
+    num_operands = xtensa_opcode_num_operands(isa, s->opcode);
+    for (i = 0; i < num_operands && i < XTENSA_DECODED_MAX_OPERANDS; i++)
+    {
+      // Implicit operands have no field to set
+      xtensa_operand_set_field(isa, s->opcode, i, insn->format, slot, slotbuf, s->fields[i]);
+    }
+    xtensa_format_set_slot(isa, insn->format, slot, insnbuf, slotbuf);
+  }
+
+  return xtensa_insnbuf_to_chars(isa, insnbuf, buf, xtensa_format_length(isa, insn->format));
+}
+
+static const struct xtensa_decoder_ops s_generic_ops =
+{
+  generic_decode,
+  generic_encode,
+};
+
+const struct xtensa_decoder_ops *xtensa_decoder_select(xtensa_isa isa)
+{
+  xtensa_isa chip_isa = __atomic_load_n(&s_chip_isa, __ATOMIC_ACQUIRE);
+  const struct xtensa_decoder_ops *ops = NULL;
+
+  if (chip_isa == NULL)
+  {
+    // Looked up until a chip library is loaded; racing threads find the
+    // same pointers
+    chip_isa = (xtensa_isa) xtensa_find_config("xtensa_modules", NULL);
+    if (chip_isa == NULL)
+    {
+      return &s_generic_ops;
+    }
+    // The specialized decoder is compiled against the chip's own tables
+    ops = xtensa_find_config("xtensa_decoder_ops", NULL);
+    __atomic_store_n(&s_chip_ops, ops ? ops : &s_generic_ops, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_chip_isa, chip_isa, __ATOMIC_RELEASE);
+  }
+  return isa == chip_isa ? __atomic_load_n(&s_chip_ops, __ATOMIC_RELAXED) : &s_generic_ops;
+}
+
+int xtensa_decode_insn(xtensa_isa isa, const unsigned char *buf, int len, struct xtensa_decoded_insn *insn)
+{
+  return xtensa_decoder_select(isa)->decode(isa, buf, len, insn);
+}
+
+int xtensa_encode_insn(xtensa_isa isa, const struct xtensa_decoded_insn *insn, unsigned char *buf)
+{
+  return xtensa_decoder_select(isa)->encode(isa, insn, buf);
+}
@@ -1,3 +1,4 @@
+#include <stddef.h>
 #include <stdint.h>
 #include <unistd.h>
 #include <libgen.h>
@@ -8,6 +9,7 @@
 
 #ifndef _WIN32
 #include <dlfcn.h>
+#include <pthread.h>
 #endif
 
 #ifdef __linux__
@@ -21,6 +23,8 @@
 #endif
 
 #include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/fingerprint.h"
+#include "xtensaconfig/stats.h"
 
 #ifdef __linux__
 #define PROC_PATH_MAX 32
@@ -47,7 +51,7 @@
 static int snprintf_or_abort(char *str, size_t size, const char *fmt, ...);
 static void get_library_directory(char *libdir, size_t libdir_size);
 static void get_path_to_executable(char *path, size_t path_size);
-static void xtensa_load_shared_lib(void **s_handle, const char *xtensaconfig_option);
+static int xtensa_load_shared_lib(void **handle, const char *xtensaconfig_option, const char *variant, int required);
 
 static const char *esp_log_proc(void);
 static const char *esp_log_cmdline(void);
@@ -57,11 +61,45 @@ static char *apple_dirname(char *path);
 #endif
 
 static struct xtensa_config *s_dynconfig = NULL;
+// Fingerprint of a configuration installed from a blob
+static const struct xtensa_fingerprint *s_blob_fingerprint = NULL;
+// s_handle is the per-tool library when there is one, s_full_handle the
+// full chip library, loaded only for symbols the former does not carry
+static void *s_handle = NULL;
+static void *s_full_handle = NULL;
+
+// Background load started by xtensa_config_prefetch().  The thread only
+// opens the libraries named here and records how that went; the loader
+// logs and accounts it after the join.
+struct prefetch_lib
+{
+  char lib_file[PATH_MAX];
+  void *handle;
+  char error[256];
+  unsigned long long start;
+  unsigned long long ns;
+};
+
+static struct
+{
+  int started;
+  char option[256];
+  // The per-tool library if there is one, then the full one
+  struct prefetch_lib libs[2];
+  int num_libs;
+  int num_tried;
+#ifdef _WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+} s_prefetch;
 extern const struct xtensa_config xtensa_default_config;
 
 void xtensa_reset_config(void)
 {
   s_dynconfig = NULL;
+  s_blob_fingerprint = NULL;
   ESP_LOG_TRACE("Reset dynconfig");
 }
 
@@ -197,6 +235,7 @@ static struct {
 
 static void *dlopen (const char *filename, int flags);
 static void *dlsym (void *handle, const char *name);
+static int dlclose (void *handle);
 static const char *dlerror (void);
 
 static void *dlopen (const char *filename, int flags)
@@ -224,6 +263,16 @@ static void *dlsym (void *handle, const char *name)
     return (void *)(intptr_t)fp;
 }
 
+static int dlclose (void *handle)
+{
+    if (!FreeLibrary ((HINSTANCE)handle)) {
+        var.lasterror = GetLastError ();
+        var.err_rutin = "dlclose";
+        return -1;
+    }
+    return 0;
+}
+
 static const char *dlerror (void)
 {
     static char errstr [PATH_MAX];
@@ -238,29 +287,178 @@ static const char *dlerror (void)
 
 #endif /* !defined (HAVE_DLFCN_H) && defined (_WIN32)  */
 
-static void xtensa_load_shared_lib(void **handle, const char *xtensaconfig_option)
+// LIB_FILE of PATH_MAX bytes: the library of VARIANT, or the full one if
+// VARIANT is null
+static void xtensa_lib_path(char *lib_file, const char *xtensaconfig_option, const char *variant)
 {
   size_t curr_size = 0;
-  char lib_file [PATH_MAX] = {0};
+  unsigned long long start = xtensa_config_phase_begin(XTENSA_CONFIG_PHASE_PATH);
 
   get_library_directory(lib_file, PATH_MAX);
   curr_size = strlen(lib_file);
-  snprintf_or_abort(&lib_file[curr_size], PATH_MAX - curr_size, "xtensaconfig-%s.so", xtensaconfig_option);
-  *handle = dlopen (lib_file, RTLD_NOW);
+  snprintf_or_abort(&lib_file[curr_size], PATH_MAX - curr_size, "xtensaconfig-%s%s%s.so", xtensaconfig_option,
+                    variant ? "-" : "", variant ? variant : "");
+  xtensa_config_phase_end(XTENSA_CONFIG_PHASE_PATH, start);
+}
 
-  if (!(*handle))
+// Report the dlopen of LIB_FILE, which gave HANDLE or failed with ERROR
+static int xtensa_lib_opened(const char *lib_file, void *handle, const char *error, int required)
+{
+  if (!handle && !required)
   {
-    ESP_LOG_ERR("Lib \"%s\" cannot be loaded: %s", lib_file, dlerror());
+    ESP_LOG_INFO("Lib \"%s\" cannot be loaded: %s", lib_file, error);
+    return 0;
+  }
+  if (!handle)
+  {
+    ESP_LOG_ERR("Lib \"%s\" cannot be loaded: %s", lib_file, error);
     abort ();
   }
   ESP_LOG_INFO("Lib \"%s\" loaded", lib_file);
+  return 1;
 }
 
-const void *xtensa_load_config (const char *symbol, const void *dummy_data)
+static int xtensa_load_shared_lib(void **handle, const char *xtensaconfig_option, const char *variant, int required)
+{
+  char lib_file [PATH_MAX] = {0};
+  unsigned long long start = 0;
+
+  xtensa_lib_path(lib_file, xtensaconfig_option, variant);
+  start = xtensa_config_phase_begin(XTENSA_CONFIG_PHASE_DLOPEN);
+  *handle = dlopen (lib_file, RTLD_NOW);
+  xtensa_config_phase_end(XTENSA_CONFIG_PHASE_DLOPEN, start);
+  return xtensa_lib_opened(lib_file, *handle, *handle ? NULL : dlerror(), required);
+}
+
+// Open the per-tool library, or the full one if there is no variant
+static int xtensa_open_shared_libs(const char *xtensaconfig_option, void **handle, void **full_handle, int required)
+{
+  const char *variant = xtensaconfig_get_lib_variant();
+
+  if (variant != NULL && xtensa_load_shared_lib(handle, xtensaconfig_option, variant, 0))
+  {
+    return 1;
+  }
+  if (!xtensa_load_shared_lib(handle, xtensaconfig_option, NULL, required))
+  {
+    return 0;
+  }
+  *full_handle = *handle;
+  return 1;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI xtensa_prefetch_thread(LPVOID arg)
+#else
+static void *xtensa_prefetch_thread(void *arg)
+#endif
+{
+  const char *error = NULL;
+  int i = 0;
+
+  (void) arg;
+  // dlopen with RTLD_NOW also processes the relocations, which faults in
+  // the pages the first lookup would otherwise wait for.  Nothing else
+  // here may log or touch the loader's state.
+  for (i = 0; i < s_prefetch.num_libs; i++)
+  {
+    struct prefetch_lib *lib = &s_prefetch.libs[i];
+
+    s_prefetch.num_tried++;
+    lib->start = xtensa_config_phase_begin(XTENSA_CONFIG_PHASE_DLOPEN);
+    lib->handle = dlopen(lib->lib_file, RTLD_NOW);
+    lib->ns = xtensa_config_phase_stop(XTENSA_CONFIG_PHASE_DLOPEN, lib->start);
+    if (lib->handle != NULL)
+    {
+      break;
+    }
+    error = dlerror();
+    snprintf(lib->error, sizeof(lib->error), "%s", error ? error : "unknown error");
+  }
+#ifdef _WIN32
+  return 0;
+#else
+  return NULL;
+#endif
+}
+
+void xtensa_config_prefetch(const char *xtensaconfig_option)
+{
+  const char *variant = xtensaconfig_get_lib_variant();
+
+  if (xtensaconfig_option == NULL || strcmp("default", xtensaconfig_option) == 0
+      || s_prefetch.started || s_handle != NULL
+      || strlen(xtensaconfig_option) >= sizeof(s_prefetch.option))
+  {
+    return;
+  }
+
+  strcpy(s_prefetch.option, xtensaconfig_option);
+  memset(s_prefetch.libs, 0, sizeof(s_prefetch.libs));
+  s_prefetch.num_libs = s_prefetch.num_tried = 0;
+  if (variant != NULL)
+  {
+    xtensa_lib_path(s_prefetch.libs[s_prefetch.num_libs++].lib_file, xtensaconfig_option, variant);
+  }
+  xtensa_lib_path(s_prefetch.libs[s_prefetch.num_libs++].lib_file, xtensaconfig_option, NULL);
+#ifdef _WIN32
+  s_prefetch.thread = CreateThread(NULL, 0, xtensa_prefetch_thread, NULL, 0, NULL);
+  s_prefetch.started = s_prefetch.thread != NULL;
+#else
+  s_prefetch.started = pthread_create(&s_prefetch.thread, NULL, xtensa_prefetch_thread, NULL) == 0;
+#endif
+  ESP_LOG_INFO("Prefetch of \'%s\' %s", xtensaconfig_option, s_prefetch.started ? "started" : "failed");
+}
+
+// Take over the prefetched libraries if they are for XTENSACONFIG_OPTION;
+// otherwise the caller loads synchronously and reports any error
+static void xtensa_prefetch_wait(const char *xtensaconfig_option)
+{
+  int i = 0;
+
+  if (!s_prefetch.started)
+  {
+    return;
+  }
+
+#ifdef _WIN32
+  WaitForSingleObject(s_prefetch.thread, INFINITE);
+  CloseHandle(s_prefetch.thread);
+#else
+  pthread_join(s_prefetch.thread, NULL);
+#endif
+  s_prefetch.started = 0;
+
+  for (i = 0; i < s_prefetch.num_tried; i++)
+  {
+    struct prefetch_lib *lib = &s_prefetch.libs[i];
+
+    xtensa_config_phase_account(XTENSA_CONFIG_PHASE_DLOPEN, lib->start, lib->ns);
+    if (!xtensa_lib_opened(lib->lib_file, lib->handle, lib->error, 0))
+    {
+      continue;
+    }
+    if (strcmp(s_prefetch.option, xtensaconfig_option) == 0)
+    {
+      s_handle = lib->handle;
+      s_full_handle = i == s_prefetch.num_libs - 1 ? lib->handle : NULL;
+    }
+    else
+    {
+      // Another chip was selected after all: drop its library rather
+      // than keep it mapped next to the one loaded now
+      dlclose(lib->handle);
+      ESP_LOG_INFO("Lib \"%s\" of \'%s\' unloaded", lib->lib_file, s_prefetch.option);
+    }
+    lib->handle = NULL;
+  }
+}
+
+static const void *xtensa_lookup_config (const char *symbol, const void *dummy_data, int required)
 {
-  static void *s_handle = NULL;
   const char *xtensaconfig_option = xtensaconfig_get_option();
   const void *p = NULL;
+  unsigned long long start = 0;
 
   // While we are having an uninitialized command line option,
   // use dummy data to keep working,
@@ -281,12 +479,33 @@ const void *xtensa_load_config (const char *symbol, const void *dummy_data)
   // Load config from dynamic library
   if (s_handle == NULL)
   {
-    xtensa_load_shared_lib(&s_handle, xtensaconfig_option);
+    xtensa_prefetch_wait(xtensaconfig_option);
+  }
+  if (s_handle == NULL)
+  {
+    xtensa_open_shared_libs(xtensaconfig_option, &s_handle, &s_full_handle, 1);
   }
 
   ESP_LOG_INFO("Use \'%s\' config for \"%s\" symbol", xtensaconfig_option, symbol);
 
+  start = xtensa_config_phase_begin(XTENSA_CONFIG_PHASE_DLSYM);
   p = dlsym (s_handle, symbol);
+  xtensa_config_phase_end(XTENSA_CONFIG_PHASE_DLSYM, start);
+  if (!p && s_handle != s_full_handle)
+  {
+    if (s_full_handle == NULL)
+    {
+      xtensa_load_shared_lib(&s_full_handle, xtensaconfig_option, NULL, 1);
+    }
+    start = xtensa_config_phase_begin(XTENSA_CONFIG_PHASE_DLSYM);
+    p = dlsym (s_full_handle, symbol);
+    xtensa_config_phase_end(XTENSA_CONFIG_PHASE_DLSYM, start);
+  }
+  if (!p && !required)
+  {
+    ESP_LOG_INFO("Symbol \"%s\" is not provided, use fallback", symbol);
+    return dummy_data;
+  }
   if (!p)
   {
     ESP_LOG_ERR("Symbol \"%s\" cannot be found: %s", symbol, dlerror());
@@ -296,8 +515,27 @@ const void *xtensa_load_config (const char *symbol, const void *dummy_data)
   return p;
 }
 
+const void *xtensa_load_config (const char *symbol, const void *dummy_data)
+{
+  return xtensa_lookup_config (symbol, dummy_data, 1);
+}
+
+const void *xtensa_find_config (const char *symbol, const void *dummy_data)
+{
+  return xtensa_lookup_config (symbol, dummy_data, 0);
+}
+
+const void *xtensa_config_table (const char *symbol)
+{
+  // Absent in the default configuration and in libraries built before
+  // the table was added
+  return xtensa_find_config (symbol, NULL);
+}
+
 struct xtensa_config *xtensa_get_config (int opt_dbg)
 {
+  unsigned long long start = 0;
+
   ESP_LOG_TRACE("DYN: %s, OPT: %3d", xtensaconfig_get_option(), opt_dbg);
   if (s_dynconfig)
   {
@@ -308,16 +546,170 @@ struct xtensa_config *xtensa_get_config (int opt_dbg)
   s_dynconfig = (struct xtensa_config *) xtensa_load_config ("xtensa_config", &xtensa_default_config);
   ESP_LOG_TRACE("Setup %s xtensa_config", (&xtensa_default_config == s_dynconfig) ? "default" : "custom");
 
+  start = xtensa_config_phase_begin(XTENSA_CONFIG_PHASE_CHECK);
   if (s_dynconfig->config_size < sizeof(struct xtensa_config))
   {
     ESP_LOG_ERR("Old or incompatible configuration is loaded: config_size = %lu, expected: %u",
       s_dynconfig->config_size, (uint32_t) sizeof (struct xtensa_config));
     abort ();
   }
+  xtensa_config_phase_end(XTENSA_CONFIG_PHASE_CHECK, start);
 
   return s_dynconfig;
 }
 
+// Serialized configuration: little-endian words, see xtensa_config_serialize():
+// magic, version, number of fields, option length, the option, the
+// fields and the fingerprint
+#define CONFIG_BLOB_MAGIC      0x47464358u // "XCFG"
+#define CONFIG_BLOB_VERSION    2u
+#define CONFIG_BLOB_NUM_FIELDS ((sizeof(struct xtensa_config) - offsetof(struct xtensa_config, xchal_have_be)) \
+                                / sizeof(unsigned int))
+
+static void blob_put32(unsigned char *p, uint32_t v)
+{
+  p[0] = v & 0xff;
+  p[1] = (v >> 8) & 0xff;
+  p[2] = (v >> 16) & 0xff;
+  p[3] = (v >> 24) & 0xff;
+}
+
+static uint32_t blob_get32(const unsigned char *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+// Size of the blob at P from its header, 0 if it is not a blob of this
+// version
+static size_t blob_size_of(const unsigned char *p, size_t size)
+{
+  uint32_t num_fields = 0, option_len = 0;
+  size_t blob_size = 0;
+
+  if (size < 16 || blob_get32(p) != CONFIG_BLOB_MAGIC || blob_get32(p + 4) != CONFIG_BLOB_VERSION)
+  {
+    ESP_LOG_WARN("Bad config blob header");
+    return 0;
+  }
+  num_fields = blob_get32(p + 8);
+  option_len = blob_get32(p + 12);
+  blob_size = (size_t) 16 + option_len + (size_t) num_fields * 4 + XTENSA_FINGERPRINT_SIZE;
+  if (num_fields > 0x10000 || option_len > PATH_MAX || size < blob_size)
+  {
+    ESP_LOG_WARN("Truncated config blob");
+    return 0;
+  }
+  return blob_size;
+}
+
+int xtensa_config_blob_fingerprint(const void *buf, size_t size, struct xtensa_fingerprint *fp)
+{
+  size_t blob_size = blob_size_of(buf, size);
+
+  if (blob_size == 0)
+  {
+    return 0;
+  }
+  memcpy(fp->bytes, (const unsigned char *) buf + blob_size - XTENSA_FINGERPRINT_SIZE, XTENSA_FINGERPRINT_SIZE);
+  return 1;
+}
+
+size_t xtensa_config_serialize(void *buf, size_t size)
+{
+  const struct xtensa_config *config = xtensa_get_config(-1);
+  const unsigned int *fields = &config->xchal_have_be;
+  const char *option = xtensaconfig_get_option();
+  size_t option_len = option ? strlen(option) : 0;
+  size_t blob_size = 4 * 4 + option_len + 4 * CONFIG_BLOB_NUM_FIELDS + XTENSA_FINGERPRINT_SIZE;
+  unsigned char *p = buf;
+  size_t i = 0;
+
+  if (buf == NULL || size < blob_size)
+  {
+    return blob_size;
+  }
+
+  blob_put32(p, CONFIG_BLOB_MAGIC);
+  blob_put32(p + 4, CONFIG_BLOB_VERSION);
+  blob_put32(p + 8, (uint32_t) CONFIG_BLOB_NUM_FIELDS);
+  blob_put32(p + 12, (uint32_t) option_len);
+  p += 16;
+  memcpy(p, option ? option : "", option_len);
+  p += option_len;
+  for (i = 0; i < CONFIG_BLOB_NUM_FIELDS; i++, p += 4)
+  {
+    blob_put32(p, fields[i]);
+  }
+  memcpy(p, xtensa_config_fingerprint()->bytes, XTENSA_FINGERPRINT_SIZE);
+  return blob_size;
+}
+
+size_t xtensa_config_deserialize(const void *buf, size_t size)
+{
+  static struct xtensa_config s_blob_config;
+  static struct xtensa_fingerprint s_fingerprint;
+  const unsigned char *p = buf;
+  const char *option = xtensaconfig_get_option();
+  unsigned int *fields = &s_blob_config.xchal_have_be;
+  uint32_t num_fields = 0, option_len = 0;
+  size_t blob_size = blob_size_of(p, size), i = 0;
+
+  if (blob_size == 0)
+  {
+    return 0;
+  }
+  num_fields = blob_get32(p + 8);
+  option_len = blob_get32(p + 12);
+  if (num_fields < CONFIG_BLOB_NUM_FIELDS)
+  {
+    ESP_LOG_WARN("Old or incompatible config blob: %u fields, expected: %u",
+      num_fields, (uint32_t) CONFIG_BLOB_NUM_FIELDS);
+    return 0;
+  }
+  if (option && (strlen(option) != option_len || memcmp(option, p + 16, option_len) != 0))
+  {
+    ESP_LOG_WARN("Config blob was made for \'%.*s\', not \'%s\'", (int) option_len, p + 16, option);
+    return 0;
+  }
+
+  p += 16 + option_len;
+  for (i = 0; i < CONFIG_BLOB_NUM_FIELDS; i++, p += 4)
+  {
+    fields[i] = blob_get32(p);
+  }
+  memcpy(s_fingerprint.bytes, (const unsigned char *) buf + blob_size - XTENSA_FINGERPRINT_SIZE,
+         XTENSA_FINGERPRINT_SIZE);
+  s_blob_config.config_size = sizeof(struct xtensa_config);
+  s_dynconfig = &s_blob_config;
+  s_blob_fingerprint = &s_fingerprint;
+  ESP_LOG_INFO("Config installed from blob");
+  return blob_size;
+}
+
+const struct xtensa_fingerprint *xtensa_config_fingerprint(void)
+{
+  static struct xtensa_fingerprint s_computed;
+  const struct xtensa_fingerprint *fp = NULL;
+
+  // A configuration from a blob comes with its own, and the library
+  // need not be loaded
+  if (s_blob_fingerprint != NULL)
+  {
+    return s_blob_fingerprint;
+  }
+  fp = xtensa_config_table ("xtensa_config_fingerprint_data");
+
+  // Computed for the default configuration and for older libraries, over
+  // the same tables the generator hashes for the precomputed one
+  if (fp == NULL)
+  {
+    xtensa_fingerprint_compute(&s_computed, xtensa_get_config(-1), xtensa_config_table("xtensa_config_strings"),
+                               xtensa_config_table("xtensa_modules"));
+    fp = &s_computed;
+  }
+  return fp;
+}
+
 #ifdef __APPLE__
 static char *apple_dirname(char *path)
 {
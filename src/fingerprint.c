@@ -0,0 +1,259 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/fingerprint.h"
+
+// FNV-1a 128: offset basis 0x6c62272e07bb014262b821756295c58d,
+// prime 2^88 + 0x13b; the state is kept in two 64-bit halves
+struct fnv128
+{
+  uint64_t hi;
+  uint64_t lo;
+};
+
+static void fnv128_byte(struct fnv128 *h, unsigned char c)
+{
+  uint64_t lo_lo = 0, lo_hi = 0, carry = 0, hi = 0;
+
+  h->lo ^= c;
+
+  // x * 0x13b, split to keep the carry into the high half
+  lo_lo = (h->lo & 0xffffffffu) * 0x13b;
+  lo_hi = (h->lo >> 32) * 0x13b;
+  carry = (lo_hi + (lo_lo >> 32)) >> 32;
+  hi = h->hi * 0x13b + carry;
+
+  // x << 88 only touches the high half: lo << 24
+  hi += h->lo << 24;
+
+  h->lo = h->lo * 0x13b;
+  h->hi = hi;
+}
+
+static void fnv128_bytes(struct fnv128 *h, const void *data, size_t len)
+{
+  const unsigned char *p = data;
+
+  while (len--)
+  {
+    fnv128_byte(h, *p++);
+  }
+}
+
+static void fnv128_u32(struct fnv128 *h, uint32_t v)
+{
+  fnv128_byte(h, v & 0xff);
+  fnv128_byte(h, (v >> 8) & 0xff);
+  fnv128_byte(h, (v >> 16) & 0xff);
+  fnv128_byte(h, (v >> 24) & 0xff);
+}
+
+static void fnv128_str(struct fnv128 *h, const char *s)
+{
+  if (s)
+  {
+    fnv128_bytes(h, s, strlen(s));
+  }
+  fnv128_byte(h, 0);
+}
+
+static void hash_isa(struct fnv128 *h, const xtensa_isa_internal *isa)
+{
+  int i = 0, j = 0;
+
+  fnv128_u32(h, isa->is_big_endian);
+  fnv128_u32(h, isa->insn_size);
+  fnv128_u32(h, isa->insnbuf_size);
+  fnv128_u32(h, isa->num_fields);
+
+  fnv128_u32(h, isa->num_formats);
+  for (i = 0; i < isa->num_formats; i++)
+  {
+    fnv128_str(h, isa->formats[i].name);
+    fnv128_u32(h, isa->formats[i].length);
+    fnv128_u32(h, isa->formats[i].num_slots);
+    for (j = 0; j < isa->formats[i].num_slots; j++)
+    {
+      fnv128_u32(h, isa->formats[i].slot_id[j]);
+    }
+  }
+
+  fnv128_u32(h, isa->num_slots);
+  for (i = 0; i < isa->num_slots; i++)
+  {
+    fnv128_str(h, isa->slots[i].name);
+    fnv128_str(h, isa->slots[i].format);
+    fnv128_u32(h, isa->slots[i].position);
+    fnv128_str(h, isa->slots[i].nop_name);
+  }
+
+  fnv128_u32(h, isa->num_operands);
+  for (i = 0; i < isa->num_operands; i++)
+  {
+    fnv128_str(h, isa->operands[i].name);
+    fnv128_u32(h, isa->operands[i].field_id);
+    fnv128_u32(h, isa->operands[i].regfile);
+    fnv128_u32(h, isa->operands[i].num_regs);
+    fnv128_u32(h, isa->operands[i].flags);
+  }
+
+  fnv128_u32(h, isa->num_iclasses);
+  for (i = 0; i < isa->num_iclasses; i++)
+  {
+    const xtensa_iclass_internal *ic = &isa->iclasses[i];
+
+    fnv128_u32(h, ic->num_operands);
+    for (j = 0; j < ic->num_operands; j++)
+    {
+      fnv128_u32(h, ic->operands[j].u.operand_id);
+      fnv128_byte(h, ic->operands[j].inout);
+    }
+    fnv128_u32(h, ic->num_stateOperands);
+    for (j = 0; j < ic->num_stateOperands; j++)
+    {
+      fnv128_u32(h, ic->stateOperands[j].u.state);
+      fnv128_byte(h, ic->stateOperands[j].inout);
+    }
+    fnv128_u32(h, ic->num_interfaceOperands);
+    for (j = 0; j < ic->num_interfaceOperands; j++)
+    {
+      fnv128_u32(h, ic->interfaceOperands[j]);
+    }
+  }
+
+  fnv128_u32(h, isa->num_opcodes);
+  for (i = 0; i < isa->num_opcodes; i++)
+  {
+    const xtensa_opcode_internal *op = &isa->opcodes[i];
+
+    fnv128_str(h, op->name);
+    fnv128_u32(h, op->iclass_id);
+    fnv128_u32(h, op->flags);
+    for (j = 0; j < isa->num_slots; j++)
+    {
+      fnv128_byte(h, op->encode_fns[j] != NULL);
+    }
+    fnv128_u32(h, op->num_funcUnit_uses);
+    for (j = 0; j < op->num_funcUnit_uses; j++)
+    {
+      fnv128_u32(h, op->funcUnit_uses[j].unit);
+      fnv128_u32(h, op->funcUnit_uses[j].stage);
+    }
+  }
+
+  fnv128_u32(h, isa->num_regfiles);
+  for (i = 0; i < isa->num_regfiles; i++)
+  {
+    fnv128_str(h, isa->regfiles[i].name);
+    fnv128_str(h, isa->regfiles[i].shortname);
+    fnv128_u32(h, isa->regfiles[i].parent);
+    fnv128_u32(h, isa->regfiles[i].num_bits);
+    fnv128_u32(h, isa->regfiles[i].num_entries);
+  }
+
+  fnv128_u32(h, isa->num_states);
+  for (i = 0; i < isa->num_states; i++)
+  {
+    fnv128_str(h, isa->states[i].name);
+    fnv128_u32(h, isa->states[i].num_bits);
+    fnv128_u32(h, isa->states[i].flags);
+  }
+
+  fnv128_u32(h, isa->num_sysregs);
+  for (i = 0; i < isa->num_sysregs; i++)
+  {
+    fnv128_str(h, isa->sysregs[i].name);
+    fnv128_u32(h, isa->sysregs[i].number);
+    fnv128_u32(h, isa->sysregs[i].is_user);
+  }
+
+  fnv128_u32(h, isa->num_interfaces);
+  for (i = 0; i < isa->num_interfaces; i++)
+  {
+    fnv128_str(h, isa->interfaces[i].name);
+    fnv128_u32(h, isa->interfaces[i].num_bits);
+    fnv128_u32(h, isa->interfaces[i].flags);
+    fnv128_u32(h, isa->interfaces[i].class_id);
+    fnv128_byte(h, isa->interfaces[i].inout);
+  }
+
+  fnv128_u32(h, isa->num_funcUnits);
+  for (i = 0; i < isa->num_funcUnits; i++)
+  {
+    fnv128_str(h, isa->funcUnits[i].name);
+    fnv128_u32(h, isa->funcUnits[i].num_copies);
+  }
+}
+
+// Offset basis
+static void fnv128_init(struct fnv128 *h)
+{
+  h->hi = 0x6c62272e07bb0142ull;
+  h->lo = 0x62b821756295c58dull;
+}
+
+static void fnv128_final(const struct fnv128 *h, struct xtensa_fingerprint *fp)
+{
+  int i = 0;
+
+  for (i = 0; i < 8; i++)
+  {
+    fp->bytes[i] = (h->hi >> (56 - 8 * i)) & 0xff;
+    fp->bytes[8 + i] = (h->lo >> (56 - 8 * i)) & 0xff;
+  }
+}
+
+void xtensa_fingerprint_hash(struct xtensa_fingerprint *fp, const void *data, size_t len)
+{
+  struct fnv128 h;
+
+  fnv128_init(&h);
+  fnv128_bytes(&h, data, len);
+  fnv128_final(&h, fp);
+}
+
+void xtensa_fingerprint_compute(struct xtensa_fingerprint *fp, const struct xtensa_config *config,
+                                const char *const *strings, const void *isa)
+{
+  struct fnv128 h;
+  const unsigned int *fields = &config->xchal_have_be;
+  size_t num_fields = (sizeof(struct xtensa_config) - offsetof(struct xtensa_config, xchal_have_be))
+                      / sizeof(unsigned int);
+  size_t i = 0;
+
+  fnv128_init(&h);
+  fnv128_u32(&h, (uint32_t) num_fields);
+  for (i = 0; i < num_fields; i++)
+  {
+    fnv128_u32(&h, fields[i]);
+  }
+
+  for (i = 0; strings && strings[i]; i++)
+  {
+    fnv128_str(&h, strings[i]);
+  }
+  fnv128_u32(&h, (uint32_t) i);
+
+  if (isa)
+  {
+    hash_isa(&h, isa);
+  }
+  fnv128_final(&h, fp);
+}
+
+void xtensa_fingerprint_format(const struct xtensa_fingerprint *fp, char *buf)
+{
+  static const char hex[] = "0123456789abcdef";
+  int i = 0;
+
+  for (i = 0; i < XTENSA_FINGERPRINT_SIZE; i++)
+  {
+    buf[2 * i] = hex[fp->bytes[i] >> 4];
+    buf[2 * i + 1] = hex[fp->bytes[i] & 0xf];
+  }
+  buf[2 * XTENSA_FINGERPRINT_SIZE] = '\0';
+}
@@ -0,0 +1,173 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/gpacket.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define HOST_BIG_ENDIAN 1
+#else
+#define HOST_BIG_ENDIAN 0
+#endif
+
+const struct xtensa_gpacket_layout *xtensa_config_gpacket(void)
+{
+  return xtensa_config_table("xtensa_gpacket_layout_data");
+}
+
+// 16-byte blocks are reversed per register with one constant shuffle;
+// plain loops handle the rest and compilers without vector extensions
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 12)
+typedef unsigned char gpacket_vec __attribute__((vector_size(16)));
+#define GPACKET_SHUFFLE(v, ...) __builtin_shufflevector(v, v, __VA_ARGS__)
+#elif defined(__GNUC__)
+typedef unsigned char gpacket_vec __attribute__((vector_size(16)));
+#define GPACKET_SHUFFLE(v, ...) __builtin_shuffle(v, (gpacket_vec) { __VA_ARGS__ })
+#endif
+
+#ifdef GPACKET_SHUFFLE
+#define GPACKET_SWAP_BLOCKS(...) \
+  for (; i + 16 <= length; i += 16) \
+  { \
+    gpacket_vec v; \
+    memcpy(&v, src + i, 16); \
+    v = GPACKET_SHUFFLE(v, __VA_ARGS__); \
+    memcpy(dst + i, &v, 16); \
+  }
+#else
+#define GPACKET_SWAP_BLOCKS(...)
+#endif
+
+// Reverse every ELEM bytes of SRC into DST
+static void gpacket_swap(unsigned char *dst, const unsigned char *src, size_t length, unsigned int elem)
+{
+  size_t i = 0;
+  unsigned int j = 0;
+
+  switch (elem)
+  {
+    case 2:
+      GPACKET_SWAP_BLOCKS(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+      for (; i + 2 <= length; i += 2)
+      {
+        uint16_t v;
+
+        memcpy(&v, src + i, 2);
+        v = __builtin_bswap16(v);
+        memcpy(dst + i, &v, 2);
+      }
+      break;
+    case 4:
+      GPACKET_SWAP_BLOCKS(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+      for (; i + 4 <= length; i += 4)
+      {
+        uint32_t v;
+
+        memcpy(&v, src + i, 4);
+        v = __builtin_bswap32(v);
+        memcpy(dst + i, &v, 4);
+      }
+      break;
+    case 8:
+      GPACKET_SWAP_BLOCKS(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8)
+      for (; i + 8 <= length; i += 8)
+      {
+        uint64_t v;
+
+        memcpy(&v, src + i, 8);
+        v = __builtin_bswap64(v);
+        memcpy(dst + i, &v, 8);
+      }
+      break;
+    case 16:
+      GPACKET_SWAP_BLOCKS(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+      // Fall through
+    default:
+      for (; i + elem <= length; i += elem)
+      {
+        for (j = 0; j < elem; j++)
+        {
+          dst[i + j] = src[i + elem - 1 - j];
+        }
+      }
+      break;
+  }
+}
+
+static void gpacket_runs(const struct xtensa_gpacket_layout *layout, const struct xtensa_gpacket_run **runs,
+                         int *num_runs)
+{
+  if (layout->big_endian == HOST_BIG_ENDIAN)
+  {
+    *runs = layout->copy_runs;
+    *num_runs = layout->num_copy_runs;
+  }
+  else
+  {
+    *runs = layout->swap_runs;
+    *num_runs = layout->num_swap_runs;
+  }
+}
+
+static void gpacket_move(const struct xtensa_gpacket_run *run, unsigned char *dst, const unsigned char *src,
+                         int swap)
+{
+  if (swap)
+  {
+    gpacket_swap(dst, src, run->length, run->elem);
+  }
+  else
+  {
+    memcpy(dst, src, run->length);
+  }
+}
+
+size_t xtensa_gpacket_unpack(const struct xtensa_gpacket_layout *layout, const void *packet, size_t len, void *image)
+{
+  const struct xtensa_gpacket_run *runs = NULL;
+  int swap = layout->big_endian != HOST_BIG_ENDIAN;
+  int num_runs = 0, i = 0;
+  size_t used = 0;
+
+  // A short packet is taken register by register
+  if (len < layout->packet_size)
+  {
+    runs = layout->regs;
+    num_runs = layout->num_regs;
+  }
+  else
+  {
+    gpacket_runs(layout, &runs, &num_runs);
+  }
+
+  for (i = 0; i < num_runs; i++)
+  {
+    const struct xtensa_gpacket_run *run = &runs[i];
+
+    if (run->length == 0 || run->packet + run->length > len)
+    {
+      continue;
+    }
+    gpacket_move(run, (unsigned char *) image + run->image, (const unsigned char *) packet + run->packet, swap);
+    if (run->packet + run->length > used)
+    {
+      used = run->packet + run->length;
+    }
+  }
+  return used;
+}
+
+void xtensa_gpacket_pack(const struct xtensa_gpacket_layout *layout, const void *image, void *packet)
+{
+  const struct xtensa_gpacket_run *runs = NULL;
+  int swap = layout->big_endian != HOST_BIG_ENDIAN;
+  int num_runs = 0, i = 0;
+
+  gpacket_runs(layout, &runs, &num_runs);
+  for (i = 0; i < num_runs; i++)
+  {
+    const struct xtensa_gpacket_run *run = &runs[i];
+
+    gpacket_move(run, (unsigned char *) packet + run->packet, (const unsigned char *) image + run->image, swap);
+  }
+}
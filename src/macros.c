@@ -0,0 +1,122 @@
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensaconfig/macros.h"
+
+static int macro_name_cmp(const struct xtensa_config_macro *macro, const char *name, size_t len)
+{
+  int cmp = memcmp(macro->name, name, macro->name_len < len ? macro->name_len : len);
+
+  if (cmp != 0)
+  {
+    return cmp;
+  }
+  return macro->name_len < len ? -1 : macro->name_len > len;
+}
+
+// First entry whose name is not below NAME
+static size_t macro_lower_bound(const struct xtensa_config_macros *macros, const char *name, size_t len)
+{
+  size_t lo = 0, hi = macros->num_macros;
+
+  while (lo < hi)
+  {
+    size_t mid = lo + (hi - lo) / 2;
+
+    if (macro_name_cmp(&macros->macros[mid], name, len) < 0)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+int xtensa_config_macros_init(struct xtensa_config_macros *macros, const char *const *strings)
+{
+  size_t num_strings = 0, i = 0, pos = 0;
+
+  memset(macros, 0, sizeof(*macros));
+  while (strings[num_strings] != NULL)
+  {
+    num_strings++;
+  }
+  macros->macros = malloc((num_strings ? num_strings : 1) * sizeof(*macros->macros));
+  if (macros->macros == NULL)
+  {
+    return -1;
+  }
+
+  // Inserted in list order, so that a later duplicate finds the first
+  for (i = 0; i < num_strings; i++)
+  {
+    const char *eq = strchr(strings[i], '=');
+    size_t len = eq ? (size_t) (eq - strings[i]) : 0;
+
+    if (eq == NULL)
+    {
+      continue;
+    }
+    pos = macro_lower_bound(macros, strings[i], len);
+    if (pos < macros->num_macros && macro_name_cmp(&macros->macros[pos], strings[i], len) == 0)
+    {
+      continue;
+    }
+    memmove(&macros->macros[pos + 1], &macros->macros[pos], (macros->num_macros - pos) * sizeof(*macros->macros));
+    macros->macros[pos].name = strings[i];
+    macros->macros[pos].name_len = len;
+    macros->macros[pos].value = eq + 1;
+    macros->num_macros++;
+  }
+  return 0;
+}
+
+void xtensa_config_macros_free(struct xtensa_config_macros *macros)
+{
+  free(macros->macros);
+  memset(macros, 0, sizeof(*macros));
+}
+
+const struct xtensa_config_macro *xtensa_config_macros_find(const struct xtensa_config_macros *macros,
+                                                            const char *name, size_t len)
+{
+  size_t pos = macro_lower_bound(macros, name, len);
+
+  if (pos < macros->num_macros && macro_name_cmp(&macros->macros[pos], name, len) == 0)
+  {
+    return &macros->macros[pos];
+  }
+  return NULL;
+}
+
+// A digit, or a dot and a digit, then digits, letters, underscores,
+// dots and exponent signs
+int xtensa_config_macro_is_number(const char *value)
+{
+  const char *p = value;
+
+  if (*p == '.')
+  {
+    p++;
+  }
+  if (!isdigit((unsigned char) *p))
+  {
+    return 0;
+  }
+  for (p = value; *p != '\0'; p++)
+  {
+    if ((*p == '+' || *p == '-') && p > value && strchr("eEpP", p[-1]) != NULL)
+    {
+      continue;
+    }
+    if (!isalnum((unsigned char) *p) && *p != '_' && *p != '.')
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
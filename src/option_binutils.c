@@ -6,3 +6,9 @@ const char *xtensaconfig_get_option(void)
 {
     return xtensaconfig_string;
 }
+
+// Only the ISA tables are needed, not the GDB register maps
+const char *xtensaconfig_get_lib_variant(void)
+{
+    return "bfd";
+}
@@ -1,10 +1,374 @@
 #include "config.h"
 #include "system.h"
 #include "coretypes.h"
+#include "backend.h"
 #include "target.h"
+#include "tree.h"
+#include "gimple.h"
+#include "tree-pass.h"
+#include "context.h"
+#include "cgraph.h"
+#include "lto-streamer.h"
+#include "opts.h"
+#include "simple-object.h"
+#include "cpplib.h"
+#include "ggc.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/fingerprint.h"
+#include "xtensaconfig/macros.h"
+#include "xtensaconfig/sched.h"
 
 /* Returns GCC's CLI option value */
 const char *xtensaconfig_get_option(void)
 {
     return global_options.x_xtensaconfig_string;
 }
+
+/* cc1 only needs xtensa_config, xtensa_config_strings and the scheduling
+   tables, which the -gcc library carries without the ISA tables */
+const char *xtensaconfig_get_lib_variant(void)
+{
+    return "gcc";
+}
+
+/* Returns the scheduling model of the selected chip for the TARGET_SCHED_*
+   hooks, or NULL when the default configuration is used, or the library
+   predates the scheduling tables, and the generic model should stay in
+   effect.  The tables are part of the -gcc library, so cc1 does not load
+   the ISA for them */
+const struct xtensa_sched_model *xtensa_get_sched_model(void)
+{
+    static struct xtensa_sched_model *s_model = NULL;
+    static bool s_initialized = false;
+
+    if (!s_initialized)
+    {
+        const struct xtensa_sched_tables *tables
+            = (const struct xtensa_sched_tables *)
+              xtensa_config_table ("xtensa_sched_tables_data");
+
+        if (tables)
+            s_model = xtensa_sched_model_init (tables);
+        s_initialized = true;
+    }
+    return s_model;
+}
+
+/* Predefines __XTENSA_CONFIG_FINGERPRINT__ as a string literal that
+   identifies the selected configuration, so that compiler caches and PCH
+   checks can key on it.  Called from TARGET_CPU_CPP_BUILTINS */
+void xtensa_define_config_fingerprint(cpp_reader *pfile)
+{
+    char hex[XTENSA_FINGERPRINT_HEX_SIZE];
+    char def[sizeof ("__XTENSA_CONFIG_FINGERPRINT__=\"\"")
+             + XTENSA_FINGERPRINT_HEX_SIZE];
+
+    xtensa_fingerprint_format (xtensa_config_fingerprint (), hex);
+    snprintf (def, sizeof (def), "__XTENSA_CONFIG_FINGERPRINT__=\"%s\"", hex);
+    cpp_define (pfile, def);
+}
+
+/* Lazily defined __XCHAL_* macros.  Instead of predefining every entry of
+   xtensa_config_strings, the entries whose value is a single number are
+   made deferred macros: their identifiers are marked defined without a
+   definition, and libcpp asks user_deferred_macro for one on the first
+   use, which is built from the name to value index of the table.  The
+   index is built once, and a translation unit pays for the macros it
+   uses only.  Entries of another form get a plain definition, and
+   deferred identifiers not in the table go to the callback that was
+   installed before ours */
+
+static struct xtensa_config_macros s_config_macros;
+static cpp_macro *(*s_prev_deferred_macro) (cpp_reader *, location_t,
+                                            cpp_hashnode *);
+
+/* The index of xtensa_config_strings of the chip library, or NULL for the
+   default configuration, whose values GCC predefines itself */
+static const struct xtensa_config_macros *xtensa_config_macro_index(void)
+{
+    static bool s_initialized = false;
+
+    if (!s_initialized)
+    {
+        const char *const *strings = (const char *const *)
+            xtensa_load_config ("xtensa_config_strings", NULL);
+
+        if (strings
+            && xtensa_config_macros_init (&s_config_macros, strings) != 0)
+            fatal_error (UNKNOWN_LOCATION,
+                         "out of memory indexing the xtensa configuration");
+        s_initialized = true;
+    }
+    return s_config_macros.macros ? &s_config_macros : NULL;
+}
+
+/* A macro of the single number token VALUE, as libcpp would have built
+   for a command-line definition */
+static cpp_macro *xtensa_config_number_macro(const char *value)
+{
+    cpp_macro *macro = (cpp_macro *) ggc_alloc_atomic (sizeof (cpp_macro));
+
+    memset (macro, 0, sizeof (cpp_macro));
+    macro->line = BUILTINS_LOCATION;
+    macro->count = 1;
+    macro->kind = cmk_macro;
+    macro->used = 1;
+    macro->exp.tokens[0].type = CPP_NUMBER;
+    macro->exp.tokens[0].src_loc = BUILTINS_LOCATION;
+    macro->exp.tokens[0].val.str.len = strlen (value);
+    macro->exp.tokens[0].val.str.text
+        = (const unsigned char *) ggc_strdup (value);
+    return macro;
+}
+
+static cpp_macro *xtensa_deferred_config_macro(cpp_reader *pfile,
+                                               location_t loc,
+                                               cpp_hashnode *node)
+{
+    const struct xtensa_config_macro *entry
+        = xtensa_config_macros_find (&s_config_macros,
+                                     (const char *) NODE_NAME (node),
+                                     NODE_LEN (node));
+
+    if (!entry || !xtensa_config_macro_is_number (entry->value))
+        return s_prev_deferred_macro
+               ? s_prev_deferred_macro (pfile, loc, node) : NULL;
+    return xtensa_config_number_macro (entry->value);
+}
+
+/* Defines the __XCHAL_* macros of xtensa_config_strings for
+   TARGET_CPU_CPP_BUILTINS, lazily unless the macro definitions are being
+   dumped or checked for use, which needs every one materialized.
+   Defines nothing for the default configuration, and only the entries
+   of the table, so none that an older library lacks.  Must run after the
+   front end has installed its own deferred macro callback */
+void xtensa_define_config_macros_lazily(cpp_reader *pfile)
+{
+    const struct xtensa_config_macros *index = xtensa_config_macro_index ();
+    cpp_callbacks *cb = cpp_get_callbacks (pfile);
+    bool lazy = flag_dump_macros == 0 && !flag_compare_debug
+                && !cpp_get_options (pfile)->warn_unused_macros;
+
+    if (!index)
+        return;
+
+    if (lazy && cb->user_deferred_macro != xtensa_deferred_config_macro)
+    {
+        s_prev_deferred_macro = cb->user_deferred_macro;
+        cb->user_deferred_macro = xtensa_deferred_config_macro;
+    }
+
+    for (size_t i = 0; i < index->num_macros; i++)
+    {
+        const struct xtensa_config_macro *entry = &index->macros[i];
+
+        if (lazy && xtensa_config_macro_is_number (entry->value))
+            cpp_set_deferred_macro (
+                cpp_lookup (pfile, (const unsigned char *) entry->name,
+                            entry->name_len));
+        else
+            /* The entry itself is the "NAME=VALUE" definition */
+            cpp_define (pfile, entry->name);
+    }
+}
+
+/* Seeds GCC's cache parameters and code alignment defaults from the
+   selected chip unless they were given on the command line.  Must be
+   called from TARGET_OPTION_OVERRIDE, before the alignment options are
+   parsed */
+void xtensa_override_tuning_from_config(struct gcc_options *opts,
+                                        struct gcc_options *opts_set)
+{
+    static char s_fetch_align[16];
+    static char s_loop_align[48];
+    unsigned int fetch_width = XCHAL_INST_FETCH_WIDTH;
+    unsigned int line_size = XCHAL_ICACHE_SIZE ? XCHAL_ICACHE_LINESIZE : 0;
+
+    if (XCHAL_DCACHE_LINESIZE)
+        SET_OPTION_IF_UNSET (opts, opts_set, param_l1_cache_line_size,
+                             XCHAL_DCACHE_LINESIZE);
+    if (XCHAL_DCACHE_SIZE)
+        SET_OPTION_IF_UNSET (opts, opts_set, param_l1_cache_size,
+                             XCHAL_DCACHE_SIZE / 1024);
+
+    if (opts->x_optimize_size || fetch_width < 4)
+        return;
+
+    /* Branch targets and loop heads that do not straddle a fetch
+       boundary avoid a refetch; function entries get the same, above the
+       4 bytes the ABI gives them.  A loop head also moves to the start of
+       an instruction cache line when that takes no more padding than the
+       fetch alignment could, so that short loops sit in one line; jump
+       targets are too many to pay for line padding */
+    snprintf (s_fetch_align, sizeof (s_fetch_align), "%u", fetch_width);
+    if (line_size > fetch_width)
+        snprintf (s_loop_align, sizeof (s_loop_align), "%u:%u:%u", line_size,
+                  fetch_width, fetch_width);
+    else
+        snprintf (s_loop_align, sizeof (s_loop_align), "%u", fetch_width);
+    if (opts->x_flag_align_loops && !opts->x_str_align_loops)
+        opts->x_str_align_loops = s_loop_align;
+    if (opts->x_flag_align_jumps && !opts->x_str_align_jumps)
+        opts->x_str_align_jumps = s_fetch_align;
+    if (opts->x_flag_align_functions && !opts->x_str_align_functions)
+        opts->x_str_align_functions = s_fetch_align;
+}
+
+/* LTO: the configuration is streamed into every LTO object (and by WPA
+   into every ltrans object), so that the WPA and ltrans processes adopt
+   it instead of resolving and loading the library once more, possibly
+   in a different environment */
+
+#define XTENSA_LTO_CONFIG_SECTION ".gnu.lto_.xtensa_config"
+
+static void xtensa_lto_write_config(void)
+{
+    size_t size = xtensa_config_serialize (NULL, 0);
+    char *blob = XNEWVEC (char, size);
+
+    xtensa_config_serialize (blob, size);
+    lto_begin_section (XTENSA_LTO_CONFIG_SECTION, false);
+    lto_write_data (blob, size);
+    lto_end_section ();
+    XDELETEVEC (blob);
+}
+
+/* Reads the config section of the LTO object FILE_NAME, which may be an
+   archive member given as "archive@offset" */
+static char *xtensa_lto_read_blob(const char *file_name, size_t *size)
+{
+    char *name = xstrdup (file_name);
+    char *at = strrchr (name, '@');
+    char *blob = NULL;
+    off_t offset = 0, sec_offset = 0, sec_length = 0;
+    simple_object_read *sobj;
+    const char *errmsg;
+    int err, fd;
+
+    if (at)
+    {
+        char *end;
+        long long value = strtoll (at + 1, &end, 0);
+
+        if (*end == '\0')
+        {
+            offset = (off_t) value;
+            *at = '\0';
+        }
+    }
+
+    fd = open (name, O_RDONLY | O_BINARY);
+    if (fd >= 0)
+    {
+        sobj = simple_object_start_read (fd, offset, "__GNU_LTO", &errmsg, &err);
+        if (sobj)
+        {
+            if (simple_object_find_section (sobj, XTENSA_LTO_CONFIG_SECTION,
+                                            &sec_offset, &sec_length,
+                                            &errmsg, &err))
+            {
+                blob = XNEWVEC (char, sec_length);
+                if (lseek (fd, offset + sec_offset, SEEK_SET) < 0
+                    || read (fd, blob, sec_length) != sec_length)
+                {
+                    XDELETEVEC (blob);
+                    blob = NULL;
+                }
+                *size = sec_length;
+            }
+            simple_object_release_read (sobj);
+        }
+        close (fd);
+    }
+    free (name);
+    return blob;
+}
+
+/* Installs the configuration of the first input object that carries one;
+   every other must have been compiled for a configuration with the same
+   fingerprint */
+static void xtensa_lto_rehydrate_config(void)
+{
+    const char *first = NULL;
+    struct xtensa_fingerprint first_fp;
+
+    for (unsigned i = 0; i < num_in_fnames; i++)
+    {
+        struct xtensa_fingerprint fp;
+        size_t size = 0;
+        char *blob = xtensa_lto_read_blob (in_fnames[i], &size);
+
+        if (!blob)
+            continue;
+        if (!xtensa_config_blob_fingerprint (blob, size, &fp))
+            error ("%qs carries a malformed xtensa configuration",
+                   in_fnames[i]);
+        else if (!first)
+        {
+            if (!xtensa_config_deserialize (blob, size))
+                error ("%qs was compiled for another xtensa configuration",
+                       in_fnames[i]);
+            first = in_fnames[i];
+            first_fp = fp;
+        }
+        else if (memcmp (fp.bytes, first_fp.bytes, sizeof (fp.bytes)) != 0)
+            error ("%qs was compiled for another xtensa configuration than %qs",
+                   in_fnames[i], first);
+        XDELETEVEC (blob);
+    }
+}
+
+namespace {
+
+const pass_data pass_data_ipa_xtensa_config =
+{
+    IPA_PASS, /* type */
+    "xtensa-config", /* name */
+    OPTGROUP_NONE, /* optinfo_flags */
+    TV_NONE, /* tv_id */
+    0, /* properties_required */
+    0, /* properties_provided */
+    0, /* properties_destroyed */
+    0, /* todo_flags_start */
+    0, /* todo_flags_finish */
+};
+
+class pass_ipa_xtensa_config : public ipa_opt_pass_d
+{
+public:
+    pass_ipa_xtensa_config (gcc::context *ctxt)
+        : ipa_opt_pass_d (pass_data_ipa_xtensa_config, ctxt,
+                          NULL, /* generate_summary */
+                          xtensa_lto_write_config, /* write_summary */
+                          NULL, /* read_summary */
+                          xtensa_lto_write_config, /* write_optimization_summary */
+                          NULL, /* read_optimization_summary */
+                          NULL, /* stmt_fixup */
+                          0, /* function_transform_todo_flags_start */
+                          NULL, /* function_transform */
+                          NULL) /* variable_transform */
+    {}
+};
+
+} // anon namespace
+
+/* Must be called first thing in TARGET_OPTION_OVERRIDE: in WPA and ltrans
+   it installs the configuration carried by the input objects before
+   anything asks for XCHAL values, and with -flto it arranges for the
+   configuration to be written out */
+void xtensa_lto_config_init(void)
+{
+    if (flag_wpa || flag_ltrans)
+        xtensa_lto_rehydrate_config ();
+
+    if (flag_generate_lto || flag_wpa)
+    {
+        struct register_pass_info info;
+
+        info.pass = new pass_ipa_xtensa_config (g);
+        info.reference_pass_name = "pure-const";
+        info.ref_pass_instance_number = 1;
+        info.pos_op = PASS_POS_INSERT_AFTER;
+        register_pass (&info);
+    }
+}
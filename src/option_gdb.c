@@ -6,3 +6,9 @@ const char *xtensaconfig_get_option(void)
 {
     return xtensaconfig_string;
 }
+
+// The ISA and register tables, without the compiler's scheduling tables
+const char *xtensaconfig_get_lib_variant(void)
+{
+    return "gdb";
+}
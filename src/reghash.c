@@ -0,0 +1,24 @@
+#include <stdint.h>
+
+#include "xtensaconfig/regindex.h"
+
+// FNV-1a 32 over the name bytes
+uint32_t xtensa_regindex_hash_name(const char *name)
+{
+  uint32_t h = 0x811c9dc5;
+
+  for (; *name; name++)
+  {
+    h = (h ^ (unsigned char) *name) * 0x01000193;
+  }
+  return h;
+}
+
+// Fibonacci hashing: the high bits of the product are the well mixed
+// ones, so fold them down
+uint32_t xtensa_regindex_hash_number(unsigned int target_number)
+{
+  uint32_t h = (uint32_t) target_number * 0x9e3779b1;
+
+  return h ^ (h >> 16);
+}
@@ -0,0 +1,40 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/regindex.h"
+
+const struct xtensa_regindex *xtensa_config_regindex(void)
+{
+  return xtensa_config_table("xtensa_regindex_data");
+}
+
+int xtensa_regindex_find_name(const struct xtensa_regindex *index, const char *name)
+{
+  unsigned int mask = index->num_slots - 1;
+  unsigned int slot = xtensa_regindex_hash_name(name) & mask;
+
+  for (; index->by_name[slot].name != NULL; slot = (slot + 1) & mask)
+  {
+    if (strcmp(index->by_name[slot].name, name) == 0)
+    {
+      return index->by_name[slot].reg;
+    }
+  }
+  return -1;
+}
+
+int xtensa_regindex_find_number(const struct xtensa_regindex *index, unsigned int target_number)
+{
+  unsigned int mask = index->num_slots - 1;
+  unsigned int slot = xtensa_regindex_hash_number(target_number) & mask;
+
+  for (; index->by_number[slot].reg >= 0; slot = (slot + 1) & mask)
+  {
+    if (index->by_number[slot].target_number == target_number)
+    {
+      return index->by_number[slot].reg;
+    }
+  }
+  return -1;
+}
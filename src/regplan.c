@@ -0,0 +1,268 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// xtRegisterGroupCP7 does not fit an ISO C enumerator
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "xtensa-tdep.h"
+#pragma GCC diagnostic pop
+
+#include "xtensaconfig/regplan.h"
+
+struct regplan_builder
+{
+  const xtensa_register_t *rmap;
+  int num_regs;
+  const unsigned char *valid;
+  const struct xtensa_regplan_target *target;
+  unsigned char *seen;
+  // Registers to read by 'g' or 'p', by 'p' only and by fetch sequence
+  int *in_g;
+  int num_in_g;
+  int *out_g;
+  int num_out_g;
+  int *fetch;
+  int num_fetch;
+  struct xtensa_regplan *plan;
+};
+
+static int regplan_num_regs(const xtensa_register_t *rmap)
+{
+  int n = 0;
+
+  while (rmap[n].name != NULL)
+  {
+    n++;
+  }
+  return n;
+}
+
+static void regplan_need(struct regplan_builder *b, int reg)
+{
+  const xtensa_register_t *r = NULL;
+  int i = 0;
+
+  if (reg < 0 || reg >= b->num_regs)
+  {
+    b->plan->unavailable[b->plan->num_unavailable++] = reg;
+    return;
+  }
+  if (b->seen[reg])
+  {
+    return;
+  }
+  b->seen[reg] = 1;
+  r = &b->rmap[reg];
+
+  // A composite register has no storage of its own: read its parts,
+  // which may be composite themselves; seen stops cycles
+  if (r->mask != NULL)
+  {
+    for (i = 0; i < r->mask->count; i++)
+    {
+      regplan_need(b, r->mask->mask[i].reg_num);
+    }
+    return;
+  }
+
+  if (!(r->flags & XTENSA_REGISTER_FLAGS_READABLE))
+  {
+    b->plan->unavailable[b->plan->num_unavailable++] = reg;
+  }
+  else if (b->valid != NULL && b->valid[reg] && !(r->flags & XTENSA_REGISTER_FLAGS_VOLATILE))
+  {
+    return;
+  }
+  else if (reg < b->target->g_regs)
+  {
+    b->in_g[b->num_in_g++] = reg;
+  }
+  else if (r->fetch != NULL && b->target->fetch_batch > 0)
+  {
+    b->fetch[b->num_fetch++] = reg;
+  }
+  else
+  {
+    b->out_g[b->num_out_g++] = reg;
+  }
+}
+
+static unsigned long regplan_bytes(const struct regplan_builder *b, const int *regs, int n)
+{
+  unsigned long bytes = 0;
+  int i = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    bytes += b->rmap[regs[i]].byte_size;
+  }
+  return bytes;
+}
+
+static unsigned long regplan_g_bytes(const struct regplan_builder *b)
+{
+  unsigned long bytes = 0;
+  int i = 0;
+
+  for (i = 0; i < b->target->g_regs && i < b->num_regs; i++)
+  {
+    unsigned long end = (unsigned long) b->rmap[i].offset + b->rmap[i].byte_size;
+
+    if (end > bytes)
+    {
+      bytes = end;
+    }
+  }
+  return bytes;
+}
+
+static int regplan_trips(int packets, int depth)
+{
+  return (packets + depth - 1) / depth;
+}
+
+static void regplan_step(struct xtensa_regplan *plan, enum xtensa_regplan_kind kind, int trip,
+                         const int *regs, int n)
+{
+  struct xtensa_regplan_step *step = &plan->steps[plan->num_steps++];
+
+  step->kind = kind;
+  step->trip = trip;
+  step->first = plan->num_steps > 1 ? step[-1].first + step[-1].count : 0;
+  step->count = n;
+  memcpy(&plan->regs[step->first], regs, n * sizeof(int));
+}
+
+// Fetch batches enable one coprocessor each, so keep its registers together
+static void regplan_sort_fetch(struct regplan_builder *b)
+{
+  int i = 0, j = 0;
+
+  for (i = 1; i < b->num_fetch; i++)
+  {
+    int reg = b->fetch[i];
+
+    for (j = i; j > 0 && b->rmap[b->fetch[j - 1]].coprocessor > b->rmap[reg].coprocessor; j--)
+    {
+      b->fetch[j] = b->fetch[j - 1];
+    }
+    b->fetch[j] = reg;
+  }
+}
+
+static void regplan_emit(struct regplan_builder *b)
+{
+  const struct xtensa_regplan_target *t = b->target;
+  struct xtensa_regplan *plan = b->plan;
+  int depth = t->pipeline_depth > 0 ? t->pipeline_depth : 1;
+  unsigned long in_bytes = regplan_bytes(b, b->in_g, b->num_in_g);
+  unsigned long out_bytes = regplan_bytes(b, b->out_g, b->num_out_g);
+  unsigned long g_bytes = regplan_g_bytes(b);
+  unsigned long cost_g = 0, cost_p = 0;
+  int use_g = 0, packet = 0, i = 0, n = 0;
+
+  cost_g = (unsigned long) regplan_trips(1 + b->num_out_g, depth) * t->trip_cost
+           + (g_bytes + out_bytes) * t->byte_cost;
+  cost_p = (unsigned long) regplan_trips(b->num_in_g + b->num_out_g, depth) * t->trip_cost
+           + (in_bytes + out_bytes) * t->byte_cost;
+  use_g = b->num_in_g > 0 && cost_g <= cost_p;
+
+  if (use_g)
+  {
+    regplan_step(plan, XTENSA_REGPLAN_G, packet++ / depth, b->in_g, b->num_in_g);
+    plan->bytes += g_bytes;
+  }
+  else
+  {
+    for (i = 0; i < b->num_in_g; i++)
+    {
+      regplan_step(plan, XTENSA_REGPLAN_P, packet++ / depth, &b->in_g[i], 1);
+    }
+    plan->bytes += in_bytes;
+  }
+  for (i = 0; i < b->num_out_g; i++)
+  {
+    regplan_step(plan, XTENSA_REGPLAN_P, packet++ / depth, &b->out_g[i], 1);
+  }
+  plan->bytes += out_bytes;
+  plan->num_trips = regplan_trips(packet, depth);
+
+  // Fetch sequences run code on the target and are not pipelined
+  regplan_sort_fetch(b);
+  for (i = 0; i < b->num_fetch; i += n)
+  {
+    for (n = 1; i + n < b->num_fetch && n < t->fetch_batch; n++)
+    {
+      if (b->rmap[b->fetch[i + n]].coprocessor != b->rmap[b->fetch[i]].coprocessor)
+      {
+        break;
+      }
+    }
+    regplan_step(plan, XTENSA_REGPLAN_FETCH, plan->num_trips++, &b->fetch[i], n);
+  }
+  plan->bytes += regplan_bytes(b, b->fetch, b->num_fetch);
+
+  plan->cost = (unsigned long) plan->num_trips * t->trip_cost + plan->bytes * t->byte_cost;
+}
+
+struct xtensa_regplan *xtensa_regplan_build(const xtensa_register_t *rmap, const int *need, int num_need,
+                                            const unsigned char *valid,
+                                            const struct xtensa_regplan_target *target)
+{
+  struct regplan_builder b;
+  struct xtensa_regplan *plan = NULL;
+  int num_regs = regplan_num_regs(rmap);
+  int i = 0, ok = 0;
+
+  memset(&b, 0, sizeof(b));
+  b.rmap = rmap;
+  b.num_regs = num_regs;
+  b.valid = valid;
+  b.target = target;
+  b.seen = calloc(num_regs + 1, 1);
+  b.in_g = calloc(num_regs + 1, sizeof(int));
+  b.out_g = calloc(num_regs + 1, sizeof(int));
+  b.fetch = calloc(num_regs + 1, sizeof(int));
+
+  plan = calloc(1, sizeof(*plan));
+  if (plan != NULL)
+  {
+    plan->steps = calloc(num_regs + 1, sizeof(*plan->steps));
+    plan->regs = calloc(num_regs + 1, sizeof(int));
+    plan->unavailable = calloc(num_regs + num_need + 1, sizeof(int));
+    ok = plan->steps && plan->regs && plan->unavailable;
+  }
+
+  if (ok && b.seen && b.in_g && b.out_g && b.fetch)
+  {
+    b.plan = plan;
+    for (i = 0; i < num_need; i++)
+    {
+      regplan_need(&b, need[i]);
+    }
+    regplan_emit(&b);
+  }
+  else
+  {
+    xtensa_regplan_free(plan);
+    plan = NULL;
+  }
+
+  free(b.seen);
+  free(b.in_g);
+  free(b.out_g);
+  free(b.fetch);
+  return plan;
+}
+
+void xtensa_regplan_free(struct xtensa_regplan *plan)
+{
+  if (plan != NULL)
+  {
+    free(plan->steps);
+    free(plan->regs);
+    free(plan->unavailable);
+    free(plan);
+  }
+}
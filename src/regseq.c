@@ -0,0 +1,56 @@
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/regseq.h"
+
+const struct xtensa_regseq_table *xtensa_config_regseq(void)
+{
+  return xtensa_config_table("xtensa_regseq_data");
+}
+
+size_t xtensa_regseq_emit(const struct xtensa_regseq *seq, const int *regs, unsigned char *buf, size_t size)
+{
+  unsigned int i = 0, j = 0;
+
+  if (seq->code == NULL || seq->length > size)
+  {
+    return 0;
+  }
+
+  // Checked first, so that a failed call leaves BUF as it was
+  for (i = 0; regs != NULL && i < seq->num_patches; i++)
+  {
+    if (seq->patches[i].reg >= XTENSA_REGSEQ_NUM_AREGS || regs[seq->patches[i].reg] < 0
+        || regs[seq->patches[i].reg] >= XTENSA_REGSEQ_NUM_AREGS)
+    {
+      return 0;
+    }
+  }
+
+  memcpy(buf, seq->code, seq->length);
+  if (regs == NULL)
+  {
+    return seq->length;
+  }
+
+  for (i = 0; i < seq->num_patches; i++)
+  {
+    const struct xtensa_regseq_patch *patch = &seq->patches[i];
+    int reg = regs[patch->reg];
+
+    for (j = 0; j < patch->num_bits; j++)
+    {
+      unsigned char bit = 1 << (patch->bits[j] % 8);
+
+      if ((reg >> j) & 1)
+      {
+        buf[patch->bits[j] / 8] |= bit;
+      }
+      else
+      {
+        buf[patch->bits[j] / 8] &= ~bit;
+      }
+    }
+  }
+  return seq->length;
+}
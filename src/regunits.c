@@ -0,0 +1,248 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// The register group enum has a value past INT_MAX
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "xtensa-tdep.h"
+#pragma GCC diagnostic pop
+
+#include "xtensaconfig/regunits.h"
+
+// Group bits above these encode the coprocessor
+#define GROUP_KIND_MASK 0xffff
+
+static int reg_unit_key_equal(const struct xtensa_reg_unit *unit, const xtensa_register_t *r)
+{
+  if (r->coprocessor >= 0)
+  {
+    return unit->coprocessor == r->coprocessor;
+  }
+  return unit->coprocessor < 0 && (unit->group & GROUP_KIND_MASK) == ((unsigned int) r->group & GROUP_KIND_MASK);
+}
+
+static int reg_unit_is_eager(const xtensa_register_t *r)
+{
+  return r->coprocessor < 0
+         && ((r->group & xtRegisterGroupGeneral) || r->type == xtRegisterTypeArRegfile
+             || r->type == xtRegisterTypeWindow || r->type == xtRegisterTypeVirtual);
+}
+
+static void reg_unit_add_dep(struct xtensa_reg_unit *unit, int *deps, int self, int dep)
+{
+  int i = 0;
+
+  if (dep == self)
+  {
+    return;
+  }
+  for (i = 0; i < unit->num_deps; i++)
+  {
+    if (deps[i] == dep)
+    {
+      return;
+    }
+  }
+  deps[unit->num_deps++] = dep;
+}
+
+static void reg_units_link(struct xtensa_reg_units *units, struct xtensa_reg_unit *unit_list, int *deps,
+                           const xtensa_register_t *rmap)
+{
+  int cpenable = -1, u = 0, i = 0, j = 0, k = 0;
+
+  for (i = 0; i < units->num_regs; i++)
+  {
+    if (strcasecmp(rmap[i].name, "cpenable") == 0)
+    {
+      cpenable = units->unit_of[i];
+    }
+  }
+
+  for (u = 0; u < units->num_units; u++)
+  {
+    struct xtensa_reg_unit *unit = &unit_list[u];
+    int *unit_deps = &deps[u * units->num_units];
+
+    unit->deps = unit_deps;
+    if (unit->coprocessor >= 0 && cpenable >= 0)
+    {
+      reg_unit_add_dep(unit, unit_deps, u, cpenable);
+    }
+    for (i = 0; i < unit->num_regs; i++)
+    {
+      const xtensa_register_t *r = &rmap[unit->regs[i]];
+
+      for (j = 0; r->mask != NULL && j < r->mask->count; j++)
+      {
+        int part = r->mask->mask[j].reg_num;
+
+        if (part >= 0 && part < units->num_regs)
+        {
+          reg_unit_add_dep(unit, unit_deps, u, units->unit_of[part]);
+        }
+      }
+      // Fetch sequences run code that uses address registers as scratch
+      for (k = 0; r->fetch != NULL && k < units->num_regs; k++)
+      {
+        if (rmap[k].type == xtRegisterTypeArRegfile)
+        {
+          reg_unit_add_dep(unit, unit_deps, u, units->unit_of[k]);
+        }
+      }
+    }
+  }
+}
+
+// The public table with the storage behind its const pointers
+struct reg_units_storage
+{
+  struct xtensa_reg_units units;
+  struct xtensa_reg_unit *unit_list;
+  int *unit_of;
+  int *regs;
+  int *deps;
+};
+
+static int reg_units_partition(struct reg_units_storage *s, const xtensa_register_t *rmap)
+{
+  struct xtensa_reg_units *units = &s->units;
+  int *fill = calloc(units->num_regs + 1, sizeof(int));
+  int i = 0, u = 0, pos = 0;
+
+  if (fill == NULL)
+  {
+    return -1;
+  }
+
+  for (i = 0; i < units->num_regs; i++)
+  {
+    const xtensa_register_t *r = &rmap[i];
+    struct xtensa_reg_unit *unit = NULL;
+
+    for (u = 0; u < units->num_units && !reg_unit_key_equal(&s->unit_list[u], r); u++)
+    {
+    }
+    unit = &s->unit_list[u];
+    if (u == units->num_units)
+    {
+      unit->coprocessor = r->coprocessor;
+      units->num_units++;
+    }
+    unit->group |= r->group;
+    unit->eager |= reg_unit_is_eager(r);
+    unit->num_regs++;
+    if (r->mask == NULL)
+    {
+      unit->bytes += r->byte_size;
+    }
+    s->unit_of[i] = u;
+  }
+
+  // Registers of each unit are contiguous, in rmap order
+  for (u = 0; u < units->num_units; u++)
+  {
+    s->unit_list[u].regs = &s->regs[pos];
+    fill[u] = pos;
+    pos += s->unit_list[u].num_regs;
+  }
+  for (i = 0; i < units->num_regs; i++)
+  {
+    s->regs[fill[s->unit_of[i]]++] = i;
+  }
+  free(fill);
+  return 0;
+}
+
+struct xtensa_reg_units *xtensa_reg_units_build(const xtensa_register_t *rmap)
+{
+  struct reg_units_storage *s = calloc(1, sizeof(*s));
+  int num_regs = 0;
+
+  if (s == NULL)
+  {
+    return NULL;
+  }
+  while (rmap[num_regs].name != NULL)
+  {
+    num_regs++;
+  }
+  s->units.num_regs = num_regs;
+  s->unit_list = calloc(num_regs + 1, sizeof(*s->unit_list));
+  s->unit_of = calloc(num_regs + 1, sizeof(int));
+  s->regs = calloc(num_regs + 1, sizeof(int));
+  s->units.units = s->unit_list;
+  s->units.unit_of = s->unit_of;
+
+  if (!s->unit_list || !s->unit_of || !s->regs || reg_units_partition(s, rmap) != 0)
+  {
+    xtensa_reg_units_free(&s->units);
+    return NULL;
+  }
+
+  s->deps = calloc((size_t) s->units.num_units * s->units.num_units + 1, sizeof(int));
+  if (s->deps == NULL)
+  {
+    xtensa_reg_units_free(&s->units);
+    return NULL;
+  }
+  reg_units_link(&s->units, s->unit_list, s->deps, rmap);
+  return &s->units;
+}
+
+void xtensa_reg_units_free(struct xtensa_reg_units *units)
+{
+  struct reg_units_storage *s = (struct reg_units_storage *) units;
+
+  if (s != NULL)
+  {
+    free(s->unit_list);
+    free(s->unit_of);
+    free(s->regs);
+    free(s->deps);
+    free(s);
+  }
+}
+
+static int reg_units_fault_unit(const struct xtensa_reg_units *units, int u, unsigned char *loaded, int *order,
+                                int n)
+{
+  const struct xtensa_reg_unit *unit = &units->units[u];
+  int i = 0;
+
+  if (loaded[u])
+  {
+    return n;
+  }
+  // Marked first, so that a dependency cycle ends
+  loaded[u] = 1;
+  for (i = 0; i < unit->num_deps; i++)
+  {
+    n = reg_units_fault_unit(units, unit->deps[i], loaded, order, n);
+  }
+  order[n++] = u;
+  return n;
+}
+
+int xtensa_reg_units_fault(const struct xtensa_reg_units *units, int reg, unsigned char *loaded, int *order)
+{
+  int n = 0, u = 0;
+
+  if (reg >= 0 && reg < units->num_regs)
+  {
+    return reg_units_fault_unit(units, units->unit_of[reg], loaded, order, 0);
+  }
+  if (reg == -1)
+  {
+    for (u = 0; u < units->num_units; u++)
+    {
+      if (units->units[u].eager)
+      {
+        n = reg_units_fault_unit(units, u, loaded, order, n);
+      }
+    }
+  }
+  return n;
+}
@@ -0,0 +1,258 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/resources.h"
+
+struct xtensa_resources
+{
+  xtensa_isa_internal *intisa;
+  int num_stages;
+  int num_words;
+  // Bits of units with more than one copy: overlaps there need counting
+  uint64_t *multi_copy;
+  // num_opcodes bitmaps of num_words each
+  uint64_t *reservations;
+  // Reverse slot index, slot_refs[slot_ref_start[opc] .. slot_ref_start[opc + 1])
+  int *slot_ref_start;
+  struct xtensa_slot_ref *slot_refs;
+  // Scratch for the conflict check
+  uint64_t *acc;
+  int *uses;
+};
+
+static int resource_bit(const struct xtensa_resources *res, const xtensa_funcUnit_use *use)
+{
+  return use->unit * res->num_stages + use->stage;
+}
+
+static int build_reservations(struct xtensa_resources *res)
+{
+  xtensa_isa_internal *intisa = res->intisa;
+  int opc = 0, u = 0, max_stage = -1;
+  int num_bits = 0;
+
+  for (opc = 0; opc < intisa->num_opcodes; opc++)
+  {
+    for (u = 0; u < intisa->opcodes[opc].num_funcUnit_uses; u++)
+    {
+      if (intisa->opcodes[opc].funcUnit_uses[u].stage > max_stage)
+      {
+        max_stage = intisa->opcodes[opc].funcUnit_uses[u].stage;
+      }
+    }
+  }
+
+  res->num_stages = max_stage + 1;
+  num_bits = intisa->num_funcUnits * res->num_stages;
+  res->num_words = (num_bits + 63) / 64;
+  if (res->num_words == 0)
+  {
+    res->num_words = 1;
+  }
+
+  res->reservations = calloc((size_t) intisa->num_opcodes * res->num_words, sizeof(uint64_t));
+  res->multi_copy = calloc(res->num_words, sizeof(uint64_t));
+  res->acc = calloc(res->num_words, sizeof(uint64_t));
+  res->uses = calloc(num_bits > 0 ? num_bits : 1, sizeof(int));
+  if (!res->reservations || !res->multi_copy || !res->acc || !res->uses)
+  {
+    return -1;
+  }
+
+  for (opc = 0; opc < intisa->num_opcodes; opc++)
+  {
+    uint64_t *r = &res->reservations[(size_t) opc * res->num_words];
+
+    for (u = 0; u < intisa->opcodes[opc].num_funcUnit_uses; u++)
+    {
+      int bit = resource_bit(res, &intisa->opcodes[opc].funcUnit_uses[u]);
+      r[bit / 64] |= (uint64_t) 1 << (bit % 64);
+    }
+  }
+
+  for (u = 0; u < intisa->num_funcUnits; u++)
+  {
+    int stage = 0;
+
+    if (intisa->funcUnits[u].num_copies <= 1)
+    {
+      continue;
+    }
+    for (stage = 0; stage < res->num_stages; stage++)
+    {
+      int bit = u * res->num_stages + stage;
+      res->multi_copy[bit / 64] |= (uint64_t) 1 << (bit % 64);
+    }
+  }
+  return 0;
+}
+
+static int build_slot_index(struct xtensa_resources *res)
+{
+  xtensa_isa_internal *intisa = res->intisa;
+  int opc = 0, fmt = 0, slot = 0, total = 0;
+
+  res->slot_ref_start = calloc(intisa->num_opcodes + 1, sizeof(int));
+  if (!res->slot_ref_start)
+  {
+    return -1;
+  }
+
+  // First pass counts the pairs per opcode, second pass fills them in
+  for (opc = 0; opc < intisa->num_opcodes; opc++)
+  {
+    res->slot_ref_start[opc] = total;
+    for (fmt = 0; fmt < intisa->num_formats; fmt++)
+    {
+      for (slot = 0; slot < intisa->formats[fmt].num_slots; slot++)
+      {
+        if (intisa->opcodes[opc].encode_fns[intisa->formats[fmt].slot_id[slot]])
+        {
+          total++;
+        }
+      }
+    }
+  }
+  res->slot_ref_start[intisa->num_opcodes] = total;
+
+  res->slot_refs = calloc(total > 0 ? total : 1, sizeof(struct xtensa_slot_ref));
+  if (!res->slot_refs)
+  {
+    return -1;
+  }
+
+  total = 0;
+  for (opc = 0; opc < intisa->num_opcodes; opc++)
+  {
+    for (fmt = 0; fmt < intisa->num_formats; fmt++)
+    {
+      for (slot = 0; slot < intisa->formats[fmt].num_slots; slot++)
+      {
+        if (intisa->opcodes[opc].encode_fns[intisa->formats[fmt].slot_id[slot]])
+        {
+          res->slot_refs[total].format = fmt;
+          res->slot_refs[total].slot = slot;
+          total++;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+struct xtensa_resources *xtensa_resources_init(xtensa_isa isa)
+{
+  struct xtensa_resources *res = calloc(1, sizeof(*res));
+
+  if (!res)
+  {
+    return NULL;
+  }
+  res->intisa = (xtensa_isa_internal *) isa;
+
+  if (build_reservations(res) != 0 || build_slot_index(res) != 0)
+  {
+    xtensa_resources_free(res);
+    return NULL;
+  }
+  return res;
+}
+
+void xtensa_resources_free(struct xtensa_resources *res)
+{
+  if (!res)
+  {
+    return;
+  }
+  free(res->multi_copy);
+  free(res->reservations);
+  free(res->slot_ref_start);
+  free(res->slot_refs);
+  free(res->acc);
+  free(res->uses);
+  free(res);
+}
+
+int xtensa_resources_num_stages(const struct xtensa_resources *res)
+{
+  return res->num_stages;
+}
+
+int xtensa_resources_num_words(const struct xtensa_resources *res)
+{
+  return res->num_words;
+}
+
+const uint64_t *xtensa_resources_reservation(const struct xtensa_resources *res, xtensa_opcode opc)
+{
+  if (opc < 0 || opc >= res->intisa->num_opcodes)
+  {
+    return NULL;
+  }
+  return &res->reservations[(size_t) opc * res->num_words];
+}
+
+// Slow path: count the uses of every replicated unit and compare with its copies
+static int count_conflict(struct xtensa_resources *res, const xtensa_opcode *opcs, int n)
+{
+  xtensa_isa_internal *intisa = res->intisa;
+  int i = 0, u = 0;
+
+  memset(res->uses, 0, sizeof(int) * intisa->num_funcUnits * res->num_stages);
+  for (i = 0; i < n; i++)
+  {
+    for (u = 0; u < intisa->opcodes[opcs[i]].num_funcUnit_uses; u++)
+    {
+      xtensa_funcUnit_use *use = &intisa->opcodes[opcs[i]].funcUnit_uses[u];
+      int bit = resource_bit(res, use);
+
+      if (++res->uses[bit] > intisa->funcUnits[use->unit].num_copies)
+      {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+int xtensa_resources_conflict(struct xtensa_resources *res, const xtensa_opcode *opcs, int n)
+{
+  int i = 0, w = 0, need_count = 0;
+
+  memset(res->acc, 0, sizeof(uint64_t) * res->num_words);
+  for (i = 0; i < n; i++)
+  {
+    const uint64_t *r = xtensa_resources_reservation(res, opcs[i]);
+
+    if (!r)
+    {
+      return 1;
+    }
+    for (w = 0; w < res->num_words; w++)
+    {
+      uint64_t overlap = res->acc[w] & r[w];
+
+      if (overlap & ~res->multi_copy[w])
+      {
+        return 1;
+      }
+      need_count |= overlap != 0;
+      res->acc[w] |= r[w];
+    }
+  }
+  return need_count ? count_conflict(res, opcs, n) : 0;
+}
+
+int xtensa_resources_slot_refs(const struct xtensa_resources *res, xtensa_opcode opc,
+                               const struct xtensa_slot_ref **refs)
+{
+  if (opc < 0 || opc >= res->intisa->num_opcodes)
+  {
+    return XTENSA_UNDEFINED;
+  }
+  *refs = &res->slot_refs[res->slot_ref_start[opc]];
+  return res->slot_ref_start[opc + 1] - res->slot_ref_start[opc];
+}
@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "xtensa-isa.h"
+#include "xtensaconfig/sched.h"
+
+struct xtensa_sched_model
+{
+  const struct xtensa_sched_tables *tables;
+  int issue_rate;
+  // Reservation window: no opcode reserves a unit later than this many cycles after issue
+  int window;
+  int *latency;
+  // Reservations of opcode OPC: reservations[res_start[opc] .. res_start[opc + 1])
+  int *res_start;
+  struct xtensa_sched_reservation *reservations;
+};
+
+struct xtensa_sched_state
+{
+  const struct xtensa_sched_model *model;
+  int head;
+  int issued;
+  // window * num_funcUnits ring of unit copies in use
+  int *busy;
+};
+
+struct xtensa_sched_model *xtensa_sched_model_init(const struct xtensa_sched_tables *tables)
+{
+  struct xtensa_sched_model *model = calloc(1, sizeof(*model));
+  int opc = 0, u = 0, total = 0;
+
+  if (!model)
+  {
+    return NULL;
+  }
+  model->tables = tables;
+  model->issue_rate = tables->issue_rate > 1 ? tables->issue_rate : 1;
+  model->window = 1;
+
+  for (opc = 0; opc < tables->num_opcodes; opc++)
+  {
+    total += tables->opcodes[opc].num_uses;
+  }
+  model->latency = calloc(tables->num_opcodes + 1, sizeof(int));
+  model->res_start = calloc(tables->num_opcodes + 1, sizeof(int));
+  model->reservations = calloc(total > 0 ? total : 1, sizeof(struct xtensa_sched_reservation));
+  if (!model->latency || !model->res_start || !model->reservations)
+  {
+    xtensa_sched_model_free(model);
+    return NULL;
+  }
+
+  // The ISA only says in which pipeline stages an opcode uses which
+  // units, not when its result is ready.  The model takes the opcode to
+  // issue in its first such stage (FIRST) and to produce its result at
+  // the end of its last one (LAST), so its latency is LAST - FIRST + 1:
+  // a one-stage opcode has latency 1, a multiplier that uses its unit in
+  // stages 1 and 2 has latency 2.  Bypasses and writebacks that happen
+  // earlier or later are not described by the ISA tables and are not
+  // modeled.  Reservations are shifted to be relative to FIRST.
+  total = 0;
+  for (opc = 0; opc < tables->num_opcodes; opc++)
+  {
+    const struct xtensa_sched_opcode *op = &tables->opcodes[opc];
+    int first = 0, last = 0;
+
+    for (u = 0; u < op->num_uses; u++)
+    {
+      if (u == 0 || op->uses[u].stage < first)
+      {
+        first = op->uses[u].stage;
+      }
+      if (u == 0 || op->uses[u].stage > last)
+      {
+        last = op->uses[u].stage;
+      }
+    }
+
+    model->res_start[opc] = total;
+    for (u = 0; u < op->num_uses; u++)
+    {
+      model->reservations[total].unit = op->uses[u].unit;
+      model->reservations[total].cycle = op->uses[u].stage - first;
+      total++;
+    }
+    model->latency[opc] = last - first + 1;
+    if (model->latency[opc] > model->window)
+    {
+      model->window = model->latency[opc];
+    }
+  }
+  model->res_start[tables->num_opcodes] = total;
+  return model;
+}
+
+void xtensa_sched_model_free(struct xtensa_sched_model *model)
+{
+  if (!model)
+  {
+    return;
+  }
+  free(model->latency);
+  free(model->res_start);
+  free(model->reservations);
+  free(model);
+}
+
+int xtensa_sched_issue_rate(const struct xtensa_sched_model *model)
+{
+  return model->issue_rate;
+}
+
+xtensa_opcode xtensa_sched_lookup(const struct xtensa_sched_model *model, const char *name)
+{
+  int opc = 0;
+
+  for (opc = 0; opc < model->tables->num_opcodes; opc++)
+  {
+    if (strcasecmp(model->tables->opcodes[opc].name, name) == 0)
+    {
+      return opc;
+    }
+  }
+  return XTENSA_UNDEFINED;
+}
+
+int xtensa_sched_latency(const struct xtensa_sched_model *model, xtensa_opcode opc)
+{
+  if (opc < 0 || opc >= model->tables->num_opcodes)
+  {
+    return XTENSA_UNDEFINED;
+  }
+  return model->latency[opc];
+}
+
+int xtensa_sched_reservations(const struct xtensa_sched_model *model, xtensa_opcode opc,
+                              const struct xtensa_sched_reservation **res)
+{
+  if (opc < 0 || opc >= model->tables->num_opcodes)
+  {
+    return XTENSA_UNDEFINED;
+  }
+  *res = &model->reservations[model->res_start[opc]];
+  return model->res_start[opc + 1] - model->res_start[opc];
+}
+
+struct xtensa_sched_state *xtensa_sched_state_alloc(const struct xtensa_sched_model *model)
+{
+  struct xtensa_sched_state *state = calloc(1, sizeof(*state));
+  int units = model->tables->num_units;
+
+  if (!state)
+  {
+    return NULL;
+  }
+  state->model = model;
+  state->busy = calloc((size_t) model->window * (units > 0 ? units : 1), sizeof(int));
+  if (!state->busy)
+  {
+    free(state);
+    return NULL;
+  }
+  return state;
+}
+
+void xtensa_sched_state_free(struct xtensa_sched_state *state)
+{
+  if (!state)
+  {
+    return;
+  }
+  free(state->busy);
+  free(state);
+}
+
+void xtensa_sched_state_reset(struct xtensa_sched_state *state)
+{
+  memset(state->busy, 0, sizeof(int) * state->model->window * state->model->tables->num_units);
+  state->head = 0;
+  state->issued = 0;
+}
+
+static int *busy_slot(const struct xtensa_sched_state *state, const struct xtensa_sched_reservation *r)
+{
+  int row = (state->head + r->cycle) % state->model->window;
+  return &state->busy[row * state->model->tables->num_units + r->unit];
+}
+
+int xtensa_sched_state_can_issue(const struct xtensa_sched_state *state, xtensa_opcode opc)
+{
+  const struct xtensa_sched_model *model = state->model;
+  const struct xtensa_sched_reservation *res = NULL;
+  int i = 0, n = xtensa_sched_reservations(model, opc, &res);
+
+  if (n < 0 || state->issued >= model->issue_rate)
+  {
+    return 0;
+  }
+  for (i = 0; i < n; i++)
+  {
+    if (*busy_slot(state, &res[i]) >= model->tables->unit_copies[res[i].unit])
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+void xtensa_sched_state_issue(struct xtensa_sched_state *state, xtensa_opcode opc)
+{
+  const struct xtensa_sched_reservation *res = NULL;
+  int i = 0, n = xtensa_sched_reservations(state->model, opc, &res);
+
+  for (i = 0; i < n; i++)
+  {
+    ++*busy_slot(state, &res[i]);
+  }
+  state->issued++;
+}
+
+void xtensa_sched_state_advance(struct xtensa_sched_state *state)
+{
+  int units = state->model->tables->num_units;
+
+  memset(&state->busy[state->head * units], 0, sizeof(int) * units);
+  state->head = (state->head + 1) % state->model->window;
+  state->issued = 0;
+}
+
+int xtensa_sched_estimate_cycles(const struct xtensa_sched_model *model, const xtensa_opcode *opcs, int n)
+{
+  struct xtensa_sched_state *state = NULL;
+  int i = 0, cycles = 0, tail = 0;
+
+  if (n <= 0 || !(state = xtensa_sched_state_alloc(model)))
+  {
+    return 0;
+  }
+
+  cycles = 1;
+  for (i = 0; i < n; i++)
+  {
+    int stalls = 0;
+
+    if (opcs[i] < 0 || opcs[i] >= model->tables->num_opcodes)
+    {
+      continue;
+    }
+    // An opcode that cannot issue in an empty pipeline is counted as issued alone
+    while (!xtensa_sched_state_can_issue(state, opcs[i]) && stalls++ <= model->window)
+    {
+      xtensa_sched_state_advance(state);
+      cycles++;
+      tail = tail > 0 ? tail - 1 : 0;
+    }
+    xtensa_sched_state_issue(state, opcs[i]);
+    if (model->latency[opcs[i]] - 1 > tail)
+    {
+      tail = model->latency[opcs[i]] - 1;
+    }
+  }
+  xtensa_sched_state_free(state);
+  return cycles + tail;
+}
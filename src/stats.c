@@ -0,0 +1,197 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#endif
+#endif
+
+#include "xtensaconfig/stats.h"
+
+#ifdef STAP_PROBE2
+#define PHASE_PROBE_BEGIN(phase)   STAP_PROBE1(xtensaconfig, phase_begin, phase)
+#define PHASE_PROBE_END(phase, ns) STAP_PROBE2(xtensaconfig, phase_end, phase, ns)
+#else
+#define PHASE_PROBE_BEGIN(phase)   do { (void) (phase); } while (0)
+#define PHASE_PROBE_END(phase, ns) do { (void) (phase); (void) (ns); } while (0)
+#endif
+
+#if !defined(_WIN32) && !defined(O_CLOEXEC)
+#define O_CLOEXEC 0
+#endif
+
+// Updated with atomic adds, by whichever thread loads
+static struct xtensa_config_stats s_stats;
+
+// XTENSA_CONFIG_TRACE, opened once for appending, or -1
+#ifdef _WIN32
+static INIT_ONCE s_trace_once = INIT_ONCE_STATIC_INIT;
+#else
+static pthread_once_t s_trace_once = PTHREAD_ONCE_INIT;
+#endif
+static int s_trace_fd = -1;
+
+static const char *const s_phase_names[XTENSA_CONFIG_NUM_PHASES] =
+{
+  "path",
+  "dlopen",
+  "dlsym",
+  "check",
+};
+
+static unsigned long long monotonic_ns(void)
+{
+#ifdef _WIN32
+  static LARGE_INTEGER s_freq;
+  LARGE_INTEGER now;
+
+  if (s_freq.QuadPart == 0)
+  {
+    QueryPerformanceFrequency(&s_freq);
+  }
+  QueryPerformanceCounter(&now);
+  return (unsigned long long) (now.QuadPart / s_freq.QuadPart) * 1000000000ull
+         + (unsigned long long) (now.QuadPart % s_freq.QuadPart) * 1000000000ull / s_freq.QuadPart;
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
+static unsigned long trace_pid(void)
+{
+#ifdef _WIN32
+  return GetCurrentProcessId();
+#else
+  return (unsigned long) getpid();
+#endif
+}
+
+static unsigned long trace_tid(void)
+{
+#ifdef _WIN32
+  return GetCurrentThreadId();
+#elif defined(__linux__)
+  return (unsigned long) syscall(SYS_gettid);
+#else
+  return trace_pid();
+#endif
+}
+
+static void trace_open(void)
+{
+  const char *path = getenv("XTENSA_CONFIG_TRACE");
+
+  if (path != NULL && path[0] != '\0')
+  {
+#ifdef _WIN32
+    s_trace_fd = _open(path, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    s_trace_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+  }
+}
+
+#ifdef _WIN32
+static BOOL CALLBACK trace_open_once(PINIT_ONCE once, PVOID param, PVOID *context)
+{
+  (void) once;
+  (void) param;
+  (void) context;
+  trace_open();
+  return TRUE;
+}
+#endif
+
+// Append one complete ("X") event as a line of its own; a single append
+// write keeps the lines of several processes and threads whole
+static void trace_event(enum xtensa_config_phase phase, unsigned long long start, unsigned long long ns)
+{
+  char line[256];
+  int len = 0;
+
+#ifdef _WIN32
+  InitOnceExecuteOnce(&s_trace_once, trace_open_once, NULL, NULL);
+#else
+  pthread_once(&s_trace_once, trace_open);
+#endif
+  if (s_trace_fd < 0)
+  {
+    return;
+  }
+  len = snprintf(line, sizeof(line),
+                 "{\"name\": \"%s\", \"cat\": \"xtensaconfig\", \"ph\": \"X\", \"ts\": %llu.%03llu, "
+                 "\"dur\": %llu.%03llu, \"pid\": %lu, \"tid\": %lu}\n",
+                 s_phase_names[phase], start / 1000, start % 1000, ns / 1000, ns % 1000, trace_pid(), trace_tid());
+  if (len > 0 && (size_t) len < sizeof(line))
+  {
+    // Best effort: a failed write loses the event
+#ifdef _WIN32
+    int written = _write(s_trace_fd, line, len);
+#else
+    int written = write(s_trace_fd, line, len);
+#endif
+
+    (void) written;
+  }
+}
+
+void xtensa_config_stats(struct xtensa_config_stats *stats)
+{
+  int phase = 0;
+
+  for (phase = 0; phase < XTENSA_CONFIG_NUM_PHASES; phase++)
+  {
+    stats->ns[phase] = __atomic_load_n(&s_stats.ns[phase], __ATOMIC_RELAXED);
+    stats->count[phase] = __atomic_load_n(&s_stats.count[phase], __ATOMIC_RELAXED);
+  }
+}
+
+const char *xtensa_config_phase_name(enum xtensa_config_phase phase)
+{
+  return (unsigned int) phase < XTENSA_CONFIG_NUM_PHASES ? s_phase_names[phase] : NULL;
+}
+
+unsigned long long xtensa_config_phase_begin(enum xtensa_config_phase phase)
+{
+  PHASE_PROBE_BEGIN(phase);
+  return monotonic_ns();
+}
+
+unsigned long long xtensa_config_phase_stop(enum xtensa_config_phase phase, unsigned long long start)
+{
+  unsigned long long ns = monotonic_ns() - start;
+
+  PHASE_PROBE_END(phase, ns);
+  return ns;
+}
+
+void xtensa_config_phase_account(enum xtensa_config_phase phase, unsigned long long start, unsigned long long ns)
+{
+  __atomic_fetch_add(&s_stats.ns[phase], ns, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&s_stats.count[phase], 1, __ATOMIC_RELAXED);
+  trace_event(phase, start, ns);
+}
+
+void xtensa_config_phase_end(enum xtensa_config_phase phase, unsigned long long start)
+{
+  xtensa_config_phase_account(phase, start, xtensa_config_phase_stop(phase, start));
+}
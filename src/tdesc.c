@@ -0,0 +1,7 @@
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/tdesc.h"
+
+const struct xtensa_tdesc *xtensa_config_tdesc(void)
+{
+  return xtensa_config_table("xtensa_tdesc_data");
+}
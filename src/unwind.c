@@ -0,0 +1,471 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensaconfig/decoder.h"
+#include "xtensaconfig/unwind.h"
+
+// Bits of a0 above the return address, the caller's window increment
+#define UNWIND_CALLINC_SHIFT 30
+#define UNWIND_ADDR_MASK 0x3fffffff
+
+static uint32_t unwind_word(const unsigned char *p, int big_endian)
+{
+  if (big_endian)
+  {
+    return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8 | p[3];
+  }
+  return (uint32_t) p[3] << 24 | (uint32_t) p[2] << 16 | (uint32_t) p[1] << 8 | p[0];
+}
+
+static void unwind_live(const xtensa_elf_gregset_t *gregs, int num_aregs, struct xtensa_unwind_frame *frame)
+{
+  int i = 0;
+
+  for (i = 0; i < 4; i++)
+  {
+    frame->a[i] = gregs->ar[(frame->window * 4 + i) & (num_aregs - 1)];
+  }
+}
+
+// The base save area of the caller of a frame with stack pointer SP, in
+// one read
+static int unwind_spilled(const struct xtensa_unwind_target *target, uint32_t sp, struct xtensa_unwind_frame *frame)
+{
+  unsigned char area[16];
+  int i = 0;
+
+  if (sp < sizeof(area) || target->read_memory(target->ctx, sp - sizeof(area), area, sizeof(area)) != 0)
+  {
+    return -1;
+  }
+  for (i = 0; i < 4; i++)
+  {
+    frame->a[i] = unwind_word(area + 4 * i, target->big_endian);
+  }
+  return 0;
+}
+
+int xtensa_unwind_windowed(const xtensa_elf_gregset_t *gregs, int num_aregs, const struct xtensa_unwind_target *target,
+                           struct xtensa_unwind_frame *frames, int max_frames)
+{
+  int window_mask = num_aregs / 4 - 1, live = 1, n = 0;
+
+  if (num_aregs != 16 && num_aregs != 32 && num_aregs != 64)
+  {
+    return -1;
+  }
+  if (max_frames <= 0)
+  {
+    return 0;
+  }
+
+  frames[0].pc = gregs->pc;
+  frames[0].window = gregs->windowbase & window_mask;
+  frames[0].spilled = 0;
+  unwind_live(gregs, num_aregs, &frames[0]);
+  frames[0].sp = frames[0].a[1];
+
+  for (n = 1; n < max_frames; n++)
+  {
+    const struct xtensa_unwind_frame *callee = &frames[n - 1];
+    struct xtensa_unwind_frame *caller = &frames[n];
+    int callinc = callee->a[0] >> UNWIND_CALLINC_SHIFT;
+
+    if (callinc == 0 || (callee->a[0] & UNWIND_ADDR_MASK) == 0)
+    {
+      break;
+    }
+    caller->pc = (callee->a[0] & UNWIND_ADDR_MASK) | (callee->pc & ~UNWIND_ADDR_MASK);
+    caller->window = (callee->window - callinc) & window_mask;
+
+    // Windows spill oldest first: past the first spilled frame, all are,
+    // and the register file holds at most one turn of windows
+    live = live && caller->window != frames[0].window && ((gregs->windowstart >> caller->window) & 1);
+    caller->spilled = !live;
+    if (live)
+    {
+      unwind_live(gregs, num_aregs, caller);
+    }
+    else if (unwind_spilled(target, callee->sp, caller) != 0)
+    {
+      break;
+    }
+    caller->sp = caller->a[1];
+    if (caller->sp < callee->sp)
+    {
+      break;
+    }
+  }
+  return n;
+}
+
+// Call0 prologue analysis
+
+// A tracked register holds the entry value of register BASE plus OFFSET,
+// or the constant OFFSET
+#define CALL0_CONST -1
+#define CALL0_UNKNOWN -2
+
+// Ways of a cache set, replaced least recently used first
+#define CALL0_CACHE_WAYS 4
+
+struct call0_value
+{
+  int base;
+  int32_t offset;
+};
+
+struct call0_opcodes
+{
+  xtensa_opcode addi, addi_n, addmi, add, add_n, sub, or, mov_n, movi, movi_n, s32i, s32i_n;
+  xtensa_opcode entry, ret, ret_n;
+};
+
+static void call0_opcodes_lookup(xtensa_isa isa, struct call0_opcodes *ops)
+{
+  ops->addi = xtensa_opcode_lookup(isa, "addi");
+  ops->addi_n = xtensa_opcode_lookup(isa, "addi.n");
+  ops->addmi = xtensa_opcode_lookup(isa, "addmi");
+  ops->add = xtensa_opcode_lookup(isa, "add");
+  ops->add_n = xtensa_opcode_lookup(isa, "add.n");
+  ops->sub = xtensa_opcode_lookup(isa, "sub");
+  ops->or = xtensa_opcode_lookup(isa, "or");
+  ops->mov_n = xtensa_opcode_lookup(isa, "mov.n");
+  ops->movi = xtensa_opcode_lookup(isa, "movi");
+  ops->movi_n = xtensa_opcode_lookup(isa, "movi.n");
+  ops->s32i = xtensa_opcode_lookup(isa, "s32i");
+  ops->s32i_n = xtensa_opcode_lookup(isa, "s32i.n");
+  ops->entry = xtensa_opcode_lookup(isa, "entry");
+  ops->ret = xtensa_opcode_lookup(isa, "ret");
+  ops->ret_n = xtensa_opcode_lookup(isa, "ret.n");
+}
+
+static int32_t call0_operand(xtensa_isa isa, const struct xtensa_decoded_slot *slot, int opnd)
+{
+  uint32 value = slot->fields[opnd];
+
+  if (xtensa_operand_decode(isa, slot->opcode, opnd, &value) != 0)
+  {
+    value = 0;
+  }
+  return (int32_t) value;
+}
+
+static struct call0_value call0_add(struct call0_value value, int32_t addend)
+{
+  if (value.base != CALL0_UNKNOWN)
+  {
+    value.offset += addend;
+  }
+  return value;
+}
+
+static int call0_is_stop(xtensa_isa isa, const struct call0_opcodes *ops, xtensa_opcode opc)
+{
+  return opc == XTENSA_UNDEFINED || opc == ops->entry || opc == ops->ret || opc == ops->ret_n
+         || xtensa_opcode_is_branch(isa, opc) == 1 || xtensa_opcode_is_jump(isa, opc) == 1
+         || xtensa_opcode_is_loop(isa, opc) == 1 || xtensa_opcode_is_call(isa, opc) == 1;
+}
+
+// Forget the address registers the instruction of SLOT writes
+static void call0_clobber(xtensa_isa isa, const struct xtensa_decoded_slot *slot, struct call0_value *regs)
+{
+  int num_operands = xtensa_opcode_num_operands(isa, slot->opcode);
+  int i = 0, reg = 0;
+  char inout = 0;
+
+  for (i = 0; i < num_operands && i < XTENSA_DECODED_MAX_OPERANDS; i++)
+  {
+    inout = xtensa_operand_inout(isa, slot->opcode, i);
+    if ((inout != 'o' && inout != 'm') || xtensa_operand_is_register(isa, slot->opcode, i) != 1
+        || strcmp(xtensa_regfile_shortname(isa, xtensa_operand_regfile(isa, slot->opcode, i)), "a") != 0)
+    {
+      continue;
+    }
+    reg = call0_operand(isa, slot, i);
+    if (reg >= 0 && reg < C0_NREGS)
+    {
+      regs[reg].base = CALL0_UNKNOWN;
+    }
+  }
+}
+
+static void call0_store(struct xtensa_call0_frame *frame, struct call0_value value, struct call0_value base,
+                        int32_t offset)
+{
+  // The entry value of a register stored relative to the entry sp
+  if (base.base == 1 && value.base >= 0 && value.offset == 0 && frame->saved[value.base] == XTENSA_CALL0_NOT_SAVED)
+  {
+    frame->saved[value.base] = base.offset + offset;
+  }
+}
+
+static void call0_slot(xtensa_isa isa, const struct call0_opcodes *ops, const struct xtensa_decoded_slot *slot,
+                       struct call0_value *regs, struct xtensa_call0_frame *frame)
+{
+  xtensa_opcode opc = slot->opcode;
+  int num_operands = xtensa_opcode_num_operands(isa, opc);
+  int32_t op0 = 0, op1 = 0, op2 = 0;
+  struct call0_value result;
+
+  // Operands are only decoded if the opcode has them
+  if (num_operands < 2 || (op0 = call0_operand(isa, slot, 0)) < 0 || op0 >= C0_NREGS)
+  {
+    call0_clobber(isa, slot, regs);
+    return;
+  }
+  op1 = call0_operand(isa, slot, 1);
+  op2 = num_operands > 2 ? call0_operand(isa, slot, 2) : 0;
+  result.base = CALL0_UNKNOWN;
+  result.offset = 0;
+
+  if (opc == ops->movi || opc == ops->movi_n)
+  {
+    result.base = CALL0_CONST;
+    result.offset = op1;
+  }
+  else if (op1 < 0 || op1 >= C0_NREGS)
+  {
+    call0_clobber(isa, slot, regs);
+    return;
+  }
+  else if (opc == ops->addi || opc == ops->addi_n || opc == ops->addmi)
+  {
+    result = call0_add(regs[op1], op2);
+  }
+  else if (opc == ops->mov_n || (opc == ops->or && op1 == op2))
+  {
+    result = regs[op1];
+  }
+  else if ((opc == ops->add || opc == ops->add_n || opc == ops->sub) && op2 >= 0 && op2 < C0_NREGS)
+  {
+    if (regs[op2].base == CALL0_CONST)
+    {
+      result = call0_add(regs[op1], opc == ops->sub ? -regs[op2].offset : regs[op2].offset);
+    }
+    else if (regs[op1].base == CALL0_CONST && opc != ops->sub)
+    {
+      result = call0_add(regs[op2], regs[op1].offset);
+    }
+  }
+  else if (opc == ops->s32i || opc == ops->s32i_n)
+  {
+    call0_store(frame, regs[op0], regs[op1], op2);
+    return;
+  }
+  else
+  {
+    call0_clobber(isa, slot, regs);
+    return;
+  }
+  regs[op0] = result;
+}
+
+int xtensa_call0_analyze(xtensa_isa isa, const unsigned char *code, size_t len, uint32_t entry, uint32_t stop_pc,
+                         struct xtensa_call0_frame *frame)
+{
+  struct call0_opcodes ops;
+  struct call0_value regs[C0_NREGS];
+  struct xtensa_decoded_insn insn;
+  size_t pos = 0;
+  int length = 0, stop = 0, i = 0;
+
+  call0_opcodes_lookup(isa, &ops);
+  for (i = 0; i < C0_NREGS; i++)
+  {
+    regs[i].base = i;
+    regs[i].offset = 0;
+    frame->saved[i] = XTENSA_CALL0_NOT_SAVED;
+  }
+
+  while (pos < len && entry + pos < stop_pc)
+  {
+    length = xtensa_decode_insn(isa, code + pos, len - pos, &insn);
+    if (length == XTENSA_UNDEFINED)
+    {
+      if (pos == 0)
+      {
+        return -1;
+      }
+      break;
+    }
+    // A bundle with a control transfer ends the prologue before it
+    for (stop = 0, i = 0; i < insn.num_slots; i++)
+    {
+      stop |= call0_is_stop(isa, &ops, insn.slots[i].opcode);
+    }
+    if (stop)
+    {
+      break;
+    }
+    for (i = 0; i < insn.num_slots; i++)
+    {
+      call0_slot(isa, &ops, &insn.slots[i], regs, frame);
+    }
+    pos += length;
+  }
+
+  frame->entry = entry;
+  frame->prologue_end = entry + pos;
+  frame->cfa_reg = -1;
+  frame->cfa_offset = 0;
+  frame->frame_size = 0;
+  if (regs[1].base == 1)
+  {
+    frame->cfa_reg = 1;
+    frame->cfa_offset = frame->frame_size = -regs[1].offset;
+  }
+  if (regs[15].base == 1)
+  {
+    frame->cfa_reg = 15;
+    frame->cfa_offset = -regs[15].offset;
+  }
+  return 0;
+}
+
+struct call0_cache_entry
+{
+  int valid;
+  size_t build_id_len;
+  unsigned char build_id[XTENSA_CALL0_MAX_BUILD_ID];
+  uint32_t read_end;		// Past the code the analysis read
+  unsigned int used;
+  struct xtensa_call0_frame frame;
+};
+
+struct xtensa_call0_cache
+{
+  xtensa_isa isa;
+  struct xtensa_unwind_target target;
+  int num_sets;
+  unsigned int clock;
+  struct call0_cache_entry *entries;
+};
+
+struct xtensa_call0_cache *xtensa_call0_cache_new(xtensa_isa isa, const struct xtensa_unwind_target *target,
+                                                  int capacity)
+{
+  struct xtensa_call0_cache *cache = calloc(1, sizeof(*cache));
+
+  if (cache == NULL)
+  {
+    return NULL;
+  }
+  cache->isa = isa;
+  cache->target = *target;
+  cache->num_sets = 1;
+  while (cache->num_sets * CALL0_CACHE_WAYS < capacity)
+  {
+    cache->num_sets *= 2;
+  }
+  cache->entries = calloc(cache->num_sets * CALL0_CACHE_WAYS, sizeof(*cache->entries));
+  if (cache->entries == NULL)
+  {
+    free(cache);
+    return NULL;
+  }
+  return cache;
+}
+
+void xtensa_call0_cache_free(struct xtensa_call0_cache *cache)
+{
+  if (cache != NULL)
+  {
+    free(cache->entries);
+    free(cache);
+  }
+}
+
+// FNV-1a 64, to pick the set; entries compare the build id itself
+static uint64_t call0_build_id_hash(const void *build_id, size_t len)
+{
+  const unsigned char *p = build_id;
+  uint64_t h = 0xcbf29ce484222325ull;
+  size_t i = 0;
+
+  for (i = 0; i < len; i++)
+  {
+    h = (h ^ p[i]) * 0x100000001b3ull;
+  }
+  return h;
+}
+
+// Read as much of the prologue as the target has, down to one word
+static size_t call0_read(const struct xtensa_call0_cache *cache, uint32_t entry, unsigned char *code)
+{
+  size_t len = XTENSA_CALL0_MAX_PROLOGUE;
+
+  for (; len >= 4; len /= 2)
+  {
+    if (cache->target.read_memory(cache->target.ctx, entry, code, len) == 0)
+    {
+      return len;
+    }
+  }
+  return 0;
+}
+
+int xtensa_call0_cache_lookup(struct xtensa_call0_cache *cache, const void *build_id, size_t len, uint32_t entry,
+                              struct xtensa_call0_frame *frame)
+{
+  uint64_t id = call0_build_id_hash(build_id, len);
+  struct call0_cache_entry *set = NULL, *victim = NULL;
+  unsigned char code[XTENSA_CALL0_MAX_PROLOGUE];
+  size_t code_len = 0;
+  int i = 0;
+
+  // Entries are aligned, so mix before taking the low bits
+  set = &cache->entries[(((id ^ entry) * 0x9e3779b97f4a7c15ull) >> 32 & (cache->num_sets - 1)) * CALL0_CACHE_WAYS];
+  for (i = 0; i < CALL0_CACHE_WAYS; i++)
+  {
+    if (set[i].valid && set[i].frame.entry == entry && set[i].build_id_len == len
+        && (len == 0 || memcmp(set[i].build_id, build_id, len) == 0))
+    {
+      set[i].used = ++cache->clock;
+      *frame = set[i].frame;
+      return 0;
+    }
+    if (victim == NULL || (victim->valid && (!set[i].valid || set[i].used < victim->used)))
+    {
+      victim = &set[i];
+    }
+  }
+
+  code_len = call0_read(cache, entry, code);
+  if (code_len == 0 || xtensa_call0_analyze(cache->isa, code, code_len, entry, UINT32_MAX, frame) != 0)
+  {
+    return -1;
+  }
+  if (len > XTENSA_CALL0_MAX_BUILD_ID)
+  {
+    return 0;
+  }
+  victim->valid = 1;
+  victim->build_id_len = len;
+  if (len != 0)
+  {
+    memcpy(victim->build_id, build_id, len);
+  }
+  victim->read_end = entry + code_len;
+  victim->used = ++cache->clock;
+  victim->frame = *frame;
+  return 0;
+}
+
+void xtensa_call0_cache_invalidate(struct xtensa_call0_cache *cache, uint32_t addr, uint32_t len)
+{
+  int i = 0;
+
+  for (i = 0; i < cache->num_sets * CALL0_CACHE_WAYS; i++)
+  {
+    struct call0_cache_entry *e = &cache->entries[i];
+
+    if (e->valid && addr < e->read_end && (uint64_t) addr + len > e->frame.entry)
+    {
+      e->valid = 0;
+    }
+  }
+}
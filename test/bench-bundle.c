@@ -0,0 +1,75 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/bundle.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/resources.h"
+#include "test.h"
+
+#define NUM_GROUPS 4096
+
+// Pack NUM_GROUPS groups of N opcodes over and over for a while
+static double bench_pack(struct xtensa_bundler *b, const xtensa_opcode *groups, int n, int *packed)
+{
+  struct xtensa_bundle bundle;
+  double start = test_now(), elapsed = 0;
+  long rounds = 0;
+  int g = 0;
+
+  *packed = 0;
+  for (g = 0; g < NUM_GROUPS; g++)
+  {
+    *packed += xtensa_bundler_pack(b, &groups[g * n], n, &bundle) == 0;
+  }
+  for (rounds = 0; (elapsed = test_now() - start) < 0.2; rounds++)
+  {
+    for (g = 0; g < NUM_GROUPS; g++)
+    {
+      xtensa_bundler_pack(b, &groups[g * n], n, &bundle);
+    }
+  }
+  return elapsed / ((double) rounds * NUM_GROUPS) * 1e9;
+}
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  xtensa_isa_internal *intisa = NULL;
+  struct xtensa_resources *res = NULL;
+  struct xtensa_bundler *b = NULL;
+  xtensa_opcode *groups = NULL;
+  double start = 0, ns = 0;
+  int n = 0, i = 0, packed = 0;
+
+  intisa = (xtensa_isa_internal *) xtensa_load_config("xtensa_modules", NULL);
+  start = test_now();
+  res = xtensa_resources_init((xtensa_isa) intisa);
+  b = res ? xtensa_bundler_init((xtensa_isa) intisa, res) : NULL;
+  if (b == NULL)
+  {
+    abort();
+  }
+  printf("bundle %s: %d opcodes, %d formats, tables built in %.2f ms\n", chip, intisa->num_opcodes,
+         intisa->num_formats, (test_now() - start) * 1e3);
+
+  // Random groups of one to three opcodes, the same ones on every run
+  groups = calloc(NUM_GROUPS * 3, sizeof(xtensa_opcode));
+  srand(1);
+  for (n = 1; n <= 3; n++)
+  {
+    for (i = 0; i < NUM_GROUPS * n; i++)
+    {
+      groups[i] = rand() % intisa->num_opcodes;
+    }
+    ns = bench_pack(b, groups, n, &packed);
+    printf("bundle %s: %d op%s: %.0f ns per pack, %d of %d packed\n", chip, n, n > 1 ? "s" : "", ns, packed,
+           NUM_GROUPS);
+  }
+
+  free(groups);
+  xtensa_bundler_free(b);
+  xtensa_resources_free(res);
+  return 0;
+}
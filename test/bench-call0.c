@@ -0,0 +1,111 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/unwind.h"
+#include "prologue.h"
+#include "test.h"
+
+#define NUM_FUNCTIONS 1024
+#define FUNCTION_SPACING 256
+#define CODE_BASE 0x40080000u
+#define NUM_BACKTRACES 1000
+#define NUM_FRAMES 16
+// A debug probe round trip, charged per memory read
+#define READ_LATENCY_US 20.0
+
+static xtensa_isa s_isa;
+static struct test_codemem s_mem;
+// The functions of every frame of every backtrace, low ones the hottest
+static int s_frames[NUM_BACKTRACES * NUM_FRAMES];
+
+// Every frame of every backtrace, through CACHE or read and analyzed each
+// time
+static void backtraces(struct xtensa_call0_cache *cache)
+{
+  unsigned char code[XTENSA_CALL0_MAX_PROLOGUE];
+  struct xtensa_call0_frame frame;
+  uint32_t entry = 0;
+  int i = 0;
+
+  for (i = 0; i < NUM_BACKTRACES * NUM_FRAMES; i++)
+  {
+    entry = CODE_BASE + s_frames[i] * FUNCTION_SPACING;
+    if (cache != NULL)
+    {
+      xtensa_call0_cache_lookup(cache, NULL, 0, entry, &frame);
+    }
+    else if (s_mem.target.read_memory(s_mem.target.ctx, entry, code, sizeof(code)) == 0)
+    {
+      xtensa_call0_analyze(s_isa, code, sizeof(code), entry, UINT32_MAX, &frame);
+    }
+  }
+}
+
+static void bench(const char *chip, int capacity)
+{
+  struct xtensa_call0_cache *cache = NULL;
+  double start = 0, elapsed = 0, bt = 0, reads_per_bt = 0;
+  long rounds = 0;
+  char label[32];
+
+  if (capacity > 0 && (cache = xtensa_call0_cache_new(s_isa, &s_mem.target, capacity)) == NULL)
+  {
+    abort();
+  }
+  // Warm, then the reads and time of a backtrace
+  backtraces(cache);
+  s_mem.reads = 0;
+  start = test_now();
+  for (rounds = 0; (elapsed = test_now() - start) < 0.2; rounds++)
+  {
+    backtraces(cache);
+  }
+  bt = elapsed / rounds / NUM_BACKTRACES;
+  reads_per_bt = (double) s_mem.reads / rounds / NUM_BACKTRACES;
+  snprintf(label, sizeof(label), "%d-entry cache", capacity);
+  printf("call0 %s, %s: %.2f reads, %.2f us cpu, %.3f ms bt at %.0f us per read\n", chip,
+         capacity > 0 ? label : "no cache", reads_per_bt, bt * 1e6,
+         (bt + reads_per_bt * READ_LATENCY_US * 1e-6) * 1e3, READ_LATENCY_US);
+  xtensa_call0_cache_free(cache);
+}
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  struct test_prologue p;
+  unsigned int seed = 1;
+  uint32_t a = 0, b = 0;
+  int f = 0, i = 0;
+
+  s_isa = (xtensa_isa) xtensa_load_config("xtensa_modules", NULL);
+  if (test_codemem_init(&s_mem, CODE_BASE, NUM_FUNCTIONS * FUNCTION_SPACING) != 0)
+  {
+    abort();
+  }
+  for (f = 0; f < NUM_FUNCTIONS; f++)
+  {
+    while (test_prologue_build(s_isa, s_mem.mem + f * FUNCTION_SPACING, FUNCTION_SPACING,
+                               CODE_BASE + f * FUNCTION_SPACING, &seed, &p) != 0)
+    {
+    }
+  }
+  for (i = 0; i < NUM_BACKTRACES * NUM_FRAMES; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    a = (seed >> 16) % NUM_FUNCTIONS;
+    seed = seed * 1103515245 + 12345;
+    b = (seed >> 16) % NUM_FUNCTIONS;
+    s_frames[i] = a * b / NUM_FUNCTIONS;
+  }
+
+  bench(chip, 0);
+  bench(chip, 64);
+  bench(chip, 256);
+  bench(chip, 1024);
+  test_codemem_free(&s_mem);
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xtensaconfig/coredump.h"
+#include "xtensaconfig/dynconfig.h"
+#include "corefile.h"
+#include "test.h"
+
+#define NUM_THREADS 5000
+#define ROUNDS 20
+
+// Best of ROUNDS decodes with NUM_WORKERS, in ms
+static double bench_decode(const struct xtensa_core *core, const struct xtensa_gpacket_layout *layout,
+                           const struct xtensa_regindex *index, unsigned char *images, size_t stride,
+                           int num_workers)
+{
+  double best = 0, start = 0;
+  int round = 0;
+
+  for (round = 0; round < ROUNDS; round++)
+  {
+    start = test_now();
+    xtensa_core_decode(core, layout, index, images, stride, num_workers);
+    if (round == 0 || test_now() - start < best)
+    {
+      best = test_now() - start;
+    }
+  }
+  return best * 1e3;
+}
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  const struct xtensa_gpacket_layout *layout = xtensa_config_gpacket();
+  const struct xtensa_regindex *index = xtensa_config_regindex();
+  struct xtensa_core *core = NULL;
+  unsigned char *data = NULL, *images = NULL;
+  char path[PATH_MAX];
+  size_t size = 0, stride = 0;
+  double start = 0, open_ms = 0, serial_ms = 0, parallel_ms = 0;
+  long workers = sysconf(_SC_NPROCESSORS_ONLN);
+
+  data = test_core_build(NUM_THREADS, 0, &size);
+  if (layout == NULL || index == NULL || data == NULL || test_core_write(data, size, path, sizeof(path)) != 0)
+  {
+    abort();
+  }
+  stride = (layout->image_size + layout->image_align - 1) / layout->image_align * layout->image_align;
+  images = aligned_alloc(layout->image_align, stride * NUM_THREADS);
+
+  start = test_now();
+  core = xtensa_core_open(path);
+  open_ms = (test_now() - start) * 1e3;
+  if (core == NULL || images == NULL)
+  {
+    abort();
+  }
+  memset(images, 0, stride * NUM_THREADS);
+  serial_ms = bench_decode(core, layout, index, images, stride, 1);
+  parallel_ms = bench_decode(core, layout, index, images, stride, 0);
+  printf("coredump %s: %d tasks, %.1f MiB: open %.2f ms, decode %.2f ms on 1 worker, %.2f ms on %ld\n", chip,
+         core->num_threads, size / 1048576.0, open_ms, serial_ms, parallel_ms, workers > 0 ? workers : 1);
+
+  xtensa_core_close(core);
+  unlink(path);
+  free(images);
+  free(data);
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/decoder.h"
+#include "xtensaconfig/dynconfig.h"
+#include "test.h"
+
+#define NUM_INSNS 4096
+#define INSN_BYTES 32
+
+static unsigned char s_bytes[NUM_INSNS][INSN_BYTES];
+
+// Decode NUM_INSNS valid instructions over and over for a while
+static double bench_decode(const struct xtensa_decoder_ops *ops, xtensa_isa isa)
+{
+  struct xtensa_decoded_insn insn;
+  double start = test_now(), elapsed = 0;
+  long rounds = 0;
+  int i = 0;
+
+  for (rounds = 0; (elapsed = test_now() - start) < 0.2; rounds++)
+  {
+    for (i = 0; i < NUM_INSNS; i++)
+    {
+      ops->decode(isa, s_bytes[i], INSN_BYTES, &insn);
+    }
+  }
+  return elapsed / ((double) rounds * NUM_INSNS) * 1e9;
+}
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  static struct xtensa_isa_internal_struct copy;
+  const struct xtensa_decoder_ops *chip_ops = NULL, *generic_ops = NULL;
+  struct xtensa_decoded_insn insn;
+  xtensa_isa isa = NULL;
+  unsigned int seed = 1;
+  int i = 0, j = 0, tries = 0;
+  double chip_ns = 0, generic_ns = 0;
+
+  isa = (xtensa_isa) xtensa_load_config("xtensa_modules", NULL);
+  memcpy(&copy, isa, sizeof(copy));
+  chip_ops = xtensa_decoder_select(isa);
+  generic_ops = xtensa_decoder_select((xtensa_isa) &copy);
+
+  // Random instructions that decode
+  for (i = 0; i < NUM_INSNS && tries < NUM_INSNS * 1000; tries++)
+  {
+    for (j = 0; j < INSN_BYTES; j++)
+    {
+      seed = seed * 1103515245 + 12345;
+      s_bytes[i][j] = seed >> 16;
+    }
+    i += chip_ops->decode(isa, s_bytes[i], INSN_BYTES, &insn) > 0;
+  }
+  if (i < NUM_INSNS)
+  {
+    fprintf(stderr, "few decodable instructions\n");
+    return 1;
+  }
+
+  chip_ns = bench_decode(chip_ops, isa);
+  generic_ns = bench_decode(generic_ops, (xtensa_isa) &copy);
+  printf("decoder %s: %s: %.1f ns per insn, generic: %.1f ns per insn\n", chip,
+         chip_ops != generic_ops ? "specialized" : "no specialized decoder", chip_ns, generic_ns);
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <dlfcn.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "elf.h"
+#include "test.h"
+
+#define RUNS 21
+
+// The per-tool libraries, the full one, and the full one linked without
+// the relocation flags
+static const char *const s_variants[] = { "gcc", "bfd", "gdb", NULL, "plain" };
+
+// Resident set size of the process in KiB
+static long rss_kib(void)
+{
+  FILE *f = fopen("/proc/self/statm", "r");
+  long size = 0, resident = 0;
+
+  if (f == NULL || fscanf(f, "%ld %ld", &size, &resident) != 2)
+  {
+    abort();
+  }
+  fclose(f);
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static int compare_double(const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+
+  return (x > y) - (x < y);
+}
+
+// dlopen PATH with RTLD_NOW as a tool would, in a fresh process; its
+// time and the RSS it added are written to FD
+static void child_open(const char *path, int fd)
+{
+  double sample[2];
+  long before = rss_kib();
+  double start = test_now();
+  void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+
+  sample[0] = test_now() - start;
+  sample[1] = (double) (rss_kib() - before);
+  if (handle == NULL || write(fd, sample, sizeof(sample)) != sizeof(sample))
+  {
+    _exit(1);
+  }
+  _exit(0);
+}
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  double times[RUNS], rss[RUNS], sample[2];
+  char path[PATH_MAX];
+  struct stat st;
+  struct test_elf elf;
+  size_t v = 0;
+  int run = 0, fds[2], status = 0;
+  pid_t child = 0;
+
+  for (v = 0; v < sizeof(s_variants) / sizeof(s_variants[0]); v++)
+  {
+    test_lib_path(path, sizeof(path), chip, s_variants[v]);
+    if (stat(path, &st) != 0 || test_elf_read(path, &elf) != 0 || pipe(fds) != 0)
+    {
+      abort();
+    }
+    for (run = 0; run < RUNS; run++)
+    {
+      fflush(stdout);
+      child = fork();
+      if (child == 0)
+      {
+        close(fds[0]);
+        child_open(path, fds[1]);
+      }
+      if (child < 0 || read(fds[0], sample, sizeof(sample)) != sizeof(sample)
+          || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      {
+        abort();
+      }
+      times[run] = sample[0];
+      rss[run] = sample[1];
+    }
+    close(fds[0]);
+    close(fds[1]);
+    qsort(times, RUNS, sizeof(times[0]), compare_double);
+    qsort(rss, RUNS, sizeof(rss[0]), compare_double);
+    printf("libs %s%s%s: %.1f KiB file, %ld relocations in %ld records, %ld exports, dlopen %.0f us, "
+           "+%.0f KiB RSS (median of %d)\n",
+           chip, s_variants[v] ? "-" : "", s_variants[v] ? s_variants[v] : "", st.st_size / 1024.0, elf.num_relocs,
+           elf.num_records, elf.num_exports, times[RUNS / 2] * 1e6, rss[RUNS / 2], RUNS);
+  }
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/macros.h"
+#include "test.h"
+
+// Macros a translation unit that includes builtin.h typically expands
+#define NUM_USED 4
+
+#undef XTENSA_CONFIG_ENTRY
+#define XTENSA_CONFIG_ENTRY(a) "__" #a
+static const char *const s_names[] = {XTENSA_CONFIG_ENTRY_LIST};
+#undef XTENSA_CONFIG_ENTRY
+#define NUM_NAMES (int) (sizeof(s_names) / sizeof(s_names[0]))
+
+static volatile size_t s_sink;
+
+// Every known name looked up with a scan of the table and its definition
+// formatted, as each cc1 run predefined them before the index
+static void predefine_all(const char *const *strings)
+{
+  char def[128];
+  int i = 0;
+
+  for (i = 0; i < NUM_NAMES; i++)
+  {
+    const char *const *s = strings;
+    size_t len = strlen(s_names[i]);
+
+    for (; *s != NULL; s++)
+    {
+      if (strncmp(*s, s_names[i], len) == 0 && (*s)[len] == '=')
+      {
+        s_sink += snprintf(def, sizeof(def), "%s=%s", s_names[i], *s + len + 1);
+        break;
+      }
+    }
+  }
+}
+
+// The index built, as once per cc1 run, every entry marked deferred, and
+// the values of the macros the unit uses looked up
+static void predefine_used(const char *const *strings)
+{
+  struct xtensa_config_macros macros;
+  const struct xtensa_config_macro *macro = NULL;
+  size_t i = 0;
+
+  if (xtensa_config_macros_init(&macros, strings) != 0)
+  {
+    abort();
+  }
+  for (i = 0; i < macros.num_macros; i++)
+  {
+    s_sink += xtensa_config_macro_is_number(macros.macros[i].value);
+  }
+  for (i = 0; i < NUM_USED && (int) i < NUM_NAMES; i++)
+  {
+    macro = xtensa_config_macros_find(&macros, s_names[i], strlen(s_names[i]));
+    s_sink += macro != NULL ? strlen(macro->value) : 0;
+  }
+  xtensa_config_macros_free(&macros);
+}
+
+// Library side of the XCHAL predefinitions of one translation unit; the
+// preprocessor's own work on each definition, which the deferred macros
+// save for the unused ones, is not part of it
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  const char *const *strings = xtensa_load_config("xtensa_config_strings", NULL);
+  long rounds = 0;
+  double start = 0, elapsed = 0;
+
+  if (strings == NULL)
+  {
+    fprintf(stderr, "%s: no xtensa_config_strings\n", chip);
+    return 1;
+  }
+
+  start = test_now();
+  for (rounds = 0; (elapsed = test_now() - start) < 0.2; rounds++)
+  {
+    predefine_all(strings);
+  }
+  printf("macros %s: %d definitions, scanned for each: %.0f ns per unit\n", chip, NUM_NAMES,
+         elapsed / rounds * 1e9);
+
+  start = test_now();
+  for (rounds = 0; (elapsed = test_now() - start) < 0.2; rounds++)
+  {
+    predefine_used(strings);
+  }
+  printf("macros %s: index built, %d of %d used: %.0f ns per unit\n", chip, NUM_USED, NUM_NAMES,
+         elapsed / rounds * 1e9);
+  return 0;
+}
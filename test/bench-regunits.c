@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "xtensa-tdep.h"
+#pragma GCC diagnostic pop
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/regplan.h"
+#include "xtensaconfig/regunits.h"
+#include "test.h"
+
+// Stop-to-prompt register traffic of one stop, modeled for an OpenOCD
+// stub behind a USB JTAG adapter: about 0.5 ms per round trip and 2 us
+// per reply byte, no 'g' packet and up to 8 fetch sequences per trip
+static const struct xtensa_regplan_target s_stub = { 0, 1, 8, 500, 2 };
+
+static unsigned long plan_cost(const xtensa_register_t *rmap, const int *need, int num_need, int *trips,
+                               unsigned long *bytes)
+{
+  struct xtensa_regplan *plan = xtensa_regplan_build(rmap, need, num_need, NULL, &s_stub);
+  unsigned long cost = 0;
+
+  if (plan == NULL)
+  {
+    abort();
+  }
+  cost = plan->cost;
+  *trips = plan->num_trips;
+  *bytes = plan->bytes;
+  xtensa_regplan_free(plan);
+  return cost;
+}
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  const xtensa_register_t *rmap = NULL;
+  struct xtensa_reg_units *units = NULL;
+  unsigned char *loaded = NULL;
+  int *order = NULL, *need = NULL;
+  int num_need = 0, num_order = 0, trips = 0, rounds = 0, i = 0, j = 0;
+  unsigned long bytes = 0, cost = 0;
+  double start = 0, elapsed = 0;
+
+  rmap = xtensa_load_config("xtensa_rmap", NULL);
+  if (rmap == NULL)
+  {
+    fprintf(stderr, "no xtensa_rmap\n");
+    return 1;
+  }
+  units = xtensa_reg_units_build(rmap);
+  if (units == NULL)
+  {
+    abort();
+  }
+  loaded = calloc(units->num_units, 1);
+  order = calloc(units->num_units, sizeof(int));
+  need = calloc(units->num_regs, sizeof(int));
+
+  // Every register at every stop, as without units
+  for (i = 0; i < units->num_regs; i++)
+  {
+    need[i] = i;
+  }
+  cost = plan_cost(rmap, need, units->num_regs, &trips, &bytes);
+  printf("regunits %s: all registers: %d trips, %lu bytes, %.1f ms\n", chip, trips, bytes, cost / 1000.0);
+
+  // The eager units only
+  num_order = xtensa_reg_units_fault(units, -1, loaded, order);
+  for (i = 0; i < num_order; i++)
+  {
+    const struct xtensa_reg_unit *unit = &units->units[order[i]];
+
+    for (j = 0; j < unit->num_regs; j++)
+    {
+      need[num_need++] = unit->regs[j];
+    }
+  }
+  cost = plan_cost(rmap, need, num_need, &trips, &bytes);
+  printf("regunits %s: %d of %d units eager: %d trips, %lu bytes, %.1f ms\n", chip, num_order,
+         units->num_units, trips, bytes, cost / 1000.0);
+
+  // Host cost of the fault path at every stop
+  start = test_now();
+  for (rounds = 0; (elapsed = test_now() - start) < 0.2; rounds++)
+  {
+    memset(loaded, 0, units->num_units);
+    xtensa_reg_units_fault(units, -1, loaded, order);
+  }
+  printf("regunits %s: eager fault: %.0f ns\n", chip, elapsed / rounds * 1e9);
+
+  free(loaded);
+  free(order);
+  free(need);
+  xtensa_reg_units_free(units);
+  return 0;
+}
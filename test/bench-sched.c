@@ -0,0 +1,98 @@
+#include <stdlib.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/sched.h"
+#include "test.h"
+
+#define MAX_OPS 12
+// Iterations estimated back to back, so that a unit still busy from the
+// previous iteration delays the next
+#define UNROLL 8
+
+// Inner loops of common firmware kernels as GCC emits them for Xtensa,
+// with a zero-overhead loop instruction where the chip has one; opcodes
+// the chip lacks are left out
+static const struct
+{
+  const char *name;
+  const char *ops[MAX_OPS];
+} s_loops[] =
+{
+  { "word copy", { "l32i.n", "l32i.n", "addi", "s32i.n", "s32i.n", "addi", NULL } },
+  { "dot product", { "l32i", "l32i", "addi.n", "addi.n", "mull", "add.n", NULL } },
+  { "byte checksum", { "l8ui", "addi.n", "add.n", "extui", NULL } },
+  { "16-bit MAC", { "l16si", "l16si", "addi.n", "addi.n", "mul16s", "add.n", NULL } },
+  { "float scale", { "lsi", "mul.s", "ssi", "addi.n", "addi.n", NULL } },
+  { "strlen", { "l8ui", "addi.n", "beqz", NULL } },
+};
+
+#define NUM_LOOPS (int) (sizeof(s_loops) / sizeof(s_loops[0]))
+
+// The body of LOOP in OPCS, unrolled; returns its opcodes per iteration
+static int loop_body(const struct xtensa_sched_model *model, int loop, xtensa_opcode *opcs, int *num_named)
+{
+  int n = 0, i = 0, j = 0;
+
+  *num_named = 0;
+  for (i = 0; s_loops[loop].ops[i] != NULL; i++, (*num_named)++)
+  {
+    xtensa_opcode opc = xtensa_sched_lookup(model, s_loops[loop].ops[i]);
+
+    if (opc != XTENSA_UNDEFINED)
+    {
+      opcs[n++] = opc;
+    }
+  }
+  for (j = 1; j < UNROLL; j++)
+  {
+    for (i = 0; i < n; i++)
+    {
+      opcs[j * n + i] = opcs[i];
+    }
+  }
+  return n;
+}
+
+// Estimated cycles are what the model predicts from issue width and
+// functional-unit hazards, not a measurement on the chip
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  const struct xtensa_sched_tables *tables = NULL;
+  struct xtensa_sched_model *model = NULL;
+  xtensa_opcode opcs[MAX_OPS * UNROLL];
+  int loop = 0, n = 0, num_named = 0, cycles = 0;
+  long rounds = 0;
+  double start = 0, elapsed = 0;
+
+  tables = xtensa_config_table("xtensa_sched_tables_data");
+  if (tables == NULL || (model = xtensa_sched_model_init(tables)) == NULL)
+  {
+    fprintf(stderr, "no scheduling tables\n");
+    return 1;
+  }
+
+  for (loop = 0; loop < NUM_LOOPS; loop++)
+  {
+    n = loop_body(model, loop, opcs, &num_named);
+    if (n == 0)
+    {
+      printf("sched %s: %s: no opcode of the loop\n", chip, s_loops[loop].name);
+      continue;
+    }
+    cycles = xtensa_sched_estimate_cycles(model, opcs, n * UNROLL);
+    printf("sched %s: %s, %d of %d ops: %.2f cycles per iteration estimated, %d issued one per cycle\n", chip,
+           s_loops[loop].name, n, num_named, (double) cycles / UNROLL, n);
+
+    start = test_now();
+    for (rounds = 0; (elapsed = test_now() - start) < 0.05; rounds++)
+    {
+      xtensa_sched_estimate_cycles(model, opcs, n * UNROLL);
+    }
+    printf("sched %s: %s, estimate of %d iterations: %.0f ns\n", chip, s_loops[loop].name, UNROLL,
+           elapsed / rounds * 1e9);
+  }
+
+  xtensa_sched_model_free(model);
+  return 0;
+}
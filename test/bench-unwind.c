@@ -0,0 +1,43 @@
+#include <stdlib.h>
+
+#include "xtensaconfig/unwind.h"
+#include "winstack.h"
+#include "test.h"
+
+#define NUM_FRAMES 1000
+// A debug probe round trip, charged per memory read
+#define READ_LATENCY_US 20.0
+
+static void bench(int num_aregs, int max_live)
+{
+  static struct xtensa_unwind_frame frames[NUM_FRAMES];
+  struct test_winstack stack;
+  unsigned int seed = 1;
+  double start = 0, elapsed = 0;
+  long rounds = 0, reads = 0;
+  int n = 0;
+
+  if (test_winstack_build(&stack, num_aregs, NUM_FRAMES, max_live, 0, &seed) != 0)
+  {
+    abort();
+  }
+  n = xtensa_unwind_windowed(&stack.gregs, num_aregs, &stack.target, frames, NUM_FRAMES);
+  reads = stack.reads;
+  start = test_now();
+  for (rounds = 0; (elapsed = test_now() - start) < 0.2; rounds++)
+  {
+    xtensa_unwind_windowed(&stack.gregs, num_aregs, &stack.target, frames, NUM_FRAMES);
+  }
+  printf("unwind %d aregs, %d live: %d frames, %ld reads, %.1f us cpu, %.1f ms bt at %.0f us per read\n", num_aregs,
+         stack.num_live, n, reads, elapsed / rounds * 1e6, (elapsed / rounds + reads * READ_LATENCY_US * 1e-6) * 1e3,
+         READ_LATENCY_US);
+  test_winstack_free(&stack);
+}
+
+int main(void)
+{
+  bench(16, 3);
+  bench(32, 7);
+  bench(64, 7);
+  return 0;
+}
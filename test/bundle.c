@@ -0,0 +1,257 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/bundle.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/resources.h"
+#include "test.h"
+
+// All triples are packed when there are at most this many of them
+#define MAX_TRIPLES (1 << 21)
+
+static xtensa_isa_internal *s_isa;
+// Formats by length, slot count and number, as the packer must try them
+static xtensa_format *s_order;
+static int s_num_stages;
+static int *s_uses;
+
+static int slot_accepts(xtensa_format fmt, int slot, xtensa_opcode opc)
+{
+  return s_isa->opcodes[opc].encode_fns[s_isa->formats[fmt].slot_id[slot]] != NULL;
+}
+
+static xtensa_opcode slot_nop(xtensa_format fmt, int slot)
+{
+  const char *name = s_isa->slots[s_isa->formats[fmt].slot_id[slot]].nop_name;
+  int opc = 0;
+
+  for (opc = 0; name != NULL && opc < s_isa->num_opcodes; opc++)
+  {
+    if (strcasecmp(s_isa->opcodes[opc].name, name) == 0)
+    {
+      return opc;
+    }
+  }
+  return XTENSA_UNDEFINED;
+}
+
+// Every functional unit use counted against the copies of the unit
+static int ref_conflict(const xtensa_opcode *opcs, int n)
+{
+  int i = 0, u = 0;
+
+  memset(s_uses, 0, sizeof(int) * s_isa->num_funcUnits * s_num_stages);
+  for (i = 0; i < n; i++)
+  {
+    for (u = 0; u < s_isa->opcodes[opcs[i]].num_funcUnit_uses; u++)
+    {
+      xtensa_funcUnit_use *use = &s_isa->opcodes[opcs[i]].funcUnit_uses[u];
+
+      if (++s_uses[use->unit * s_num_stages + use->stage] > s_isa->funcUnits[use->unit].num_copies)
+      {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// Try every placement of operations I.. into the free slots of FMT
+static int ref_place(xtensa_format fmt, const xtensa_opcode *opcs, int n, int i, int *taken)
+{
+  int slot = 0;
+
+  if (i == n)
+  {
+    for (slot = 0; slot < s_isa->formats[fmt].num_slots; slot++)
+    {
+      if (!taken[slot] && slot_nop(fmt, slot) == XTENSA_UNDEFINED)
+      {
+        return 0;
+      }
+    }
+    return 1;
+  }
+  for (slot = 0; slot < s_isa->formats[fmt].num_slots; slot++)
+  {
+    if (!taken[slot] && slot_accepts(fmt, slot, opcs[i]))
+    {
+      int found = 0;
+
+      taken[slot] = 1;
+      found = ref_place(fmt, opcs, n, i + 1, taken);
+      taken[slot] = 0;
+      if (found)
+      {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static xtensa_format ref_pack(const xtensa_opcode *opcs, int n)
+{
+  int taken[XTENSA_BUNDLE_MAX_SLOTS];
+  int k = 0;
+
+  if (n > 1 && ref_conflict(opcs, n))
+  {
+    return XTENSA_UNDEFINED;
+  }
+  for (k = 0; k < s_isa->num_formats; k++)
+  {
+    xtensa_format fmt = s_order[k];
+
+    if (s_isa->formats[fmt].num_slots < n || s_isa->formats[fmt].num_slots > XTENSA_BUNDLE_MAX_SLOTS)
+    {
+      continue;
+    }
+    memset(taken, 0, sizeof(taken));
+    if (ref_place(fmt, opcs, n, 0, taken))
+    {
+      return fmt;
+    }
+  }
+  return XTENSA_UNDEFINED;
+}
+
+// The packer agrees with the reference and its bundle is well formed
+static void check_pack(struct xtensa_bundler *b, const xtensa_opcode *opcs, int n)
+{
+  struct xtensa_bundle bundle;
+  xtensa_format fmt = ref_pack(opcs, n);
+  int placed[XTENSA_BUNDLE_MAX_SLOTS];
+  int slot = 0, i = 0;
+
+  if (xtensa_bundler_pack(b, opcs, n, &bundle) != 0)
+  {
+    CHECK(fmt == XTENSA_UNDEFINED);
+    return;
+  }
+  CHECK(bundle.format == fmt);
+  if (bundle.format != fmt)
+  {
+    return;
+  }
+  CHECK(bundle.num_slots == s_isa->formats[fmt].num_slots);
+  memset(placed, 0, sizeof(placed));
+  for (slot = 0; slot < bundle.num_slots; slot++)
+  {
+    i = bundle.op_index[slot];
+    if (i < 0)
+    {
+      CHECK(bundle.opcodes[slot] == slot_nop(fmt, slot));
+      continue;
+    }
+    CHECK(i < n && bundle.opcodes[slot] == opcs[i]);
+    CHECK(slot_accepts(fmt, slot, bundle.opcodes[slot]));
+    placed[i]++;
+  }
+  for (i = 0; i < n; i++)
+  {
+    CHECK(placed[i] == 1);
+  }
+}
+
+static int format_before(xtensa_format a, xtensa_format b)
+{
+  if (s_isa->formats[a].length != s_isa->formats[b].length)
+  {
+    return s_isa->formats[a].length < s_isa->formats[b].length;
+  }
+  if (s_isa->formats[a].num_slots != s_isa->formats[b].num_slots)
+  {
+    return s_isa->formats[a].num_slots < s_isa->formats[b].num_slots;
+  }
+  return a < b;
+}
+
+int main(int argc, char **argv)
+{
+  struct xtensa_resources *res = NULL;
+  struct xtensa_bundler *b = NULL;
+  xtensa_opcode opcs[3];
+  int num_opcodes = 0, fmt = 0, other = 0, slot = 0, rank = 0;
+  long triples = 0;
+
+  test_chip(argc, argv);
+  s_isa = (xtensa_isa_internal *) xtensa_load_config("xtensa_modules", NULL);
+  num_opcodes = s_isa->num_opcodes;
+  res = xtensa_resources_init((xtensa_isa) s_isa);
+  b = res ? xtensa_bundler_init((xtensa_isa) s_isa, res) : NULL;
+  CHECK(b != NULL);
+  if (b == NULL)
+  {
+    return test_result("bundle");
+  }
+
+  s_num_stages = xtensa_resources_num_stages(res);
+  s_uses = calloc((size_t) s_isa->num_funcUnits * s_num_stages + 1, sizeof(int));
+  s_order = calloc(s_isa->num_formats, sizeof(xtensa_format));
+  for (fmt = 0; fmt < s_isa->num_formats; fmt++)
+  {
+    for (other = 0, rank = 0; other < s_isa->num_formats; other++)
+    {
+      rank += format_before(other, fmt);
+    }
+    s_order[rank] = fmt;
+  }
+
+  // The slot masks are the encode functions
+  for (opcs[0] = 0; opcs[0] < num_opcodes; opcs[0]++)
+  {
+    for (fmt = 0; fmt < s_isa->num_formats; fmt++)
+    {
+      uint32_t mask = 0;
+
+      for (slot = 0; slot < s_isa->formats[fmt].num_slots && slot < XTENSA_BUNDLE_MAX_SLOTS; slot++)
+      {
+        mask |= (uint32_t) slot_accepts(fmt, slot, opcs[0]) << slot;
+      }
+      if (s_isa->formats[fmt].num_slots > XTENSA_BUNDLE_MAX_SLOTS)
+      {
+        mask = 0;
+      }
+      CHECK(xtensa_bundler_slot_mask(b, opcs[0], fmt) == mask);
+    }
+  }
+
+  // Every single opcode and every ordered pair, and the triples if the
+  // ISA is small enough; stop at the first mismatch
+  for (opcs[0] = 0; opcs[0] < num_opcodes && !test_failures; opcs[0]++)
+  {
+    check_pack(b, opcs, 1);
+    for (opcs[1] = 0; opcs[1] < num_opcodes && !test_failures; opcs[1]++)
+    {
+      check_pack(b, opcs, 2);
+    }
+  }
+  triples = (long) num_opcodes * num_opcodes * num_opcodes;
+  for (opcs[0] = 0; triples <= MAX_TRIPLES && opcs[0] < num_opcodes && !test_failures; opcs[0]++)
+  {
+    for (opcs[1] = 0; opcs[1] < num_opcodes && !test_failures; opcs[1]++)
+    {
+      for (opcs[2] = 0; opcs[2] < num_opcodes && !test_failures; opcs[2]++)
+      {
+        check_pack(b, opcs, 3);
+      }
+    }
+  }
+
+  // Out of range opcodes and counts are refused
+  opcs[0] = num_opcodes;
+  CHECK(xtensa_bundler_pack(b, opcs, 1, NULL) == XTENSA_UNDEFINED);
+  CHECK(xtensa_bundler_pack(b, opcs, 0, NULL) == XTENSA_UNDEFINED);
+  CHECK(xtensa_bundler_pack(b, opcs, XTENSA_BUNDLE_MAX_SLOTS + 1, NULL) == XTENSA_UNDEFINED);
+
+  free(s_order);
+  free(s_uses);
+  xtensa_bundler_free(b);
+  xtensa_resources_free(res);
+  return test_result("bundle");
+}
@@ -0,0 +1,258 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensaconfig/decoder.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/unwind.h"
+#include "prologue.h"
+#include "test.h"
+
+#define NUM_PROLOGUES 2000
+#define NUM_RANDOM 20000
+#define NUM_FUNCTIONS 256
+// Functions this far apart, so no prologue read reaches the next one
+#define FUNCTION_SPACING 256
+#define CODE_BASE 0x40080000u
+#define NUM_LOOKUPS 20000
+
+static xtensa_isa s_isa;
+static struct test_prologue s_prologues[NUM_FUNCTIONS];
+static const unsigned char s_build_id[20] = {0x8f, 0x1c, 0x03, 0x5e, 0x77, 0xa2, 0x40, 0x19, 0xd3, 0x6b,
+                                             0x02, 0xe5, 0x91, 0x4c, 0xb8, 0x27, 0x3a, 0xf0, 0x65, 0xcd};
+
+static int frame_equal(const struct xtensa_call0_frame *a, const struct xtensa_call0_frame *b)
+{
+  return a->entry == b->entry && a->prologue_end == b->prologue_end && a->cfa_reg == b->cfa_reg
+         && a->cfa_offset == b->cfa_offset && a->frame_size == b->frame_size
+         && memcmp(a->saved, b->saved, sizeof(a->saved)) == 0;
+}
+
+static const struct xtensa_call0_frame *prologue_frame(const struct test_prologue *p)
+{
+  return &p->expected[p->num_insns];
+}
+
+// The analysis after every instruction, stopped at its start or within
+// it, and of the whole prologue up to its control transfer
+static void check_prologue(const unsigned char *code, size_t len, const struct test_prologue *p)
+{
+  struct xtensa_call0_frame frame;
+  int k = 0;
+
+  for (k = 0; k <= p->num_insns; k++)
+  {
+    CHECK(xtensa_call0_analyze(s_isa, code, len, p->entry, p->expected[k].prologue_end, &frame) == 0);
+    CHECK(frame_equal(&frame, &p->expected[k]));
+    if (k < p->num_insns && p->expected[k + 1].prologue_end - p->expected[k].prologue_end > 1)
+    {
+      CHECK(xtensa_call0_analyze(s_isa, code, len, p->entry, p->expected[k].prologue_end + 1, &frame) == 0);
+      CHECK(frame_equal(&frame, &p->expected[k + 1]));
+    }
+  }
+  CHECK(xtensa_call0_analyze(s_isa, code, len, p->entry, UINT32_MAX, &frame) == 0);
+  CHECK(frame_equal(&frame, prologue_frame(p)));
+}
+
+static void check_analyze(void)
+{
+  unsigned char code[XTENSA_CALL0_MAX_PROLOGUE], bytes[16];
+  struct xtensa_decoded_insn insn;
+  struct xtensa_call0_frame frame;
+  struct test_prologue p;
+  unsigned int seed = 1;
+  int i = 0, j = 0, built = 0, fp = 0;
+
+  for (i = 0; i < NUM_PROLOGUES; i++)
+  {
+    memset(code, 0, sizeof(code));
+    if (test_prologue_build(s_isa, code, sizeof(code), CODE_BASE + 4 * i, &seed, &p) != 0)
+    {
+      continue;
+    }
+    built++;
+    fp += prologue_frame(&p)->cfa_reg == 15;
+    check_prologue(code, p.size, &p);
+    check_prologue(code, sizeof(code), &p);
+  }
+  CHECK(built > NUM_PROLOGUES / 2 && fp > 0);
+
+  // Any bytes are analyzed within their length, and refused if the first
+  // instruction does not decode
+  for (i = 0; i < NUM_RANDOM; i++)
+  {
+    for (j = 0; j < (int) sizeof(bytes); j++)
+    {
+      seed = seed * 1103515245 + 12345;
+      bytes[j] = seed >> 16;
+    }
+    if (xtensa_call0_analyze(s_isa, bytes, sizeof(bytes), CODE_BASE, UINT32_MAX, &frame) != 0)
+    {
+      CHECK(xtensa_decode_insn(s_isa, bytes, sizeof(bytes), &insn) == XTENSA_UNDEFINED);
+      continue;
+    }
+    CHECK(frame.entry == CODE_BASE && frame.prologue_end <= CODE_BASE + sizeof(bytes));
+    CHECK(frame.cfa_reg == -1 || frame.cfa_reg == 1 || frame.cfa_reg == 15);
+  }
+  CHECK(xtensa_call0_analyze(s_isa, bytes, 0, CODE_BASE, UINT32_MAX, &frame) == 0);
+  CHECK(frame.prologue_end == CODE_BASE && frame.cfa_reg == 1 && frame.cfa_offset == 0);
+}
+
+static uint32_t function_entry(int f)
+{
+  return CODE_BASE + f * FUNCTION_SPACING;
+}
+
+// Look function F up; return the reads it took
+static long lookup(struct xtensa_call0_cache *cache, struct test_codemem *mem, const void *build_id, size_t len,
+                   int f)
+{
+  struct xtensa_call0_frame frame;
+  long reads = mem->reads;
+
+  CHECK(xtensa_call0_cache_lookup(cache, build_id, len, function_entry(f), &frame) == 0);
+  CHECK(frame_equal(&frame, prologue_frame(&s_prologues[f])));
+  return mem->reads - reads;
+}
+
+static void build_function(struct test_codemem *mem, int f, size_t max_size, unsigned int *seed)
+{
+  unsigned char *code = mem->mem + (function_entry(f) - mem->base);
+
+  do
+  {
+    memset(code, 0, FUNCTION_SPACING);
+  } while (test_prologue_build(s_isa, code, FUNCTION_SPACING, function_entry(f), seed, &s_prologues[f]) != 0
+           || s_prologues[f].size > max_size);
+}
+
+static void check_cache(void)
+{
+  struct xtensa_call0_cache *cache = NULL;
+  struct xtensa_call0_frame frame;
+  struct test_codemem mem;
+  unsigned char other_id[sizeof(s_build_id)], long_id[XTENSA_CALL0_MAX_BUILD_ID + 1];
+  uint32_t entry = 0;
+  unsigned int seed = 2;
+  long reads = 0;
+  int f = 0, i = 0, last = NUM_FUNCTIONS - 1;
+
+  if (test_codemem_init(&mem, CODE_BASE, NUM_FUNCTIONS * FUNCTION_SPACING) != 0)
+  {
+    abort();
+  }
+  for (f = 0; f < NUM_FUNCTIONS; f++)
+  {
+    build_function(&mem, f, f == last ? XTENSA_CALL0_MAX_PROLOGUE / 2 : FUNCTION_SPACING, &seed);
+  }
+
+  // One read per function, then none while they stay cached
+  cache = xtensa_call0_cache_new(s_isa, &mem.target, 16 * NUM_FUNCTIONS);
+  for (f = 0; f < NUM_FUNCTIONS; f++)
+  {
+    CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), f) == 1);
+  }
+  for (f = 0; f < NUM_FUNCTIONS; f++)
+  {
+    CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), f) == 0);
+  }
+
+  // Another image, or none, is another entry
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id) - 1, 0) == 1);
+  CHECK(lookup(cache, &mem, NULL, 0, 0) == 1);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 0) == 0);
+  CHECK(lookup(cache, &mem, NULL, 0, 0) == 0);
+
+  // Build ids are compared byte for byte, from the copy the cache keeps
+  memcpy(other_id, s_build_id, sizeof(s_build_id));
+  other_id[sizeof(s_build_id) - 1] ^= 1;
+  CHECK(lookup(cache, &mem, other_id, sizeof(s_build_id), 0) == 1);
+  CHECK(lookup(cache, &mem, other_id, sizeof(s_build_id), 0) == 0);
+  other_id[0] ^= 1;
+  CHECK(lookup(cache, &mem, other_id, sizeof(s_build_id), 0) == 1);
+  memcpy(other_id, s_build_id, sizeof(s_build_id));
+  CHECK(lookup(cache, &mem, other_id, sizeof(s_build_id), 0) == 0);
+
+  // Longer build ids than the cache keeps are analyzed every time
+  memset(long_id, 0x5a, sizeof(long_id));
+  CHECK(lookup(cache, &mem, long_id, sizeof(long_id), 0) == 1);
+  CHECK(lookup(cache, &mem, long_id, sizeof(long_id), 0) == 1);
+  CHECK(lookup(cache, &mem, long_id, XTENSA_CALL0_MAX_BUILD_ID, 0) == 1);
+  CHECK(lookup(cache, &mem, long_id, XTENSA_CALL0_MAX_BUILD_ID, 0) == 0);
+
+  // Writes drop the analyses that read the bytes, of every image
+  entry = function_entry(1);
+  xtensa_call0_cache_invalidate(cache, entry - 4, 4);
+  xtensa_call0_cache_invalidate(cache, entry + XTENSA_CALL0_MAX_PROLOGUE, 4);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 1) == 0);
+  xtensa_call0_cache_invalidate(cache, function_entry(0), 1);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 0) == 1);
+  CHECK(lookup(cache, &mem, NULL, 0, 0) == 1);
+  xtensa_call0_cache_invalidate(cache, entry + XTENSA_CALL0_MAX_PROLOGUE - 1, 1);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 1) == 1);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 2) == 0);
+
+  // New code is analyzed again once invalidated
+  build_function(&mem, 3, FUNCTION_SPACING, &seed);
+  xtensa_call0_cache_invalidate(cache, function_entry(3), FUNCTION_SPACING);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 3) == 1);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 4) == 0);
+  xtensa_call0_cache_invalidate(cache, 0, UINT32_MAX);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 4) == 1);
+  xtensa_call0_cache_free(cache);
+
+  // A function used between every other stays in a full set, and the
+  // others are evicted
+  cache = xtensa_call0_cache_new(s_isa, &mem.target, 1);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 0) == 1);
+  for (f = 1; f < NUM_FUNCTIONS; f++)
+  {
+    CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), f) == 1);
+    CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 0) == 0);
+  }
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), 1) == 1);
+  xtensa_call0_cache_free(cache);
+
+  // Random lookups through a small cache miss, but never give a stale
+  // or wrong analysis
+  cache = xtensa_call0_cache_new(s_isa, &mem.target, 64);
+  reads = mem.reads;
+  for (i = 0; i < NUM_LOOKUPS; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    f = (seed >> 16) % NUM_FUNCTIONS;
+    lookup(cache, &mem, s_build_id, sizeof(s_build_id), f);
+  }
+  CHECK(mem.reads - reads >= NUM_FUNCTIONS && mem.reads - reads < NUM_LOOKUPS);
+  xtensa_call0_cache_free(cache);
+
+  // Code at the end of memory is read in smaller pieces; failed reads
+  // are not cached
+  cache = xtensa_call0_cache_new(s_isa, &mem.target, 16);
+  mem.size = (NUM_FUNCTIONS - 1) * FUNCTION_SPACING + XTENSA_CALL0_MAX_PROLOGUE / 2;
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), last) == 2);
+  CHECK(lookup(cache, &mem, s_build_id, sizeof(s_build_id), last) == 0);
+  mem.size = (NUM_FUNCTIONS - 1) * FUNCTION_SPACING + 2;
+  xtensa_call0_cache_invalidate(cache, function_entry(last), 1);
+  for (i = 0; i < 2; i++)
+  {
+    reads = mem.reads;
+    CHECK(xtensa_call0_cache_lookup(cache, s_build_id, sizeof(s_build_id), function_entry(last), &frame) == -1);
+    CHECK(mem.reads - reads == 6);
+  }
+  CHECK(xtensa_call0_cache_lookup(cache, s_build_id, sizeof(s_build_id), CODE_BASE - 4, &frame) == -1);
+  xtensa_call0_cache_free(cache);
+
+  test_codemem_free(&mem);
+}
+
+int main(int argc, char **argv)
+{
+  test_chip(argc, argv);
+  s_isa = (xtensa_isa) xtensa_load_config("xtensa_modules", NULL);
+
+  check_analyze();
+  check_cache();
+  return test_result("call0");
+}
@@ -0,0 +1,134 @@
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/compat.h"
+#include "xtensaconfig/sched.h"
+#include "test.h"
+
+static const struct xtensa_sched_use s_uses[] = { { 0, 1 }, { 0, 2 }, { 1, 1 } };
+static const struct xtensa_sched_use s_later_uses[] = { { 0, 1 }, { 0, 3 }, { 1, 1 } };
+static const int s_unit_copies[] = { 1, 2 };
+static const struct xtensa_sched_opcode s_opcodes[] = { { "add", 0, s_uses }, { "mul", 2, s_uses },
+                                                        { "l32i", 1, &s_uses[2] } };
+static const struct xtensa_sched_opcode s_later_opcodes[] = { { "add", 0, s_later_uses },
+                                                              { "mul", 2, s_later_uses },
+                                                              { "l32i", 1, &s_later_uses[2] } };
+static const struct xtensa_sched_opcode s_renamed_opcodes[] = { { "add", 0, s_uses }, { "mull", 2, s_uses },
+                                                                { "l32i", 1, &s_uses[2] } };
+static const struct xtensa_sched_tables s_sched = { 2, 2, s_unit_copies, 3, s_opcodes };
+static const struct xtensa_sched_tables s_sched_copy = { 2, 2, s_unit_copies, 3, s_opcodes };
+static const struct xtensa_sched_tables s_sched_later = { 2, 2, s_unit_copies, 3, s_later_opcodes };
+static const struct xtensa_sched_tables s_sched_renamed = { 2, 2, s_unit_copies, 3, s_renamed_opcodes };
+static const struct xtensa_sched_tables s_sched_single = { 1, 2, s_unit_copies, 3, s_opcodes };
+
+static struct xtensa_config s_base;
+
+// FROM and TO compared both ways, with the same tables
+static void check_pair(const struct xtensa_config *from, const struct xtensa_config *to,
+                       enum xtensa_config_compat forward, enum xtensa_config_compat backward, const char *name)
+{
+  const char *field = "unset";
+
+  CHECK(xtensa_config_compare(from, NULL, to, NULL, &field) == forward);
+  CHECK(name ? field != NULL && strcmp(field, name) == 0 : field == NULL);
+  field = "unset";
+  CHECK(xtensa_config_compare(to, NULL, from, NULL, &field) == backward);
+  CHECK(name ? field != NULL && strcmp(field, name) == 0 : field == NULL);
+  CHECK(xtensa_config_compare(from, &s_sched, to, &s_sched, NULL) == forward);
+}
+
+static void check_fields(void)
+{
+  struct xtensa_config other = s_base;
+
+  check_pair(&s_base, &other, XTENSA_CONFIG_IDENTICAL, XTENSA_CONFIG_IDENTICAL, NULL);
+
+  // ABI fields must match either way
+  other.xshal_abi = !s_base.xshal_abi;
+  check_pair(&s_base, &other, XTENSA_CONFIG_INCOMPATIBLE, XTENSA_CONFIG_INCOMPATIBLE, "xshal_abi");
+  other = s_base;
+  other.xchal_have_be = !s_base.xchal_have_be;
+  check_pair(&s_base, &other, XTENSA_CONFIG_INCOMPATIBLE, XTENSA_CONFIG_INCOMPATIBLE, "xchal_have_be");
+
+  // Code without an option runs where it is present
+  other = s_base;
+  s_base.xchal_have_mul32 = 0;
+  other.xchal_have_mul32 = 1;
+  check_pair(&s_base, &other, XTENSA_CONFIG_COMPATIBLE, XTENSA_CONFIG_INCOMPATIBLE, "xchal_have_mul32");
+
+  // Tuning changes the code, not its validity
+  other = s_base;
+  other.xchal_icache_size = s_base.xchal_icache_size + 16384;
+  check_pair(&s_base, &other, XTENSA_CONFIG_COMPATIBLE, XTENSA_CONFIG_COMPATIBLE, "xchal_icache_size");
+  other = s_base;
+  other.xchal_icache_linesize = s_base.xchal_icache_linesize + 32;
+  check_pair(&s_base, &other, XTENSA_CONFIG_COMPATIBLE, XTENSA_CONFIG_COMPATIBLE, "xchal_icache_linesize");
+  other = s_base;
+  other.xchal_dcache_linesize = s_base.xchal_dcache_linesize + 32;
+  check_pair(&s_base, &other, XTENSA_CONFIG_COMPATIBLE, XTENSA_CONFIG_COMPATIBLE, "xchal_dcache_linesize");
+
+  // An invalid field wins over a tuning one before it
+  other.xthal_abi_call0 = s_base.xthal_abi_call0 + 1;
+  check_pair(&s_base, &other, XTENSA_CONFIG_INCOMPATIBLE, XTENSA_CONFIG_INCOMPATIBLE, "xthal_abi_call0");
+
+  // What user code does not see
+  other = s_base;
+  other.xchal_have_mmu = !s_base.xchal_have_mmu;
+  other.xchal_num_ibreak = s_base.xchal_num_ibreak + 1;
+  other.xchal_dcache_is_writeback = !s_base.xchal_dcache_is_writeback;
+  check_pair(&s_base, &other, XTENSA_CONFIG_IDENTICAL, XTENSA_CONFIG_IDENTICAL, NULL);
+}
+
+static void check_sched(void)
+{
+  struct xtensa_config other = s_base;
+  const char *field = NULL;
+
+  CHECK(xtensa_config_compare(&s_base, &s_sched, &other, &s_sched_copy, &field) == XTENSA_CONFIG_IDENTICAL);
+  CHECK(field == NULL);
+  CHECK(xtensa_config_compare(&s_base, &s_sched, &other, &s_sched_later, &field) == XTENSA_CONFIG_COMPATIBLE);
+  CHECK(field != NULL && strcmp(field, "xtensa_sched_tables_data") == 0);
+  CHECK(xtensa_config_compare(&s_base, &s_sched, &other, &s_sched_renamed, NULL) == XTENSA_CONFIG_COMPATIBLE);
+  CHECK(xtensa_config_compare(&s_base, &s_sched, &other, &s_sched_single, NULL) == XTENSA_CONFIG_COMPATIBLE);
+  CHECK(xtensa_config_compare(&s_base, &s_sched, &other, NULL, NULL) == XTENSA_CONFIG_COMPATIBLE);
+  CHECK(xtensa_config_compare(&s_base, NULL, &other, &s_sched, NULL) == XTENSA_CONFIG_COMPATIBLE);
+
+  // A field names the first difference before the tables do
+  other.xchal_inst_fetch_width = s_base.xchal_inst_fetch_width * 2;
+  CHECK(xtensa_config_compare(&s_base, &s_sched, &other, &s_sched_later, &field) == XTENSA_CONFIG_COMPATIBLE);
+  CHECK(field != NULL && strcmp(field, "xchal_inst_fetch_width") == 0);
+  other.xshal_abi = !s_base.xshal_abi;
+  CHECK(xtensa_config_compare(&s_base, &s_sched, &other, &s_sched_copy, NULL) == XTENSA_CONFIG_INCOMPATIBLE);
+}
+
+static void check_classes(void)
+{
+  struct xtensa_config tuned = s_base, abi = s_base;
+  const struct xtensa_config *configs[] = { &s_base, &tuned, &s_base, &abi, &s_base, &tuned };
+  const struct xtensa_sched_tables *scheds[] = { &s_sched, &s_sched, &s_sched_copy, &s_sched, &s_sched_later,
+                                                 &s_sched };
+  int ids[6], i = 0;
+
+  tuned.xchal_dcache_size = s_base.xchal_dcache_size + 1024;
+  abi.xthal_abi_windowed = !s_base.xthal_abi_windowed;
+
+  CHECK(xtensa_config_classes(configs, scheds, 6, ids) == 4);
+  CHECK(ids[0] == 0 && ids[1] == 1 && ids[2] == 0 && ids[3] == 2 && ids[4] == 3 && ids[5] == 1);
+  CHECK(xtensa_config_classes(configs, NULL, 6, ids) == 3);
+  CHECK(ids[0] == 0 && ids[1] == 1 && ids[2] == 0 && ids[3] == 2 && ids[4] == 0 && ids[5] == 1);
+  for (i = 0; i < 6; i++)
+  {
+    ids[i] = -1;
+  }
+  CHECK(xtensa_config_classes(configs, scheds, 0, ids) == 0 && ids[0] == -1);
+}
+
+int main(void)
+{
+  s_base = *xtensa_get_config(-1);
+
+  check_fields();
+  check_sched();
+  check_classes();
+  return test_result("compat");
+}
@@ -0,0 +1,45 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/fingerprint.h"
+#include "test.h"
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  struct xtensa_config config;
+  struct xtensa_fingerprint fp, carried;
+  unsigned char *blob = NULL;
+  size_t size = xtensa_config_serialize(NULL, 0);
+
+  blob = malloc(size);
+  CHECK(xtensa_config_serialize(blob, size) == size);
+  config = *xtensa_get_config(-1);
+  fp = *xtensa_config_fingerprint();
+
+  CHECK(xtensa_config_blob_fingerprint(blob, size, &carried));
+  CHECK(memcmp(carried.bytes, fp.bytes, sizeof(fp.bytes)) == 0);
+  CHECK(!xtensa_config_blob_fingerprint(blob, size - 1, &carried));
+
+  // The blob installs the values and the fingerprint of the chip
+  xtensa_reset_config();
+  CHECK(xtensa_config_deserialize(blob, size) == size);
+  CHECK(memcmp(&xtensa_get_config(-1)->xchal_have_be, &config.xchal_have_be,
+               sizeof(config) - offsetof(struct xtensa_config, xchal_have_be)) == 0);
+  CHECK(memcmp(xtensa_config_fingerprint()->bytes, fp.bytes, sizeof(fp.bytes)) == 0);
+
+  // Truncated, from another version, or for another option
+  CHECK(xtensa_config_deserialize(blob, size - 1) == 0);
+  blob[4] ^= 0x80;
+  CHECK(xtensa_config_deserialize(blob, size) == 0);
+  blob[4] ^= 0x80;
+  xtensaconfig_string = "another-chip";
+  CHECK(xtensa_config_deserialize(blob, size) == 0);
+  xtensaconfig_string = chip;
+
+  free(blob);
+  return test_result("configblob");
+}
@@ -0,0 +1,217 @@
+#include <errno.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "arch/xtensa.h"
+#include "xtensaconfig/coredump.h"
+#include "xtensaconfig/dynconfig.h"
+#include "corefile.h"
+#include "test.h"
+
+// More than one worker's share of threads
+#define NUM_THREADS 300
+#define FILL 0xa5
+
+static const struct xtensa_gpacket_layout *s_layout;
+static const struct xtensa_regindex *s_index;
+static size_t s_stride;
+
+static const struct
+{
+  const char *name;
+  unsigned int word;
+} s_special[] =
+{
+  { "pc", offsetof(xtensa_elf_gregset_t, pc) / 4 },
+  { "ps", offsetof(xtensa_elf_gregset_t, ps) / 4 },
+  { "lbeg", offsetof(xtensa_elf_gregset_t, lbeg) / 4 },
+  { "lend", offsetof(xtensa_elf_gregset_t, lend) / 4 },
+  { "lcount", offsetof(xtensa_elf_gregset_t, lcount) / 4 },
+  { "sar", offsetof(xtensa_elf_gregset_t, sar) / 4 },
+  { "windowstart", offsetof(xtensa_elf_gregset_t, windowstart) / 4 },
+  { "windowbase", offsetof(xtensa_elf_gregset_t, windowbase) / 4 },
+  { "threadptr", offsetof(xtensa_elf_gregset_t, threadptr) / 4 },
+};
+
+// The image offset of word register NAME, or -1 if the core does not
+// fill it
+static long reg_image(const char *name)
+{
+  int reg = xtensa_regindex_find_name(s_index, name);
+
+  if (reg < 0 || reg >= s_layout->num_regs || s_layout->regs[reg].length != 4)
+  {
+    return -1;
+  }
+  return s_layout->regs[reg].image;
+}
+
+static int image_word(const unsigned char *image, long offset, uint32_t expected)
+{
+  uint32_t v = 0;
+
+  memcpy(&v, image + offset, sizeof(v));
+  return v == expected;
+}
+
+// Every register the gregset carries is in the image of thread T, the
+// other bytes are as they were
+static void check_image(const unsigned char *image, int t)
+{
+  unsigned char *filled = calloc(s_layout->image_size, 1);
+  char name[8];
+  int num_aregs = 0, windowed = 0, i = 0;
+  uint32_t windowbase = test_core_greg(t, offsetof(xtensa_elf_gregset_t, windowbase) / 4);
+  unsigned int b = 0;
+  long offset = 0;
+
+  for (i = 0; i < (int) (sizeof(s_special) / sizeof(s_special[0])); i++)
+  {
+    if ((offset = reg_image(s_special[i].name)) >= 0)
+    {
+      CHECK(image_word(image, offset, test_core_greg(t, s_special[i].word)));
+      memset(filled + offset, 1, 4);
+    }
+  }
+  for (num_aregs = 0; num_aregs < 64; num_aregs++)
+  {
+    snprintf(name, sizeof(name), "ar%d", num_aregs);
+    if (xtensa_regindex_find_name(s_index, name) < 0)
+    {
+      break;
+    }
+    if ((offset = reg_image(name)) >= 0)
+    {
+      CHECK(image_word(image, offset, test_core_greg(t, offsetof(xtensa_elf_gregset_t, ar) / 4 + num_aregs)));
+      memset(filled + offset, 1, 4);
+    }
+  }
+  windowed = num_aregs >= 16;
+  for (i = 0; i < 16 && windowed; i++)
+  {
+    snprintf(name, sizeof(name), "a%d", i);
+    windowed = reg_image(name) >= 0;
+  }
+  for (i = 0; i < 16 && windowed; i++)
+  {
+    snprintf(name, sizeof(name), "a%d", i);
+    offset = reg_image(name);
+    CHECK(image_word(image, offset,
+                     test_core_greg(t, offsetof(xtensa_elf_gregset_t, ar) / 4 + (windowbase * 4 + i) % num_aregs)));
+    memset(filled + offset, 1, 4);
+  }
+  for (b = 0; b < s_layout->image_size; b++)
+  {
+    CHECK(filled[b] || image[b] == FILL);
+  }
+  free(filled);
+}
+
+static unsigned char *decode(const struct xtensa_core *core, int num_workers)
+{
+  unsigned char *images = aligned_alloc(s_layout->image_align, s_stride * (core->num_threads + 1));
+
+  if (images == NULL)
+  {
+    abort();
+  }
+  memset(images, FILL, s_stride * (core->num_threads + 1));
+  CHECK(xtensa_core_decode(core, s_layout, s_index, images, s_stride, num_workers) == 0);
+  return images;
+}
+
+static void check_core(int big_endian)
+{
+  char path[PATH_MAX];
+  size_t size = 0;
+  unsigned char *data = test_core_build(NUM_THREADS, big_endian, &size);
+  unsigned char *images = NULL, *other = NULL;
+  struct xtensa_core *core = NULL;
+  int t = 0, workers = 0;
+
+  CHECK(data != NULL && test_core_write(data, size, path, sizeof(path)) == 0);
+  core = xtensa_core_open(path);
+  CHECK(core != NULL);
+  if (core == NULL)
+  {
+    free(data);
+    return;
+  }
+  CHECK(core->big_endian == big_endian);
+  CHECK(core->size == size);
+  CHECK(core->num_threads == NUM_THREADS);
+  for (t = 0; t < core->num_threads; t++)
+  {
+    CHECK(core->threads[t].pid == test_core_pid(t));
+  }
+
+  // Any number of workers decodes the same images
+  images = decode(core, 1);
+  for (t = 0; t < core->num_threads; t++)
+  {
+    check_image(images + t * s_stride, t);
+  }
+  for (workers = 0; workers <= 4; workers += 2)
+  {
+    other = decode(core, workers);
+    CHECK(memcmp(other, images, s_stride * (core->num_threads + 1)) == 0);
+    free(other);
+  }
+  free(images);
+  xtensa_core_close(core);
+
+  // A truncated core gives the whole notes before the cut
+  CHECK(truncate(path, size / 3) == 0);
+  core = xtensa_core_open(path);
+  CHECK(core != NULL && core->num_threads > 0 && core->num_threads < NUM_THREADS / 2);
+  for (t = 0; core != NULL && t < core->num_threads; t++)
+  {
+    CHECK(core->threads[t].pid == test_core_pid(t));
+    CHECK(core->threads[t].gregs + XTENSA_ELF_NGREG * 4 <= core->data + core->size);
+  }
+  xtensa_core_close(core);
+
+  unlink(path);
+  free(data);
+}
+
+int main(int argc, char **argv)
+{
+  char path[PATH_MAX];
+  size_t size = 0;
+  unsigned char *data = NULL;
+
+  test_chip(argc, argv);
+  s_layout = xtensa_config_gpacket();
+  s_index = xtensa_config_regindex();
+  CHECK(s_layout != NULL && s_index != NULL);
+  if (s_layout == NULL || s_index == NULL)
+  {
+    return test_result("coredump");
+  }
+  s_stride = (s_layout->image_size + s_layout->image_align - 1) / s_layout->image_align * s_layout->image_align;
+
+  check_core(0);
+  check_core(1);
+
+  // Files that are not Xtensa cores are refused
+  errno = 0;
+  CHECK(xtensa_core_open("/nonexistent/core") == NULL && errno == ENOENT);
+  data = test_core_build(1, 0, &size);
+  data[18] = 3;
+  CHECK(test_core_write(data, size, path, sizeof(path)) == 0);
+  errno = 0;
+  CHECK(xtensa_core_open(path) == NULL && errno == EINVAL);
+  unlink(path);
+  CHECK(test_core_write(data, 0, path, sizeof(path)) == 0);
+  errno = 0;
+  CHECK(xtensa_core_open(path) == NULL && errno == EINVAL);
+  unlink(path);
+  free(data);
+
+  return test_result("coredump");
+}
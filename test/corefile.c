@@ -0,0 +1,151 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "arch/xtensa.h"
+#include "corefile.h"
+
+#define EHDR_SIZE 52
+#define PHDR_SIZE 32
+#define NUM_PHDRS 3
+#define NOTE_NAME "CORE"
+#define NOTE_NAME_SPACE 8
+// struct elf_prstatus of a 32-bit target: pr_pid at 24, pr_reg at 72
+// and pr_fpvalid after it
+#define PRSTATUS_SIZE (72 + XTENSA_ELF_NGREG * 4 + 4)
+#define PRPSINFO_SIZE 124
+// Every this many threads a NT_PRPSINFO note comes between them
+#define OTHER_NOTE_EVERY 7
+
+static void put(unsigned char *p, uint32_t v, int size, int big_endian)
+{
+  int i = 0;
+
+  for (i = 0; i < size; i++)
+  {
+    p[big_endian ? size - 1 - i : i] = v >> (8 * i);
+  }
+}
+
+uint32_t test_core_greg(int thread, int word)
+{
+  if (word == offsetof(xtensa_elf_gregset_t, windowbase) / 4)
+  {
+    return (thread * 5 + 3) % 16;
+  }
+  return ((uint32_t) thread * 0x9e3779b1u) ^ ((uint32_t) word * 0x85ebca6bu) ^ 0x01020304u;
+}
+
+unsigned int test_core_pid(int thread)
+{
+  return 0x3ffb0000u + thread * 0x160;
+}
+
+static unsigned char *put_note(unsigned char *p, uint32_t type, uint32_t descsz, int big_endian)
+{
+  put(p, sizeof(NOTE_NAME), 4, big_endian);
+  put(p + 4, descsz, 4, big_endian);
+  put(p + 8, type, 4, big_endian);
+  memcpy(p + 12, NOTE_NAME, sizeof(NOTE_NAME));
+  return p + 12 + NOTE_NAME_SPACE;
+}
+
+// The notes of threads FIRST.. until COUNT, or their size if P is null
+static size_t put_notes(unsigned char *p, int first, int count, int big_endian)
+{
+  size_t size = 0;
+  int t = 0, w = 0;
+
+  for (t = first; t < first + count; t++)
+  {
+    if (t % OTHER_NOTE_EVERY == 0)
+    {
+      if (p != NULL)
+      {
+        memset(put_note(p + size, 3, PRPSINFO_SIZE, big_endian), 0, PRPSINFO_SIZE);
+      }
+      size += 12 + NOTE_NAME_SPACE + PRPSINFO_SIZE;
+    }
+    if (p != NULL)
+    {
+      unsigned char *desc = put_note(p + size, 1, PRSTATUS_SIZE, big_endian);
+
+      memset(desc, 0, PRSTATUS_SIZE);
+      put(desc + 24, test_core_pid(t), 4, big_endian);
+      for (w = 0; w < (int) XTENSA_ELF_NGREG; w++)
+      {
+        put(desc + 72 + w * 4, test_core_greg(t, w), 4, big_endian);
+      }
+    }
+    size += 12 + NOTE_NAME_SPACE + PRSTATUS_SIZE;
+  }
+  return size;
+}
+
+static void put_phdr(unsigned char *ph, uint32_t type, uint32_t offset, uint32_t size, int big_endian)
+{
+  memset(ph, 0, PHDR_SIZE);
+  put(ph, type, 4, big_endian);
+  put(ph + 4, offset, 4, big_endian);
+  put(ph + 16, size, 4, big_endian);
+  put(ph + 20, size, 4, big_endian);
+}
+
+unsigned char *test_core_build(int num_threads, int big_endian, size_t *size)
+{
+  int half = num_threads / 2;
+  size_t notes1 = put_notes(NULL, 0, half, big_endian);
+  size_t notes2 = put_notes(NULL, half, num_threads - half, big_endian);
+  size_t offset = EHDR_SIZE + NUM_PHDRS * PHDR_SIZE;
+  unsigned char *data = NULL;
+
+  *size = offset + notes1 + 64 + notes2;
+  data = calloc(*size, 1);
+  if (data == NULL)
+  {
+    return NULL;
+  }
+  memcpy(data, "\177ELF", 4);
+  data[4] = 1;
+  data[5] = big_endian ? 2 : 1;
+  data[6] = 1;
+  put(data + 16, 4, 2, big_endian);
+  put(data + 18, 94, 2, big_endian);
+  put(data + 20, 1, 4, big_endian);
+  put(data + 28, EHDR_SIZE, 4, big_endian);
+  put(data + 40, EHDR_SIZE, 2, big_endian);
+  put(data + 42, PHDR_SIZE, 2, big_endian);
+  put(data + 44, NUM_PHDRS, 2, big_endian);
+
+  // Notes, 64 bytes of a loadable segment, more notes
+  put_phdr(data + EHDR_SIZE, 4, offset, notes1, big_endian);
+  put_phdr(data + EHDR_SIZE + PHDR_SIZE, 1, offset + notes1, 64, big_endian);
+  put_phdr(data + EHDR_SIZE + 2 * PHDR_SIZE, 4, offset + notes1 + 64, notes2, big_endian);
+  put_notes(data + offset, 0, half, big_endian);
+  memset(data + offset + notes1, 0xee, 64);
+  put_notes(data + offset + notes1 + 64, half, num_threads - half, big_endian);
+  return data;
+}
+
+int test_core_write(const unsigned char *data, size_t size, char *path, size_t path_size)
+{
+  const char *dir = getenv("TMPDIR");
+  FILE *f = NULL;
+  int fd = -1, ok = 0;
+
+  snprintf(path, path_size, "%s/xtensaconfig-core-XXXXXX", dir ? dir : "/tmp");
+  fd = mkstemp(path);
+  if (fd < 0 || (f = fdopen(fd, "wb")) == NULL)
+  {
+    if (fd >= 0)
+    {
+      close(fd);
+    }
+    return -1;
+  }
+  ok = fwrite(data, 1, size, f) == size;
+  return fclose(f) == 0 && ok ? 0 : -1;
+}
@@ -0,0 +1,38 @@
+/* Synthetic Xtensa ELF core dumps, for tests.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_TEST_COREFILE_H
+#define XTENSA_CONFIG_TEST_COREFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* A core as ESP-IDF writes it: NUM_THREADS NT_PRSTATUS notes split over
+   two note segments, with other notes in between.  Word W of the
+   gregset of thread T is test_core_greg (T, W), windowbase below 16,
+   and its pr_pid test_core_pid (T).  Returns a malloc'ed buffer of
+   *SIZE bytes.  */
+unsigned char *test_core_build (int num_threads, int big_endian, size_t *size);
+
+uint32_t test_core_greg (int thread, int word);
+unsigned int test_core_pid (int thread);
+
+/* Write the SIZE bytes of DATA to a new temporary file, whose name is
+   put in PATH of PATH_SIZE bytes; return 0 or -1.  */
+int test_core_write (const unsigned char *data, size_t size, char *path, size_t path_size);
+
+#endif /* !XTENSA_CONFIG_TEST_COREFILE_H */
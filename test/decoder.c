@@ -0,0 +1,128 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/decoder.h"
+#include "xtensaconfig/dynconfig.h"
+#include "test.h"
+
+#define NUM_INSNS 200000
+#define INSN_BYTES 32
+#define NUM_THREADS 4
+
+static xtensa_isa s_isa;
+// The same tables at another address, which the generic decoder handles
+static struct xtensa_isa_internal_struct s_copy;
+static unsigned char s_bytes[NUM_INSNS][INSN_BYTES];
+static struct xtensa_decoded_insn s_expected[NUM_INSNS];
+static int s_lengths[NUM_INSNS];
+
+static int decoded_equal(const struct xtensa_decoded_insn *a, const struct xtensa_decoded_insn *b)
+{
+  return a->format == b->format && a->length == b->length && a->num_slots == b->num_slots
+         && memcmp(a->slots, b->slots, sizeof(a->slots[0]) * a->num_slots) == 0;
+}
+
+// Every thread decodes all instructions with the generic decoder at once
+static void *decode_thread(void *arg)
+{
+  struct xtensa_decoded_insn insn;
+  long mismatches = 0;
+  int i = 0;
+
+  for (i = 0; i < NUM_INSNS; i++)
+  {
+    memset(&insn, 0, sizeof(insn));
+    if (xtensa_decode_insn((xtensa_isa) &s_copy, s_bytes[i], INSN_BYTES, &insn) != s_lengths[i]
+        || (s_lengths[i] > 0 && !decoded_equal(&insn, &s_expected[i])))
+    {
+      mismatches++;
+    }
+  }
+  *(long *) arg = mismatches;
+  return NULL;
+}
+
+int main(int argc, char **argv)
+{
+  const struct xtensa_decoder_ops *chip_ops = NULL, *generic_ops = NULL;
+  struct xtensa_decoded_insn insn, again;
+  unsigned char encoded[INSN_BYTES], generic_encoded[INSN_BYTES];
+  pthread_t threads[NUM_THREADS];
+  long mismatches[NUM_THREADS];
+  unsigned int seed = 1;
+  int i = 0, j = 0, valid = 0, length = 0;
+
+  test_chip(argc, argv);
+  s_isa = (xtensa_isa) xtensa_load_config("xtensa_modules", NULL);
+  memcpy(&s_copy, s_isa, sizeof(s_copy));
+
+  // The specialized decoder goes with the chip's ISA only, whichever ISA
+  // was selected before
+  chip_ops = xtensa_decoder_select(s_isa);
+  generic_ops = xtensa_decoder_select((xtensa_isa) &s_copy);
+  CHECK(xtensa_decoder_select(s_isa) == chip_ops);
+  CHECK(xtensa_decoder_select((xtensa_isa) &s_copy) == generic_ops);
+  CHECK((chip_ops != generic_ops) == (xtensa_find_config("xtensa_decoder_ops", NULL) != NULL));
+
+  for (i = 0; i < NUM_INSNS; i++)
+  {
+    for (j = 0; j < INSN_BYTES; j++)
+    {
+      seed = seed * 1103515245 + 12345;
+      s_bytes[i][j] = seed >> 16;
+    }
+  }
+
+  // Both decoders agree on every byte pattern, encode the decoded fields
+  // alike, and the encoding decodes back to the same fields
+  for (i = 0; i < NUM_INSNS; i++)
+  {
+    memset(&s_expected[i], 0, sizeof(s_expected[i]));
+    memset(&insn, 0, sizeof(insn));
+    s_lengths[i] = chip_ops->decode(s_isa, s_bytes[i], INSN_BYTES, &s_expected[i]);
+    CHECK(generic_ops->decode((xtensa_isa) &s_copy, s_bytes[i], INSN_BYTES, &insn) == s_lengths[i]);
+    if (s_lengths[i] <= 0)
+    {
+      continue;
+    }
+    valid++;
+    CHECK(decoded_equal(&insn, &s_expected[i]));
+
+    // Shorter input than the instruction is refused
+    CHECK(chip_ops->decode(s_isa, s_bytes[i], s_lengths[i] - 1, &insn) == XTENSA_UNDEFINED);
+    CHECK(generic_ops->decode((xtensa_isa) &s_copy, s_bytes[i], s_lengths[i] - 1, &insn) == XTENSA_UNDEFINED);
+
+    for (j = 0; j < s_expected[i].num_slots && s_expected[i].slots[j].opcode != XTENSA_UNDEFINED; j++)
+    {
+    }
+    if (j < s_expected[i].num_slots)
+    {
+      continue;
+    }
+    length = chip_ops->encode(s_isa, &s_expected[i], encoded);
+    CHECK(length == s_lengths[i]);
+    CHECK(generic_ops->encode((xtensa_isa) &s_copy, &s_expected[i], generic_encoded) == length);
+    CHECK(length <= 0 || memcmp(encoded, generic_encoded, length) == 0);
+    memset(&again, 0, sizeof(again));
+    CHECK(length <= 0 || chip_ops->decode(s_isa, encoded, length, &again) == length);
+    CHECK(length <= 0 || decoded_equal(&again, &s_expected[i]));
+  }
+  CHECK(valid > 0);
+
+  // The generic decoder keeps no state between calls
+  for (i = 0; i < NUM_THREADS; i++)
+  {
+    CHECK(pthread_create(&threads[i], NULL, decode_thread, &mismatches[i]) == 0);
+  }
+  for (i = 0; i < NUM_THREADS; i++)
+  {
+    pthread_join(threads[i], NULL);
+    CHECK(mismatches[i] == 0);
+  }
+
+  return test_result("decoder");
+}
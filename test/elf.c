@@ -0,0 +1,147 @@
+#include <elf.h>
+#include <link.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "elf.h"
+
+#if __ELF_NATIVE_CLASS == 64
+#define TEST_ELFCLASS ELFCLASS64
+#define TEST_R_SYM(info) ELF64_R_SYM(info)
+#define TEST_ST_BIND(info) ELF64_ST_BIND(info)
+#else
+#define TEST_ELFCLASS ELFCLASS32
+#define TEST_R_SYM(info) ELF32_R_SYM(info)
+#define TEST_ST_BIND(info) ELF32_ST_BIND(info)
+#endif
+
+#ifndef SHT_RELR
+#define SHT_RELR 19
+#endif
+
+static unsigned char *read_file(const char *path, long *size)
+{
+  FILE *f = fopen(path, "rb");
+  unsigned char *data = NULL;
+
+  if (f == NULL)
+  {
+    return NULL;
+  }
+  if (fseek(f, 0, SEEK_END) == 0 && (*size = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0
+      && (data = malloc(*size)) != NULL && fread(data, 1, *size, f) != (size_t) *size)
+  {
+    free(data);
+    data = NULL;
+  }
+  fclose(f);
+  return data;
+}
+
+// Relative relocations packed in the SIZE bytes of RELR: an address word
+// stands for one, a bitmap word for each bit set above its lowest
+static long relr_relocs(const ElfW(Addr) *relr, size_t size)
+{
+  long n = 0;
+  size_t i = 0;
+
+  for (i = 0; i < size / sizeof(*relr); i++)
+  {
+    n += relr[i] & 1 ? __builtin_popcountll((unsigned long long) relr[i]) - 1 : 1;
+  }
+  return n;
+}
+
+// A relocation against symbol SYM of DYNSYM that the library defines
+static int symbolic(const ElfW(Sym) *dynsym, size_t num_syms, size_t sym)
+{
+  return sym != 0 && sym < num_syms && dynsym[sym].st_shndx != SHN_UNDEF;
+}
+
+int test_elf_read(const char *path, struct test_elf *elf)
+{
+  long size = 0;
+  unsigned char *data = read_file(path, &size);
+  const ElfW(Ehdr) *ehdr = (const ElfW(Ehdr) *) data;
+  const ElfW(Shdr) *shdr = NULL;
+  const ElfW(Sym) *dynsym = NULL;
+  const char *dynstr = NULL;
+  size_t num_syms = 0, i = 0, j = 0;
+
+  memset(elf, 0, sizeof(*elf));
+  if (data == NULL || size < (long) sizeof(*ehdr) || memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0
+      || ehdr->e_ident[EI_CLASS] != TEST_ELFCLASS
+      || ehdr->e_shoff + (size_t) ehdr->e_shnum * sizeof(*shdr) > (size_t) size)
+  {
+    free(data);
+    return -1;
+  }
+  shdr = (const ElfW(Shdr) *) (data + ehdr->e_shoff);
+
+  for (i = 0; i < ehdr->e_shnum; i++)
+  {
+    if (shdr[i].sh_type == SHT_DYNSYM && shdr[i].sh_link < ehdr->e_shnum)
+    {
+      dynsym = (const ElfW(Sym) *) (data + shdr[i].sh_offset);
+      num_syms = shdr[i].sh_size / sizeof(*dynsym);
+      dynstr = (const char *) data + shdr[shdr[i].sh_link].sh_offset;
+    }
+  }
+
+  for (i = 0; i < ehdr->e_shnum; i++)
+  {
+    const unsigned char *p = data + shdr[i].sh_offset;
+
+    if (shdr[i].sh_type == SHT_RELA)
+    {
+      const ElfW(Rela) *rela = (const ElfW(Rela) *) p;
+
+      for (j = 0; j < shdr[i].sh_size / sizeof(*rela); j++)
+      {
+        elf->num_relative += TEST_R_SYM(rela[j].r_info) == 0;
+        elf->num_symbolic += symbolic(dynsym, num_syms, TEST_R_SYM(rela[j].r_info));
+      }
+      elf->num_records += j;
+      elf->num_relocs += j;
+    }
+    else if (shdr[i].sh_type == SHT_REL)
+    {
+      const ElfW(Rel) *rel = (const ElfW(Rel) *) p;
+
+      for (j = 0; j < shdr[i].sh_size / sizeof(*rel); j++)
+      {
+        elf->num_relative += TEST_R_SYM(rel[j].r_info) == 0;
+        elf->num_symbolic += symbolic(dynsym, num_syms, TEST_R_SYM(rel[j].r_info));
+      }
+      elf->num_records += j;
+      elf->num_relocs += j;
+    }
+    else if (shdr[i].sh_type == SHT_RELR)
+    {
+      long n = relr_relocs((const ElfW(Addr) *) p, shdr[i].sh_size);
+
+      elf->num_records += shdr[i].sh_size / sizeof(ElfW(Addr));
+      elf->num_relocs += n;
+      elf->num_relative += n;
+      elf->num_packed += n;
+    }
+  }
+
+  for (i = 1; i < num_syms; i++)
+  {
+    const char *name = dynstr + dynsym[i].st_name;
+
+    if (dynsym[i].st_shndx == SHN_UNDEF || TEST_ST_BIND(dynsym[i].st_info) == STB_LOCAL)
+    {
+      continue;
+    }
+    elf->num_exports++;
+    if (strncmp(name, "xtensa_", 7) != 0 && strcmp(name, "plugin_is_GPL_compatible") != 0)
+    {
+      snprintf(elf->foreign_export, sizeof(elf->foreign_export), "%s", name);
+    }
+  }
+  free(data);
+  return 0;
+}
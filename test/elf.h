@@ -0,0 +1,39 @@
+/* Dynamic relocations and exports of a shared library, for tests.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_TEST_ELF_H
+#define XTENSA_CONFIG_TEST_ELF_H
+
+/* What the dynamic loader has to do for a library of the host's ELF
+   class, read from its section headers.  */
+
+struct test_elf
+{
+  long num_records;		/* REL and RELA entries plus RELR words.  */
+  long num_relocs;		/* Relocations they stand for.  */
+  long num_relative;		/* Of those, relative ones (no symbol).  */
+  long num_symbolic;		/* Relocations against defined symbols.  */
+  long num_packed;		/* Relative relocations in RELR.  */
+  long num_exports;		/* Defined global dynamic symbols.  */
+  char foreign_export[64];	/* One not named xtensa_*, or empty.  */
+};
+
+/* Fill ELF from the library at PATH; return 0, or -1 if it cannot be
+   read.  */
+int test_elf_read (const char *path, struct test_elf *elf);
+
+#endif /* !XTENSA_CONFIG_TEST_ELF_H */
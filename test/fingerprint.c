@@ -0,0 +1,97 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/fingerprint.h"
+#include "test.h"
+
+static const struct
+{
+  const char *data;
+  size_t len;
+  const char *hex;
+} s_fnv128_vectors[] =
+{
+  { "", 0, "6c62272e07bb014262b821756295c58d" },
+  { "a", 1, "d228cb696f1a8caf78912b704e4a8964" },
+  { "foobar", 6, "343e1662793c64bf6f0d3597ba446f18" },
+  { "\0\1\2\3\4\5\6\7", 8, "50593c475c65995be031a86eee36c3e5" },
+};
+
+// FNV-1a 128 of the reference implementation
+static void check_hash(void)
+{
+  char hex[XTENSA_FINGERPRINT_HEX_SIZE];
+  struct xtensa_fingerprint fp;
+  size_t i = 0;
+
+  for (i = 0; i < sizeof(s_fnv128_vectors) / sizeof(s_fnv128_vectors[0]); i++)
+  {
+    xtensa_fingerprint_hash(&fp, s_fnv128_vectors[i].data, s_fnv128_vectors[i].len);
+    xtensa_fingerprint_format(&fp, hex);
+    CHECK(strcmp(hex, s_fnv128_vectors[i].hex) == 0);
+  }
+}
+
+// The fingerprint keys caches across builds and hosts, so the hash of
+// given values must never change: the field count and the fields as
+// 32-bit little-endian words, every string with its terminator, then
+// the string count.  A new xtensa_config field changes it on purpose
+static void check_stable(void)
+{
+  static const char *const strings[] = {"XCHAL_A=1", "B=x", NULL};
+  struct xtensa_config config;
+  unsigned int *fields = &config.xchal_have_be;
+  size_t num_fields = (sizeof(config) - offsetof(struct xtensa_config, xchal_have_be)) / sizeof(unsigned int);
+  struct xtensa_fingerprint fp, again;
+  char hex[XTENSA_FINGERPRINT_HEX_SIZE];
+  size_t i = 0;
+
+  memset(&config, 0, sizeof(config));
+  config.config_size = sizeof(config);
+  for (i = 0; i < num_fields; i++)
+  {
+    fields[i] = i * 3 + 1;
+  }
+  CHECK(num_fields == 54);
+  xtensa_fingerprint_compute(&fp, &config, strings, NULL);
+  xtensa_fingerprint_format(&fp, hex);
+  CHECK(strcmp(hex, "9403122a2c8754d647d1e689567e2d99") == 0);
+  xtensa_fingerprint_compute(&again, &config, strings, NULL);
+  CHECK(memcmp(fp.bytes, again.bytes, sizeof(fp.bytes)) == 0);
+
+  // Every input counts
+  fields[num_fields - 1]++;
+  xtensa_fingerprint_compute(&again, &config, strings, NULL);
+  CHECK(memcmp(fp.bytes, again.bytes, sizeof(fp.bytes)) != 0);
+  fields[num_fields - 1]--;
+  xtensa_fingerprint_compute(&again, &config, strings + 1, NULL);
+  CHECK(memcmp(fp.bytes, again.bytes, sizeof(fp.bytes)) != 0);
+}
+
+// The fingerprint the chip library carries is the one computed from the
+// tables it exports, as the fallback for libraries without it does
+static void check_chip(void)
+{
+  const struct xtensa_fingerprint *carried = xtensa_config_fingerprint();
+  const void *strings = xtensa_config_table("xtensa_config_strings");
+  const void *isa = xtensa_config_table("xtensa_modules");
+  struct xtensa_fingerprint fp;
+
+  CHECK(strings != NULL && isa != NULL);
+  xtensa_fingerprint_compute(&fp, xtensa_get_config(-1), strings, isa);
+  CHECK(memcmp(fp.bytes, carried->bytes, sizeof(fp.bytes)) == 0);
+  xtensa_fingerprint_compute(&fp, xtensa_get_config(-1), strings, NULL);
+  CHECK(memcmp(fp.bytes, carried->bytes, sizeof(fp.bytes)) != 0);
+  CHECK(xtensa_config_fingerprint() == carried);
+}
+
+int main(int argc, char **argv)
+{
+  test_chip(argc, argv);
+
+  check_hash();
+  check_stable();
+  check_chip();
+  return test_result("fingerprint");
+}
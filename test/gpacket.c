@@ -0,0 +1,214 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "xtensa-tdep.h"
+#pragma GCC diagnostic pop
+
+#include "xtensaconfig/composite.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/gpacket.h"
+#include "test.h"
+
+#define ROUNDS 64
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define HOST_BIG_ENDIAN 1
+#else
+#define HOST_BIG_ENDIAN 0
+#endif
+
+static const struct xtensa_gpacket_layout *s_layout;
+static unsigned int s_seed = 1;
+
+static void fill_random(unsigned char *buf, size_t size)
+{
+  size_t i = 0;
+
+  for (i = 0; i < size; i++)
+  {
+    s_seed = s_seed * 1103515245 + 12345;
+    buf[i] = s_seed >> 16;
+  }
+}
+
+// Whether register REG shares packet bytes with another one
+static int overlaps(int reg)
+{
+  const struct xtensa_gpacket_run *a = &s_layout->regs[reg];
+  int i = 0;
+
+  for (i = 0; i < s_layout->num_regs; i++)
+  {
+    const struct xtensa_gpacket_run *b = &s_layout->regs[i];
+
+    if (i != reg && a->length > 0 && b->length > 0 && a->packet < b->packet + b->length
+        && b->packet < a->packet + a->length)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Register REG of IMAGE holds its packet bytes in host order
+static int reg_matches(int reg, const unsigned char *image, const unsigned char *packet)
+{
+  const struct xtensa_gpacket_run *r = &s_layout->regs[reg];
+  unsigned int i = 0;
+
+  for (i = 0; i < r->length; i++)
+  {
+    unsigned int j = s_layout->big_endian != HOST_BIG_ENDIAN ? r->length - 1 - i : i;
+
+    if (image[r->image + i] != packet[r->packet + j])
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Packet bytes of the registers of A and B are the same
+static int packets_equal(const unsigned char *a, const unsigned char *b)
+{
+  int i = 0;
+
+  for (i = 0; i < s_layout->num_regs; i++)
+  {
+    if (memcmp(a + s_layout->regs[i].packet, b + s_layout->regs[i].packet, s_layout->regs[i].length) != 0)
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Composite REG takes its bits from registers that share no packet bytes
+static int composite_separate(const xtensa_register_t *rmap, int reg)
+{
+  int i = 0;
+
+  for (i = 0; i < rmap[reg].mask->count; i++)
+  {
+    if (overlaps(rmap[reg].mask->mask[i].reg_num))
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  const xtensa_register_t *rmap = NULL;
+  const struct xtensa_composite_table *composites = NULL;
+  unsigned char *packet = NULL, *again = NULL, *image = NULL, *copy = NULL;
+  size_t image_size = 0, len = 0, used = 0;
+  int round = 0, i = 0;
+
+  test_chip(argc, argv);
+  rmap = xtensa_load_config("xtensa_rmap", NULL);
+  s_layout = xtensa_config_gpacket();
+  composites = xtensa_config_composite();
+  CHECK(s_layout != NULL);
+  if (s_layout == NULL)
+  {
+    return test_result("gpacket");
+  }
+
+  image_size = (s_layout->image_size + s_layout->image_align - 1) / s_layout->image_align * s_layout->image_align;
+  packet = malloc(s_layout->packet_size + 1);
+  again = malloc(s_layout->packet_size + 1);
+  image = aligned_alloc(s_layout->image_align, image_size + s_layout->image_align);
+  copy = aligned_alloc(s_layout->image_align, image_size + s_layout->image_align);
+  if (!packet || !again || !image || !copy)
+  {
+    abort();
+  }
+
+  for (round = 0; round < ROUNDS; round++)
+  {
+    // Packet to image: every register in host byte order, and packed
+    // back to the same packet
+    fill_random(packet, s_layout->packet_size);
+    memset(image, 0, image_size);
+    CHECK(xtensa_gpacket_unpack(s_layout, packet, s_layout->packet_size, image) == s_layout->packet_size);
+    for (i = 0; i < s_layout->num_regs; i++)
+    {
+      CHECK(reg_matches(i, image, packet));
+    }
+    fill_random(again, s_layout->packet_size);
+    xtensa_gpacket_pack(s_layout, image, again);
+    CHECK(packets_equal(again, packet));
+
+    // Image to packet: what is packed unpacks to the same registers,
+    // except where other registers share the bytes, and packs again to
+    // the same packet
+    fill_random(image, image_size);
+    xtensa_gpacket_pack(s_layout, image, packet);
+    memcpy(copy, image, image_size);
+    fill_random(image, image_size);
+    xtensa_gpacket_unpack(s_layout, packet, s_layout->packet_size, image);
+    for (i = 0; i < s_layout->num_regs; i++)
+    {
+      const struct xtensa_gpacket_run *r = &s_layout->regs[i];
+
+      CHECK(overlaps(i) || memcmp(image + r->image, copy + r->image, r->length) == 0);
+      CHECK(reg_matches(i, image, packet));
+    }
+    xtensa_gpacket_pack(s_layout, image, again);
+    CHECK(packets_equal(again, packet));
+
+    // A short packet fills the registers wholly in it and no others
+    len = s_layout->packet_size > 0 ? s_seed % s_layout->packet_size : 0;
+    fill_random(packet, s_layout->packet_size);
+    memcpy(copy, image, image_size);
+    used = xtensa_gpacket_unpack(s_layout, packet, len, image);
+    CHECK(used <= len);
+    for (i = 0; i < s_layout->num_regs; i++)
+    {
+      const struct xtensa_gpacket_run *r = &s_layout->regs[i];
+
+      if (r->packet + r->length <= len)
+      {
+        CHECK(r->packet + r->length <= used);
+        CHECK(reg_matches(i, image, packet));
+      }
+      else if (!overlaps(i))
+      {
+        CHECK(memcmp(image + r->image, copy + r->image, r->length) == 0);
+      }
+    }
+
+    // Composite registers written to the image survive a round trip
+    // through the packet
+    for (i = 0; composites != NULL && i < composites->num_composites; i++)
+    {
+      const struct xtensa_composite *c = &composites->composites[i];
+      uint64_t value = 0, written = 0, read = 0;
+
+      if (c->read == NULL || !composite_separate(rmap, c->reg))
+      {
+        continue;
+      }
+      fill_random((unsigned char *) &value, sizeof(value));
+      CHECK(xtensa_composite_write(composites, c->reg, image, value) == 0);
+      CHECK(xtensa_composite_read(composites, c->reg, image, &written) == 0);
+      CHECK(written == (c->bit_size < 64 ? value & (((uint64_t) 1 << c->bit_size) - 1) : value));
+      xtensa_gpacket_pack(s_layout, image, packet);
+      fill_random(copy, image_size);
+      xtensa_gpacket_unpack(s_layout, packet, s_layout->packet_size, copy);
+      CHECK(xtensa_composite_read(composites, c->reg, copy, &read) == 0);
+      CHECK(read == written);
+    }
+  }
+
+  free(packet);
+  free(again);
+  free(image);
+  free(copy);
+  return test_result("gpacket");
+}
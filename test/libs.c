@@ -0,0 +1,72 @@
+#include <dlfcn.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/stats.h"
+#include "test.h"
+
+// The symbols each per-tool library carries and leaves to the full one
+static const struct
+{
+  const char *variant;
+  const char *present[8];
+  const char *absent[8];
+} s_libs[] =
+{
+  { "gcc", { "xtensa_config", "xtensa_config_strings", "xtensa_sched_tables_data" },
+    { "xtensa_modules", "xtensa_decoder_ops", "xtensa_rmap", "xtensa_gpacket_layout_data" } },
+  { "bfd", { "xtensa_config", "xtensa_config_strings", "xtensa_modules", "xtensa_decoder_ops" },
+    { "xtensa_rmap", "xtensa_gpacket_layout_data", "xtensa_sched_tables_data" } },
+  { "gdb", { "xtensa_config", "xtensa_config_strings", "xtensa_modules", "xtensa_decoder_ops", "xtensa_rmap",
+             "xtensa_gpacket_layout_data", "xtensa_composite_data", "xtensa_tdesc_data" },
+    { "xtensa_sched_tables_data" } },
+  { NULL, { "xtensa_config", "xtensa_config_strings", "xtensa_modules", "xtensa_rmap",
+            "xtensa_gpacket_layout_data", "xtensa_sched_tables_data" },
+    { NULL } },
+};
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  struct xtensa_config_stats stats;
+  char path[PATH_MAX];
+  size_t i = 0, j = 0;
+
+  for (i = 0; i < sizeof(s_libs) / sizeof(s_libs[0]); i++)
+  {
+    void *handle = NULL;
+
+    test_lib_path(path, sizeof(path), chip, s_libs[i].variant);
+    handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    CHECK(handle != NULL);
+    if (handle == NULL)
+    {
+      fprintf(stderr, "%s\n", dlerror());
+      continue;
+    }
+    for (j = 0; j < sizeof(s_libs[i].present) / sizeof(s_libs[i].present[0]) && s_libs[i].present[j]; j++)
+    {
+      CHECK(dlsym(handle, s_libs[i].present[j]) != NULL);
+    }
+    for (j = 0; j < sizeof(s_libs[i].absent) / sizeof(s_libs[i].absent[0]) && s_libs[i].absent[j]; j++)
+    {
+      CHECK(dlsym(handle, s_libs[i].absent[j]) == NULL);
+    }
+    dlclose(handle);
+  }
+
+  // GDB loads its own library, and the full one only for a symbol that
+  // library leaves out
+  CHECK(xtensaconfig_get_lib_variant() != NULL && strcmp(xtensaconfig_get_lib_variant(), "gdb") == 0);
+  CHECK(xtensa_load_config("xtensa_rmap", NULL) != NULL);
+  CHECK(xtensa_config_table("xtensa_tdesc_data") != NULL);
+  xtensa_config_stats(&stats);
+  CHECK(stats.count[XTENSA_CONFIG_PHASE_DLOPEN] == 1);
+  CHECK(xtensa_config_table("xtensa_sched_tables_data") != NULL);
+  xtensa_config_stats(&stats);
+  CHECK(stats.count[XTENSA_CONFIG_PHASE_DLOPEN] == 2);
+
+  return test_result("libs");
+}
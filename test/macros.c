@@ -0,0 +1,106 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/macros.h"
+#include "test.h"
+
+// The value of the first entry NAME, as the definitions were looked up
+// before the index
+static const char *scan_value(const char *const *strings, const char *name, size_t len)
+{
+  for (; *strings != NULL; strings++)
+  {
+    if (strncmp(*strings, name, len) == 0 && (*strings)[len] == '=')
+    {
+      return *strings + len + 1;
+    }
+  }
+  return NULL;
+}
+
+static const char *find_value(const struct xtensa_config_macros *macros, const char *name, size_t len)
+{
+  const struct xtensa_config_macro *macro = xtensa_config_macros_find(macros, name, len);
+
+  return macro != NULL ? macro->value : NULL;
+}
+
+static int name_below(const struct xtensa_config_macro *a, const struct xtensa_config_macro *b)
+{
+  int cmp = memcmp(a->name, b->name, a->name_len < b->name_len ? a->name_len : b->name_len);
+
+  return cmp < 0 || (cmp == 0 && a->name_len < b->name_len);
+}
+
+static void check_strings(const char *const *strings)
+{
+  struct xtensa_config_macros macros;
+  const struct xtensa_config_macro *macro = NULL;
+  size_t num_names = 0, i = 0, len = 0;
+  const char *eq = NULL;
+
+  CHECK(xtensa_config_macros_init(&macros, strings) == 0);
+  for (i = 0; strings[i] != NULL; i++)
+  {
+    if ((eq = strchr(strings[i], '=')) == NULL)
+    {
+      continue;
+    }
+    len = eq - strings[i];
+    num_names += scan_value(strings, strings[i], len) == eq + 1;
+    macro = xtensa_config_macros_find(&macros, strings[i], len);
+    CHECK(macro != NULL && macro->name_len == len && memcmp(macro->name, strings[i], len) == 0);
+    CHECK(find_value(&macros, strings[i], len) == scan_value(strings, strings[i], len));
+
+    // A prefix of a name is another name
+    CHECK(len == 0 || find_value(&macros, strings[i], len - 1) == scan_value(strings, strings[i], len - 1));
+  }
+  CHECK(macros.num_macros == num_names);
+  for (i = 1; i < macros.num_macros; i++)
+  {
+    CHECK(name_below(&macros.macros[i - 1], &macros.macros[i]));
+  }
+  xtensa_config_macros_free(&macros);
+}
+
+int main(int argc, char **argv)
+{
+  static const char *const s_edge[] = {"__B=2", "__A=1", "NOVALUE", "__A=3", "__AB=4", "__=5", "__E=", NULL};
+  static const char *const s_empty[] = {NULL};
+  const char *chip = test_chip(argc, argv);
+  const char *const *strings = xtensa_load_config("xtensa_config_strings", NULL);
+  struct xtensa_config_macros macros;
+
+  if (strings == NULL)
+  {
+    fprintf(stderr, "%s: no xtensa_config_strings\n", chip);
+    return 1;
+  }
+  check_strings(strings);
+  check_strings(s_edge);
+  check_strings(s_empty);
+
+  CHECK(xtensa_config_macros_init(&macros, s_edge) == 0);
+  CHECK(macros.num_macros == 5);
+  CHECK(strcmp(xtensa_config_macros_find(&macros, "__A", 3)->value, "1") == 0);
+  CHECK(strcmp(xtensa_config_macros_find(&macros, "__E", 3)->value, "") == 0);
+  CHECK(xtensa_config_macros_find(&macros, "NOVALUE", 7) == NULL);
+  CHECK(xtensa_config_macros_find(&macros, "__a", 3) == NULL);
+  CHECK(xtensa_config_macros_find(&macros, "__ABC", 5) == NULL);
+  CHECK(xtensa_config_macros_find(&macros, "__A=1", 3) != NULL);
+  xtensa_config_macros_free(&macros);
+
+  CHECK(xtensa_config_macro_is_number("0"));
+  CHECK(xtensa_config_macro_is_number("16384"));
+  CHECK(xtensa_config_macro_is_number("0x1f"));
+  CHECK(xtensa_config_macro_is_number("1e+5"));
+  CHECK(xtensa_config_macro_is_number(".5"));
+  CHECK(!xtensa_config_macro_is_number(""));
+  CHECK(!xtensa_config_macro_is_number("-1"));
+  CHECK(!xtensa_config_macro_is_number("(1)"));
+  CHECK(!xtensa_config_macro_is_number("1 + 1"));
+  CHECK(!xtensa_config_macro_is_number("x1"));
+  CHECK(!xtensa_config_macro_is_number("1-1"));
+  return test_result("macros");
+}
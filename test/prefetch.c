@@ -0,0 +1,73 @@
+#include <dlfcn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/stats.h"
+#include "test.h"
+
+extern const struct xtensa_config xtensa_default_config;
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  struct xtensa_config_stats stats;
+  const void *config = NULL;
+  // The prefetch tries the per-tool library first, if any
+  unsigned int num_paths = xtensaconfig_get_lib_variant() != NULL ? 2 : 1;
+  pid_t child = 0;
+  int status = 0;
+
+  // A prefetch for another option is dropped and the chip loaded as usual
+  child = fork();
+  if (child == 0)
+  {
+    xtensa_config_prefetch("no-such-chip");
+    xtensaconfig_string = chip;
+    config = xtensa_load_config("xtensa_config", NULL);
+    CHECK(config != NULL && config != &xtensa_default_config);
+    xtensa_config_stats(&stats);
+    CHECK(stats.count[XTENSA_CONFIG_PHASE_DLOPEN] == num_paths + 1);
+    _exit(test_failures != 0);
+  }
+  CHECK(waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // One that did open a library, here the plain build of the chip, closes
+  // it again
+  child = fork();
+  if (child == 0)
+  {
+    char plain_option[256], plain_path[4096];
+
+    snprintf(plain_option, sizeof(plain_option), "%s-plain", chip);
+    test_lib_path(plain_path, sizeof(plain_path), chip, "plain");
+    xtensa_config_prefetch(plain_option);
+    xtensaconfig_string = chip;
+    config = xtensa_load_config("xtensa_config", NULL);
+    CHECK(config != NULL && config != &xtensa_default_config);
+    CHECK(dlopen(plain_path, RTLD_NOW | RTLD_NOLOAD) == NULL);
+    _exit(test_failures != 0);
+  }
+  CHECK(waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // The first lookup takes over the prefetched library, and its dlopen is
+  // accounted once the thread is joined
+  xtensa_config_prefetch(chip);
+  xtensa_config_stats(&stats);
+  CHECK(stats.count[XTENSA_CONFIG_PHASE_DLOPEN] == 0);
+  config = xtensa_load_config("xtensa_config", NULL);
+  CHECK(config != NULL && config != &xtensa_default_config);
+  xtensa_config_stats(&stats);
+  CHECK(stats.count[XTENSA_CONFIG_PHASE_DLOPEN] == 1);
+  CHECK(stats.count[XTENSA_CONFIG_PHASE_PATH] == num_paths);
+
+  // A later prefetch has nothing to do
+  xtensa_config_prefetch(chip);
+  CHECK(xtensa_load_config("xtensa_config", NULL) == config);
+  xtensa_config_stats(&stats);
+  CHECK(stats.count[XTENSA_CONFIG_PHASE_DLOPEN] == 1);
+
+  return test_result("prefetch");
+}
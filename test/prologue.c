@@ -0,0 +1,273 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/decoder.h"
+#include "prologue.h"
+
+// Longer than any instruction
+#define INSN_BYTES 64
+
+static const int s_callee_saved[] = {0, 12, 13, 14, 15};
+#define NUM_CALLEE_SAVED (int) (sizeof(s_callee_saved) / sizeof(s_callee_saved[0]))
+
+static uint32_t next_random(unsigned int *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return *seed >> 16;
+}
+
+// Encode OPNAME with operand VALUES, the others 0, in the shortest format
+// of one slot that holds it and decodes back to it; return its length, or
+// -1 if there is none or it does not fit in SPACE bytes
+static int prologue_encode(xtensa_isa isa, const char *opname, const uint32 *values, int num_values,
+                           unsigned char *code, size_t space)
+{
+  xtensa_isa_internal *intisa = (xtensa_isa_internal *) isa;
+  xtensa_opcode opc = xtensa_opcode_lookup(isa, opname);
+  struct xtensa_decoded_insn insn, back;
+  unsigned char buf[INSN_BYTES];
+  int fmt = 0, i = 0, length = 0, best = -1;
+
+  if (opc == XTENSA_UNDEFINED || xtensa_opcode_num_operands(isa, opc) < num_values)
+  {
+    return -1;
+  }
+  memset(&insn, 0, sizeof(insn));
+  insn.num_slots = 1;
+  insn.slots[0].opcode = opc;
+  for (i = 0; i < num_values; i++)
+  {
+    uint32 value = values[i];
+
+    if (xtensa_operand_is_register(isa, opc, i) != 1 && xtensa_operand_encode(isa, opc, i, &value) != 0)
+    {
+      return -1;
+    }
+    insn.slots[0].fields[i] = value;
+  }
+
+  for (fmt = 0; fmt < intisa->num_formats; fmt++)
+  {
+    if (intisa->formats[fmt].num_slots != 1 || intisa->formats[fmt].length > INSN_BYTES)
+    {
+      continue;
+    }
+    insn.format = fmt;
+    length = xtensa_encode_insn(isa, &insn, buf);
+    if (length <= 0 || (size_t) length > space || (best > 0 && length >= best))
+    {
+      continue;
+    }
+    memset(&back, 0, sizeof(back));
+    if (xtensa_decode_insn(isa, buf, length, &back) != length || back.slots[0].opcode != opc
+        || memcmp(back.slots[0].fields, insn.slots[0].fields, sizeof(uint32) * num_values) != 0)
+    {
+      continue;
+    }
+    memcpy(code, buf, length);
+    best = length;
+  }
+  return best;
+}
+
+// Append an instruction that leaves the frame as it was; the caller
+// updates the new last expected frame for its effect
+static int prologue_insn(xtensa_isa isa, unsigned char *code, size_t space, struct test_prologue *p,
+                         const char *opname, const uint32 *values, int num_values)
+{
+  int length = 0;
+
+  if (p->num_insns >= TEST_PROLOGUE_MAX_INSNS
+      || (length = prologue_encode(isa, opname, values, num_values, code + p->size, space - p->size)) < 0)
+  {
+    return -1;
+  }
+  p->size += length;
+  p->num_insns++;
+  p->expected[p->num_insns] = p->expected[p->num_insns - 1];
+  p->expected[p->num_insns].prologue_end = p->entry + p->size;
+  return 0;
+}
+
+// Sometimes an instruction the analysis does not follow, writing a
+// register the prologue does not use
+static int prologue_filler(xtensa_isa isa, unsigned char *code, size_t space, struct test_prologue *p,
+                           unsigned int *seed)
+{
+  uint32 ops[3];
+
+  if (next_random(seed) % 3 != 0)
+  {
+    return 0;
+  }
+  ops[0] = 2 + next_random(seed) % 6;
+  ops[1] = 2 + next_random(seed) % 6;
+  ops[2] = 2 + next_random(seed) % 6;
+  return prologue_insn(isa, code, space, p, "add", ops, 3);
+}
+
+// Allocate SIZE bytes of stack with addi, or with movi and sub
+static int prologue_allocate(xtensa_isa isa, unsigned char *code, size_t space, struct test_prologue *p,
+                             int32_t size, int large)
+{
+  uint32 ops[3];
+
+  if (large)
+  {
+    ops[0] = 8;
+    ops[1] = size;
+    if (prologue_insn(isa, code, space, p, "movi", ops, 2) != 0)
+    {
+      return -1;
+    }
+    ops[0] = 1;
+    ops[1] = 1;
+    ops[2] = 8;
+    if (prologue_insn(isa, code, space, p, "sub", ops, 3) != 0)
+    {
+      return -1;
+    }
+  }
+  else
+  {
+    ops[0] = 1;
+    ops[1] = 1;
+    ops[2] = -size;
+    if (prologue_insn(isa, code, space, p, "addi", ops, 3) != 0)
+    {
+      return -1;
+    }
+  }
+  p->expected[p->num_insns].cfa_offset = size;
+  p->expected[p->num_insns].frame_size = size;
+  return 0;
+}
+
+int test_prologue_build(xtensa_isa isa, unsigned char *code, size_t space, uint32_t entry, unsigned int *seed,
+                        struct test_prologue *p)
+{
+  static const char *const ends[] = {"ret.n", "ret", "j", "call0"};
+  int regs[NUM_CALLEE_SAVED], slots[16];
+  int32_t size = 16 * (1 + next_random(seed) % 7);
+  int large = next_random(seed) % 2, num_slots = 0, num_saves = 0, i = 0, j = 0, t = 0, length = -1;
+  struct xtensa_call0_frame *frame = &p->expected[0];
+  uint32 ops[3];
+
+  memset(p, 0, sizeof(*p));
+  p->entry = entry;
+  frame->entry = entry;
+  frame->prologue_end = entry;
+  frame->cfa_reg = 1;
+  for (i = 0; i < C0_NREGS; i++)
+  {
+    frame->saved[i] = XTENSA_CALL0_NOT_SAVED;
+  }
+
+  // Frames movi cannot load are made smaller
+  if (large)
+  {
+    size = 16 * (1 + next_random(seed) % 127);
+    ops[1] = size;
+    while (size > 16 && prologue_encode(isa, "movi", ops, 2, code, space) < 0)
+    {
+      size = size / 2 & ~15;
+      ops[1] = size;
+    }
+  }
+  if (prologue_filler(isa, code, space, p, seed) != 0 || prologue_allocate(isa, code, space, p, size, large) != 0)
+  {
+    return -1;
+  }
+
+  // Some callee-saved registers stored in distinct words of the frame
+  num_slots = size / 4 < 16 ? size / 4 : 16;
+  for (i = 0; i < num_slots; i++)
+  {
+    slots[i] = i;
+  }
+  for (i = 0; i < NUM_CALLEE_SAVED; i++)
+  {
+    regs[i] = s_callee_saved[i];
+  }
+  for (i = num_slots - 1; i > 0; i--)
+  {
+    j = next_random(seed) % (i + 1);
+    t = slots[i], slots[i] = slots[j], slots[j] = t;
+  }
+  for (i = NUM_CALLEE_SAVED - 1; i > 0; i--)
+  {
+    j = next_random(seed) % (i + 1);
+    t = regs[i], regs[i] = regs[j], regs[j] = t;
+  }
+  num_saves = next_random(seed) % ((num_slots < NUM_CALLEE_SAVED ? num_slots : NUM_CALLEE_SAVED) + 1);
+  for (i = 0; i < num_saves; i++)
+  {
+    ops[0] = regs[i];
+    ops[1] = 1;
+    ops[2] = 4 * slots[i];
+    if (prologue_filler(isa, code, space, p, seed) != 0 || prologue_insn(isa, code, space, p, "s32i", ops, 3) != 0)
+    {
+      return -1;
+    }
+    p->expected[p->num_insns].saved[regs[i]] = 4 * slots[i] - size;
+  }
+
+  // a15 the frame pointer, once saved
+  ops[0] = 15;
+  ops[1] = 1;
+  ops[2] = 1;
+  if (next_random(seed) % 2 != 0
+      && (prologue_insn(isa, code, space, p, "mov.n", ops, 2) == 0
+          || prologue_insn(isa, code, space, p, "or", ops, 3) == 0))
+  {
+    p->expected[p->num_insns].cfa_reg = 15;
+  }
+  if (prologue_filler(isa, code, space, p, seed) != 0)
+  {
+    return -1;
+  }
+
+  // The control transfer the analysis stops at
+  for (i = next_random(seed) % 4, j = 0; j < 4 && length < 0; i = (i + 1) % 4, j++)
+  {
+    length = prologue_encode(isa, ends[i], NULL, 0, code + p->size, space - p->size);
+  }
+  if (length < 0)
+  {
+    return -1;
+  }
+  p->size += length;
+  return 0;
+}
+
+static int codemem_read(void *ctx, uint32_t addr, void *buf, size_t len)
+{
+  struct test_codemem *mem = ctx;
+
+  mem->reads++;
+  if (addr < mem->base || addr - mem->base > mem->size || len > mem->size - (addr - mem->base))
+  {
+    return -1;
+  }
+  memcpy(buf, mem->mem + (addr - mem->base), len);
+  return 0;
+}
+
+int test_codemem_init(struct test_codemem *mem, uint32_t base, uint32_t size)
+{
+  memset(mem, 0, sizeof(*mem));
+  mem->base = base;
+  mem->size = size;
+  mem->mem = calloc(size, 1);
+  mem->target.read_memory = codemem_read;
+  mem->target.ctx = mem;
+  return mem->mem != NULL ? 0 : -1;
+}
+
+void test_codemem_free(struct test_codemem *mem)
+{
+  free(mem->mem);
+}
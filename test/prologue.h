@@ -0,0 +1,66 @@
+/* Synthetic call0 ABI prologues, for tests.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_TEST_PROLOGUE_H
+#define XTENSA_CONFIG_TEST_PROLOGUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "xtensa-isa.h"
+#include "xtensaconfig/unwind.h"
+
+/* A random prologue as compilers emit it, assembled with the encodings
+   of the chip's ISA: the stack allocated with addi, or with movi and
+   sub, callee-saved registers stored, maybe a15 made the frame pointer,
+   unrelated instructions in between, and a return, jump or call to end
+   it.  EXPECTED[K] is the analysis stopped after K instructions, and
+   EXPECTED[NUM_INSNS] that of the whole prologue.  */
+
+#define TEST_PROLOGUE_MAX_INSNS 24
+
+struct test_prologue
+{
+  uint32_t entry;
+  int num_insns;
+  uint32_t size;		/* Bytes, the final control transfer included.  */
+  struct xtensa_call0_frame expected[TEST_PROLOGUE_MAX_INSNS + 1];
+};
+
+/* Assemble a prologue for ENTRY from *SEED into the SPACE bytes of
+   CODE; return 0, or -1 if ISA cannot encode it or it does not fit.  */
+int test_prologue_build (xtensa_isa isa, unsigned char *code, size_t space,
+			 uint32_t entry, unsigned int *seed,
+			 struct test_prologue *prologue);
+
+/* Code memory read through TARGET; reads are counted, and those beyond
+   the SIZE bytes at BASE fail.  */
+
+struct test_codemem
+{
+  struct xtensa_unwind_target target;
+  uint32_t base;
+  uint32_t size;
+  unsigned char *mem;
+  long reads;
+};
+
+/* Return 0, or -1 if out of memory.  */
+int test_codemem_init (struct test_codemem *mem, uint32_t base,
+		       uint32_t size);
+void test_codemem_free (struct test_codemem *mem);
+
+#endif /* !XTENSA_CONFIG_TEST_PROLOGUE_H */
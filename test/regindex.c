@@ -0,0 +1,111 @@
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "xtensa-tdep.h"
+#pragma GCC diagnostic pop
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/regindex.h"
+#include "test.h"
+
+// Target numbers looked up beyond those of the rmap
+#define NUM_NUMBERS 0x10000
+
+static const xtensa_register_t *s_rmap;
+static int s_num_regs;
+
+// What a lookup without the index finds: the first register in rmap
+// order, or -1
+static int scan_name(const char *name)
+{
+  int i = 0;
+
+  for (i = 0; i < s_num_regs; i++)
+  {
+    if (strcmp(s_rmap[i].name, name) == 0)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static int scan_number(unsigned int target_number)
+{
+  int i = 0;
+
+  for (i = 0; i < s_num_regs; i++)
+  {
+    if (s_rmap[i].target_number == target_number)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int main(int argc, char **argv)
+{
+  static const char *const s_misses[] = {"", "nosuchreg", "a", "ar", "a16", "ar64", " pc", "pc "};
+  const struct xtensa_regindex *index = NULL;
+  char name[256];
+  unsigned int number = 0, num_changed = 0;
+  int i = 0, j = 0, misses = 0;
+
+  test_chip(argc, argv);
+  s_rmap = xtensa_load_config("xtensa_rmap", NULL);
+  index = xtensa_config_regindex();
+  if (s_rmap == NULL || index == NULL)
+  {
+    fprintf(stderr, "no xtensa_rmap or xtensa_regindex_data\n");
+    return 1;
+  }
+  while (s_rmap[s_num_regs].name != NULL)
+  {
+    s_num_regs++;
+  }
+  CHECK(index->num_regs == s_num_regs);
+  CHECK(index->num_slots >= 2 * (unsigned int) s_num_regs && (index->num_slots & (index->num_slots - 1)) == 0);
+
+  for (i = 0; i < s_num_regs; i++)
+  {
+    CHECK(xtensa_regindex_find_name(index, s_rmap[i].name) == scan_name(s_rmap[i].name));
+    CHECK(xtensa_regindex_find_number(index, s_rmap[i].target_number) == scan_number(s_rmap[i].target_number));
+
+    // Names are case-sensitive, and a prefix or an extension of a name
+    // is another one
+    if (strlen(s_rmap[i].name) >= sizeof(name) - 1)
+    {
+      continue;
+    }
+    strcpy(name, s_rmap[i].name);
+    for (j = 0, num_changed = 0; name[j] != '\0'; j++)
+    {
+      num_changed += islower((unsigned char) name[j]) != 0;
+      name[j] = toupper((unsigned char) name[j]);
+    }
+    CHECK(xtensa_regindex_find_name(index, name) == scan_name(name));
+    misses += num_changed > 0 && scan_name(name) < 0;
+    strcpy(name, s_rmap[i].name);
+    name[strlen(name) - 1] = '\0';
+    CHECK(xtensa_regindex_find_name(index, name) == scan_name(name));
+    strcat(strcpy(name, s_rmap[i].name), "_");
+    CHECK(xtensa_regindex_find_name(index, name) == scan_name(name));
+  }
+  CHECK(misses > 0);
+
+  for (i = 0; i < (int) (sizeof(s_misses) / sizeof(s_misses[0])); i++)
+  {
+    CHECK(xtensa_regindex_find_name(index, s_misses[i]) == scan_name(s_misses[i]));
+  }
+  for (number = 0; number < NUM_NUMBERS; number++)
+  {
+    CHECK(xtensa_regindex_find_number(index, number) == scan_number(number));
+  }
+  CHECK(xtensa_regindex_find_number(index, UINT32_MAX) == scan_number(UINT32_MAX));
+  return test_result("regindex");
+}
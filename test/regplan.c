@@ -0,0 +1,207 @@
+#include <stdint.h>
+#include <string.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "xtensa-tdep.h"
+#pragma GCC diagnostic pop
+
+#include "xtensaconfig/regplan.h"
+#include "test.h"
+
+// ps and windowbase make psintlevel, which with sar makes a composite of
+// a composite
+static xtensa_reg_mask_t s_psintlevel_parts[] = { { 3, 0, 1 }, { 5, 0, 3 } };
+static const xtensa_mask_t s_psintlevel_mask = { 2, s_psintlevel_parts };
+static xtensa_reg_mask_t s_nested_parts[] = { { 10, 0, 4 }, { 4, 0, 6 } };
+static const xtensa_mask_t s_nested_mask = { 2, s_nested_parts };
+
+static xtensa_register_t s_rmap[] =
+{
+  XTREG(  0,  0, 32,  4,  4, 0x0020, 0x000e, -2, 9, 0x0100, pc,         0, 0, 0, 0, 0, 0)
+  XTREG(  1,  4, 32,  4,  4, 0x0100, 0x0006, -2, 1, 0x0002, ar0,        0, 0, 0, 0, 0, 0)
+  XTREG(  2,  8, 32,  4,  4, 0x0101, 0x0006, -2, 1, 0x0002, ar1,        0, 0, 0, 0, 0, 0)
+  XTREG(  3, 12, 32,  4,  4, 0x02e6, 0x000e, -2, 2, 0x1100, ps,         0, 0, 0, 0, 0, 0)
+  XTREG(  4, 16,  6,  4,  4, 0x0203, 0x0006, -2, 2, 0x1100, sar,        0, 0, 0, 0, 0, 0)
+  XTREG(  5, 20,  3,  1,  1, 0x0248, 0x0006, -2, 2, 0x1100, windowbase, 0, 0, 0, 0, 0, 0)
+  XTREG(  6, 32,128, 16, 16, 0x1000, 0x0006,  1, 4, 0x0101, q0,         "fetch q0", "store q0", 0, 0, 0, 0)
+  XTREG(  7, 48,128, 16, 16, 0x1001, 0x0006,  1, 4, 0x0101, q1,         "fetch q1", "store q1", 0, 0, 0, 0)
+  XTREG(  8, 64, 64,  8,  4, 0x0010, 0x0006,  0, 4, 0x0101, acc,        "fetch acc", "store acc", 0, 0, 0, 0)
+  XTREG(  9, 72, 32,  4,  4, 0x0259, 0x0004, -2, 2, 0x1100, mmid,       0, 0, 0, 0, 0, 0)
+  XTREG( 10, 76,  4,  4,  4, 0x2000, 0x0006, -2, 6, 0x1010, psintlevel, 0, 0, &s_psintlevel_mask, 0, 0, 0)
+  XTREG( 11, 80, 10,  4,  4, 0x2001, 0x0006, -2, 6, 0x1010, nested,     0, 0, &s_nested_mask, 0, 0, 0)
+  XTREG_END
+};
+
+#define NUM_REGS 12
+#define IMAGE_SIZE 96
+#define G_REGS 4
+#define G_BYTES 16
+
+// What the mock stub saw and what the client ended up with
+struct stub_run
+{
+  unsigned char client[IMAGE_SIZE];
+  int reads[NUM_REGS];
+  int trips;
+  unsigned long bytes;
+};
+
+static unsigned char s_image[IMAGE_SIZE];
+
+static void stub_reply(struct stub_run *run, int reg)
+{
+  const xtensa_register_t *r = &s_rmap[reg];
+
+  memcpy(&run->client[r->offset], &s_image[r->offset], r->byte_size);
+  run->reads[reg]++;
+}
+
+// Serve PLAN as a stub with TARGET's limits would and check its framing
+static void stub_serve(const struct xtensa_regplan *plan, const struct xtensa_regplan_target *target,
+                       struct stub_run *run)
+{
+  int depth = target->pipeline_depth > 0 ? target->pipeline_depth : 1;
+  int packets = 0, trip = -1, s = 0, i = 0;
+
+  memset(run, 0, sizeof(*run));
+  for (s = 0; s < plan->num_steps; s++)
+  {
+    const struct xtensa_regplan_step *step = &plan->steps[s];
+    const int *regs = &plan->regs[step->first];
+
+    CHECK(step->trip == trip || step->trip == trip + 1);
+    if (step->trip != trip)
+    {
+      trip = step->trip;
+      packets = 0;
+      run->trips++;
+    }
+    switch (step->kind)
+    {
+    case XTENSA_REGPLAN_G:
+      CHECK(++packets <= depth);
+      run->bytes += G_BYTES;
+      for (i = 0; i < step->count; i++)
+      {
+        CHECK(regs[i] < target->g_regs);
+        stub_reply(run, regs[i]);
+      }
+      break;
+    case XTENSA_REGPLAN_P:
+      CHECK(++packets <= depth);
+      CHECK(step->count == 1);
+      run->bytes += s_rmap[regs[0]].byte_size;
+      stub_reply(run, regs[0]);
+      break;
+    case XTENSA_REGPLAN_FETCH:
+      // Fetch batches are not pipelined and enable one coprocessor
+      CHECK(packets == 0);
+      packets = depth;
+      CHECK(step->count <= target->fetch_batch);
+      for (i = 0; i < step->count; i++)
+      {
+        CHECK(s_rmap[regs[i]].fetch != NULL);
+        CHECK(s_rmap[regs[i]].coprocessor == s_rmap[regs[0]].coprocessor);
+        run->bytes += s_rmap[regs[i]].byte_size;
+        stub_reply(run, regs[i]);
+      }
+      break;
+    }
+  }
+  CHECK(run->trips == plan->num_trips);
+  CHECK(run->bytes == plan->bytes);
+  CHECK(plan->cost == (unsigned long) plan->num_trips * target->trip_cost + plan->bytes * target->byte_cost);
+}
+
+// Plan NEED, serve it and check that exactly the registers in READ were
+// read, each once and with the stub's value, and that UNAVAILABLE were
+// reported
+static void check_plan(const int *need, int num_need, const unsigned char *valid,
+                       const struct xtensa_regplan_target *target, const char *read,
+                       const int *unavailable, int num_unavailable)
+{
+  struct xtensa_regplan *plan = xtensa_regplan_build(s_rmap, need, num_need, valid, target);
+  struct stub_run run;
+  int i = 0;
+
+  CHECK(plan != NULL);
+  if (plan == NULL)
+  {
+    return;
+  }
+  stub_serve(plan, target, &run);
+  for (i = 0; i < NUM_REGS; i++)
+  {
+    const xtensa_register_t *r = &s_rmap[i];
+
+    CHECK(run.reads[i] == (read[i] == 'r'));
+    if (run.reads[i])
+    {
+      CHECK(memcmp(&run.client[r->offset], &s_image[r->offset], r->byte_size) == 0);
+    }
+  }
+  CHECK(plan->num_unavailable == num_unavailable);
+  for (i = 0; i < plan->num_unavailable && i < num_unavailable; i++)
+  {
+    CHECK(plan->unavailable[i] == unavailable[i]);
+  }
+  xtensa_regplan_free(plan);
+}
+
+static int count_kind(const struct xtensa_regplan *plan, enum xtensa_regplan_kind kind)
+{
+  int n = 0, s = 0;
+
+  for (s = 0; s < plan->num_steps; s++)
+  {
+    n += plan->steps[s].kind == kind;
+  }
+  return n;
+}
+
+int main(void)
+{
+  static const int all[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 99 };
+  static const int all_unavailable[] = { 9, 99 };
+  static const int nested[] = { 11 };
+  static const int g_part[] = { 0, 1, 2 };
+  struct xtensa_regplan_target serial = { G_REGS, 1, 2, 1000, 1 };
+  struct xtensa_regplan_target pipelined = { G_REGS, 8, 1, 1000, 1 };
+  struct xtensa_regplan_target no_fetch = { 0, 1, 0, 1000, 1 };
+  struct xtensa_regplan *plan = NULL;
+  unsigned char valid[NUM_REGS];
+  int i = 0;
+
+  for (i = 0; i < IMAGE_SIZE; i++)
+  {
+    s_image[i] = (unsigned char) (i * 37 + 11);
+  }
+
+  // Every register: composites through their parts, mmid is write-only
+  check_plan(all, 13, NULL, &serial, "rrrrrrrrr---", all_unavailable, 2);
+  check_plan(all, 13, NULL, &pipelined, "rrrrrrrrr---", all_unavailable, 2);
+  check_plan(all, 13, NULL, &no_fetch, "rrrrrrrrr---", all_unavailable, 2);
+
+  // A composite part that is itself composite is read through its parts
+  check_plan(nested, 1, NULL, &serial, "---rrr------", NULL, 0);
+
+  // Known registers are read again only if volatile
+  memset(valid, 1, sizeof(valid));
+  check_plan(all, 13, valid, &serial, "r--r--------", all_unavailable, 2);
+
+  // One 'g' beats three serial 'p', two pipelined 'p' beat one 'g'
+  plan = xtensa_regplan_build(s_rmap, g_part, 3, NULL, &serial);
+  CHECK(plan != NULL && plan->num_trips == 1 && count_kind(plan, XTENSA_REGPLAN_G) == 1);
+  xtensa_regplan_free(plan);
+  plan = xtensa_regplan_build(s_rmap, g_part, 2, NULL, &pipelined);
+  CHECK(plan != NULL && plan->num_trips == 1 && count_kind(plan, XTENSA_REGPLAN_P) == 2);
+  xtensa_regplan_free(plan);
+
+  // Registers with fetch sequences are batched per coprocessor
+  plan = xtensa_regplan_build(s_rmap, all, 13, NULL, &serial);
+  CHECK(plan != NULL && count_kind(plan, XTENSA_REGPLAN_FETCH) == 2);
+  xtensa_regplan_free(plan);
+
+  return test_result("regplan");
+}
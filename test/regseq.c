@@ -0,0 +1,146 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/decoder.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/regseq.h"
+#include "test.h"
+
+#define NUM_MAPS 64
+#define MAX_BYTES 256
+
+static xtensa_isa s_isa;
+
+// Whether operand OPND of OPC names an address register in its field
+static int is_areg(xtensa_opcode opc, int opnd)
+{
+  xtensa_isa_internal *intisa = (xtensa_isa_internal *) s_isa;
+  xtensa_iclass_internal *iclass = &intisa->iclasses[intisa->opcodes[opc].iclass_id];
+  xtensa_operand_internal *op = &intisa->operands[iclass->operands[opnd].u.operand_id];
+
+  return (op->flags & XTENSA_OPERAND_IS_REGISTER) && !(op->flags & XTENSA_OPERAND_IS_INVISIBLE)
+         && strcmp(xtensa_regfile_shortname(s_isa, op->regfile), "a") == 0;
+}
+
+// Decode CODE and EMITTED, the sequence with the registers of MAP: the
+// same instructions, every address register aN made aMAP[N] and every
+// other field kept
+static void check_emitted(const unsigned char *code, const unsigned char *emitted, size_t length, const int *map,
+                          int *num_aregs)
+{
+  struct xtensa_decoded_insn orig, insn;
+  size_t pos = 0;
+  int len = 0, slot = 0, opnd = 0, n = 0;
+
+  while (pos < length)
+  {
+    memset(&orig, 0, sizeof(orig));
+    memset(&insn, 0, sizeof(insn));
+    len = xtensa_decode_insn(s_isa, code + pos, length - pos, &orig);
+    CHECK(len > 0);
+    if (len <= 0)
+    {
+      return;
+    }
+    CHECK(xtensa_decode_insn(s_isa, emitted + pos, length - pos, &insn) == len);
+    CHECK(insn.format == orig.format && insn.num_slots == orig.num_slots);
+    for (slot = 0; slot < orig.num_slots; slot++)
+    {
+      xtensa_opcode opc = orig.slots[slot].opcode;
+
+      CHECK(insn.slots[slot].opcode == opc);
+      for (opnd = 0; opc != XTENSA_UNDEFINED && opnd < xtensa_opcode_num_operands(s_isa, opc); opnd++)
+      {
+        uint32 reg = orig.slots[slot].fields[opnd], got = insn.slots[slot].fields[opnd];
+
+        if (!is_areg(opc, opnd))
+        {
+          CHECK(got == reg);
+          continue;
+        }
+        CHECK(xtensa_operand_decode(s_isa, opc, opnd, &reg) == 0);
+        CHECK(xtensa_operand_decode(s_isa, opc, opnd, &got) == 0);
+        CHECK(reg < XTENSA_REGSEQ_NUM_AREGS && got == (uint32) map[reg]);
+        n++;
+      }
+    }
+    pos += len;
+  }
+  *num_aregs += n;
+}
+
+static void check_seq(const struct xtensa_regseq *seq, unsigned int *seed, int *num_seqs, int *num_aregs)
+{
+  unsigned char buf[MAX_BYTES], before[MAX_BYTES];
+  int map[XTENSA_REGSEQ_NUM_AREGS];
+  unsigned int i = 0, m = 0;
+
+  if (seq->code == NULL)
+  {
+    return;
+  }
+  (*num_seqs)++;
+  CHECK(seq->length <= MAX_BYTES);
+  CHECK(xtensa_regseq_emit(seq, NULL, buf, sizeof(buf)) == seq->length);
+  CHECK(memcmp(buf, seq->code, seq->length) == 0);
+  CHECK(xtensa_regseq_emit(seq, NULL, buf, seq->length - 1) == 0);
+
+  // The identity, every register one, and random maps
+  for (m = 0; m < NUM_MAPS; m++)
+  {
+    for (i = 0; i < XTENSA_REGSEQ_NUM_AREGS; i++)
+    {
+      *seed = *seed * 1103515245 + 12345;
+      map[i] = m == 0 ? (int) i : m < 17 ? (int) m - 1 : (int) ((*seed >> 16) % XTENSA_REGSEQ_NUM_AREGS);
+    }
+    memset(buf, 0xa5, sizeof(buf));
+    CHECK(xtensa_regseq_emit(seq, map, buf, sizeof(buf)) == seq->length);
+    check_emitted(seq->code, buf, seq->length, map, num_aregs);
+  }
+
+  // A register outside a0 to a15 fails and leaves the buffer alone
+  for (i = 0; i < seq->num_patches; i++)
+  {
+    int reg = seq->patches[i].reg;
+
+    CHECK(reg < XTENSA_REGSEQ_NUM_AREGS);
+    for (m = 0; m < XTENSA_REGSEQ_NUM_AREGS; m++)
+    {
+      map[m] = m;
+    }
+    memset(buf, 0x5a, sizeof(buf));
+    memcpy(before, buf, sizeof(buf));
+    map[reg] = XTENSA_REGSEQ_NUM_AREGS;
+    CHECK(xtensa_regseq_emit(seq, map, buf, sizeof(buf)) == 0);
+    map[reg] = -1;
+    CHECK(xtensa_regseq_emit(seq, map, buf, sizeof(buf)) == 0);
+    CHECK(memcmp(buf, before, sizeof(buf)) == 0);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  const struct xtensa_regseq_table *table = NULL;
+  unsigned int seed = 1;
+  int reg = 0, num_seqs = 0, num_aregs = 0;
+
+  test_chip(argc, argv);
+  s_isa = (xtensa_isa) xtensa_load_config("xtensa_modules", NULL);
+  table = xtensa_config_regseq();
+  if (table == NULL)
+  {
+    fprintf(stderr, "no xtensa_regseq_data\n");
+    return 1;
+  }
+
+  for (reg = 0; reg < table->num_regs; reg++)
+  {
+    check_seq(&table->regs[reg].fetch, &seed, &num_seqs, &num_aregs);
+    check_seq(&table->regs[reg].store, &seed, &num_seqs, &num_aregs);
+  }
+  CHECK(num_seqs == 0 || num_aregs > 0);
+  return test_result("regseq");
+}
@@ -0,0 +1,215 @@
+#include <stdint.h>
+#include <string.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "xtensa-tdep.h"
+#pragma GCC diagnostic pop
+
+#include "xtensaconfig/regunits.h"
+#include "test.h"
+
+// ps and windowbase make psintlevel, which with acc makes a composite of
+// a composite; q0 and q1 are coprocessor 1, f0 coprocessor 0, and both
+// are enabled through cpenable
+static xtensa_reg_mask_t s_psintlevel_parts[] = { { 5, 0, 1 }, { 7, 0, 3 } };
+static const xtensa_mask_t s_psintlevel_mask = { 2, s_psintlevel_parts };
+static xtensa_reg_mask_t s_nested_parts[] = { { 12, 0, 4 }, { 11, 0, 6 } };
+static const xtensa_mask_t s_nested_mask = { 2, s_nested_parts };
+
+static xtensa_register_t s_rmap[] =
+{
+  XTREG(  0,  0, 32,  4,  4, 0x0020, 0x0006, -2, 9, 0x0100, pc,         0, 0, 0, 0, 0, 0)
+  XTREG(  1,  4, 32,  4,  4, 0x0100, 0x0006, -2, 1, 0x0002, ar0,        0, 0, 0, 0, 0, 0)
+  XTREG(  2,  8, 32,  4,  4, 0x0101, 0x0006, -2, 1, 0x0002, ar1,        0, 0, 0, 0, 0, 0)
+  XTREG(  3, 12, 32,  4,  4, 0x0000, 0x0006, -2, 8, 0x0100, a0,         0, 0, 0, 0, 0, 0)
+  XTREG(  4, 16, 32,  4,  4, 0x0001, 0x0006, -2, 8, 0x0100, a1,         0, 0, 0, 0, 0, 0)
+  XTREG(  5, 20, 32,  4,  4, 0x02e6, 0x000e, -2, 2, 0x1100, ps,         0, 0, 0, 0, 0, 0)
+  XTREG(  6, 24,  8,  4,  4, 0x02e0, 0x0006, -2, 2, 0x1000, cpenable,   0, 0, 0, 0, 0, 0)
+  XTREG(  7, 28,  3,  1,  1, 0x0248, 0x0006, -2, 2, 0x1000, windowbase, 0, 0, 0, 0, 0, 0)
+  XTREG(  8, 32,128, 16, 16, 0x1000, 0x0006,  1, 4, 0x0101, q0,         "fetch q0", "store q0", 0, 0, 0, 0)
+  XTREG(  9, 48,128, 16, 16, 0x1001, 0x0006,  1, 4, 0x0101, q1,         "fetch q1", "store q1", 0, 0, 0, 0)
+  XTREG( 10, 64, 32,  4,  4, 0x0030, 0x0006,  0, 4, 0x0401, f0,         "fetch f0", "store f0", 0, 0, 0, 0)
+  XTREG( 11, 68, 40,  8,  4, 0x0010, 0x0006, -1, 3, 0x0200, acc,        "fetch acc", "store acc", 0, 0, 0, 0)
+  XTREG( 12, 76,  4,  4,  4, 0x2000, 0x0006, -2, 6, 0x1010, psintlevel, 0, 0, &s_psintlevel_mask, 0, 0, 0)
+  XTREG( 13, 80, 10,  4,  4, 0x2001, 0x0006, -2, 6, 0x0010, nested,     0, 0, &s_nested_mask, 0, 0, 0)
+  XTREG_END
+};
+
+#define NUM_REGS 14
+#define REG_PC 0
+#define REG_AR0 1
+#define REG_A0 3
+#define REG_PS 5
+#define REG_CPENABLE 6
+#define REG_WINDOWBASE 7
+#define REG_Q0 8
+#define REG_Q1 9
+#define REG_F0 10
+#define REG_ACC 11
+#define REG_PSINTLEVEL 12
+#define REG_NESTED 13
+
+static const struct xtensa_reg_units *s_units;
+
+// Position of unit U in the N units of ORDER, or -1
+static int order_pos(const int *order, int n, int u)
+{
+  int i = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    if (order[i] == u)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// The N units of ORDER: each once, none loaded before, marked now, and
+// every dependency loaded before or fetched earlier
+static void check_order(const unsigned char *before, const unsigned char *loaded, const int *order, int n)
+{
+  int i = 0, j = 0, u = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    const struct xtensa_reg_unit *unit = &s_units->units[order[i]];
+
+    CHECK(order[i] >= 0 && order[i] < s_units->num_units);
+    CHECK(order_pos(order, n, order[i]) == i);
+    CHECK(!before[order[i]] && loaded[order[i]]);
+    for (j = 0; j < unit->num_deps; j++)
+    {
+      int pos = order_pos(order, n, unit->deps[j]);
+
+      CHECK(before[unit->deps[j]] ? pos < 0 : pos >= 0 && pos < i);
+    }
+  }
+  for (u = 0; u < s_units->num_units; u++)
+  {
+    CHECK(loaded[u] == (before[u] || order_pos(order, n, u) >= 0));
+  }
+}
+
+// Unit of FIRST fetched before that of THEN when faulting in REG
+static int fetched_before(int reg, int first, int then)
+{
+  unsigned char loaded[NUM_REGS] = { 0 };
+  int order[NUM_REGS];
+  int n = xtensa_reg_units_fault(s_units, reg, loaded, order);
+  int a = order_pos(order, n, s_units->unit_of[first]), b = order_pos(order, n, s_units->unit_of[then]);
+
+  return a >= 0 && b >= 0 && a < b;
+}
+
+static void check_partition(void)
+{
+  int seen[NUM_REGS] = { 0 };
+  int u = 0, i = 0, total = 0;
+
+  CHECK(s_units->num_regs == NUM_REGS);
+  for (u = 0; u < s_units->num_units; u++)
+  {
+    const struct xtensa_reg_unit *unit = &s_units->units[u];
+    unsigned long bytes = 0;
+
+    CHECK(unit->num_regs > 0);
+    for (i = 0; i < unit->num_regs; i++)
+    {
+      int reg = unit->regs[i];
+
+      CHECK(reg >= 0 && reg < NUM_REGS);
+      seen[reg]++;
+      CHECK(s_units->unit_of[reg] == u);
+      CHECK(i == 0 || unit->regs[i - 1] < reg);
+      CHECK(s_rmap[reg].coprocessor == unit->coprocessor || (s_rmap[reg].coprocessor < 0 && unit->coprocessor < 0));
+      bytes += s_rmap[reg].mask == NULL ? s_rmap[reg].byte_size : 0;
+    }
+    CHECK(unit->bytes == bytes);
+    total += unit->num_regs;
+  }
+  for (i = 0; i < NUM_REGS; i++)
+  {
+    CHECK(seen[i] == 1);
+  }
+  CHECK(total == NUM_REGS);
+
+  // A unit per coprocessor, the composites not in the units of their parts
+  CHECK(s_units->unit_of[REG_Q0] == s_units->unit_of[REG_Q1]);
+  CHECK(s_units->unit_of[REG_Q0] != s_units->unit_of[REG_F0]);
+  CHECK(s_units->unit_of[REG_CPENABLE] == s_units->unit_of[REG_WINDOWBASE]);
+  CHECK(s_units->unit_of[REG_PSINTLEVEL] != s_units->unit_of[REG_PS]);
+  CHECK(s_units->unit_of[REG_NESTED] != s_units->unit_of[REG_PSINTLEVEL]);
+  CHECK(s_units->units[s_units->unit_of[REG_PC]].eager && s_units->units[s_units->unit_of[REG_AR0]].eager);
+  CHECK(s_units->units[s_units->unit_of[REG_A0]].eager && !s_units->units[s_units->unit_of[REG_Q0]].eager);
+  CHECK(!s_units->units[s_units->unit_of[REG_ACC]].eager);
+}
+
+static void check_faults(void)
+{
+  unsigned char loaded[NUM_REGS], before[NUM_REGS];
+  int order[NUM_REGS];
+  int reg = 0, n = 0, u = 0;
+
+  // Each register from a fresh stop, then once more
+  for (reg = 0; reg < NUM_REGS; reg++)
+  {
+    memset(loaded, 0, sizeof(loaded));
+    memset(before, 0, sizeof(before));
+    n = xtensa_reg_units_fault(s_units, reg, loaded, order);
+    CHECK(n > 0 && order[n - 1] == s_units->unit_of[reg]);
+    check_order(before, loaded, order, n);
+    memcpy(before, loaded, sizeof(loaded));
+    CHECK(xtensa_reg_units_fault(s_units, reg, loaded, order) == 0);
+    CHECK(memcmp(before, loaded, sizeof(loaded)) == 0);
+  }
+
+  // Dependencies first: cpenable before the coprocessors, the address
+  // registers before fetch sequences, and parts before composites
+  CHECK(fetched_before(REG_Q0, REG_CPENABLE, REG_Q0));
+  CHECK(fetched_before(REG_F0, REG_CPENABLE, REG_F0));
+  CHECK(fetched_before(REG_Q1, REG_AR0, REG_Q1));
+  CHECK(fetched_before(REG_ACC, REG_AR0, REG_ACC));
+  CHECK(fetched_before(REG_PSINTLEVEL, REG_PS, REG_PSINTLEVEL));
+  CHECK(fetched_before(REG_PSINTLEVEL, REG_WINDOWBASE, REG_PSINTLEVEL));
+  CHECK(fetched_before(REG_NESTED, REG_PSINTLEVEL, REG_NESTED));
+  CHECK(fetched_before(REG_NESTED, REG_PS, REG_PSINTLEVEL));
+  CHECK(fetched_before(REG_NESTED, REG_ACC, REG_NESTED));
+
+  // The eager units at a stop, then only what they left out
+  memset(loaded, 0, sizeof(loaded));
+  memset(before, 0, sizeof(before));
+  n = xtensa_reg_units_fault(s_units, -1, loaded, order);
+  check_order(before, loaded, order, n);
+  for (u = 0; u < s_units->num_units; u++)
+  {
+    CHECK(!s_units->units[u].eager || loaded[u]);
+  }
+  CHECK(xtensa_reg_units_fault(s_units, -1, loaded, order) == 0);
+  memcpy(before, loaded, sizeof(loaded));
+  n = xtensa_reg_units_fault(s_units, REG_NESTED, loaded, order);
+  check_order(before, loaded, order, n);
+  CHECK(order_pos(order, n, s_units->unit_of[REG_AR0]) < 0);
+
+  memset(loaded, 0, sizeof(loaded));
+  CHECK(xtensa_reg_units_fault(s_units, NUM_REGS, loaded, order) == 0);
+  CHECK(xtensa_reg_units_fault(s_units, -2, loaded, order) == 0);
+}
+
+int main(void)
+{
+  struct xtensa_reg_units *units = xtensa_reg_units_build(s_rmap);
+
+  CHECK(units != NULL);
+  if (units == NULL)
+  {
+    return test_result("regunits");
+  }
+  s_units = units;
+  check_partition();
+  check_faults();
+  xtensa_reg_units_free(units);
+  return test_result("regunits");
+}
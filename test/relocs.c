@@ -0,0 +1,40 @@
+#include <limits.h>
+#include <stdlib.h>
+
+#include "elf.h"
+#include "test.h"
+
+static const char *const s_variants[] = { "gcc", "bfd", "gdb", NULL };
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  struct test_elf plain, elf;
+  char path[PATH_MAX];
+  size_t v = 0;
+
+  // The full library as linked without the relocation flags
+  test_lib_path(path, sizeof(path), chip, "plain");
+  CHECK(test_elf_read(path, &plain) == 0);
+
+  // Every library exports only the tables, binds its own references
+  // locally, and the loader has no more records to go through than
+  // without the flags; none is packed, which older loaders would ignore
+  for (v = 0; v < sizeof(s_variants) / sizeof(s_variants[0]); v++)
+  {
+    test_lib_path(path, sizeof(path), chip, s_variants[v]);
+    CHECK(test_elf_read(path, &elf) == 0);
+    CHECK(elf.foreign_export[0] == '\0');
+    CHECK(elf.num_symbolic == 0);
+    CHECK(elf.num_relative == elf.num_relocs);
+    CHECK(elf.num_packed == 0);
+    CHECK(elf.num_exports > 0);
+    if (s_variants[v] == NULL)
+    {
+      CHECK(elf.num_records <= plain.num_records);
+      CHECK(elf.num_exports <= plain.num_exports);
+    }
+  }
+
+  return test_result("relocs");
+}
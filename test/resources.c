@@ -0,0 +1,165 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensa-isa.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/resources.h"
+#include "test.h"
+
+// The tables against the xtensa_opcode_* and xtensa_funcUnit_* queries
+// of the ISA, as binutils answers them
+
+static xtensa_isa s_isa;
+static int s_num_stages;
+static int *s_uses;
+
+static int expected_num_stages(void)
+{
+  int opc = 0, u = 0, max_stage = -1;
+
+  for (opc = 0; opc < xtensa_isa_num_opcodes(s_isa); opc++)
+  {
+    for (u = 0; u < xtensa_opcode_num_funcUnit_uses(s_isa, opc); u++)
+    {
+      if (xtensa_opcode_funcUnit_use(s_isa, opc, u)->stage > max_stage)
+      {
+        max_stage = xtensa_opcode_funcUnit_use(s_isa, opc, u)->stage;
+      }
+    }
+  }
+  return max_stage + 1;
+}
+
+// Every use of the N opcodes counted against the copies of its unit
+static int expected_conflict(const xtensa_opcode *opcs, int n)
+{
+  int i = 0, u = 0, conflict = 0;
+
+  memset(s_uses, 0, sizeof(int) * (xtensa_isa_num_funcUnits(s_isa) * s_num_stages + 1));
+  for (i = 0; i < n; i++)
+  {
+    for (u = 0; u < xtensa_opcode_num_funcUnit_uses(s_isa, opcs[i]); u++)
+    {
+      xtensa_funcUnit_use *use = xtensa_opcode_funcUnit_use(s_isa, opcs[i], u);
+
+      conflict |= ++s_uses[use->unit * s_num_stages + use->stage] > xtensa_funcUnit_num_copies(s_isa, use->unit);
+    }
+  }
+  return conflict;
+}
+
+static void check_reservations(const struct xtensa_resources *res)
+{
+  int num_bits = xtensa_isa_num_funcUnits(s_isa) * s_num_stages;
+  int num_words = xtensa_resources_num_words(res);
+  uint64_t *expected = calloc(num_words, sizeof(uint64_t));
+  int opc = 0, u = 0, bit = 0;
+
+  CHECK(xtensa_resources_num_stages(res) == s_num_stages);
+  CHECK(num_words == (num_bits > 0 ? (num_bits + 63) / 64 : 1));
+  for (opc = 0; opc < xtensa_isa_num_opcodes(s_isa); opc++)
+  {
+    const uint64_t *r = xtensa_resources_reservation(res, opc);
+
+    memset(expected, 0, num_words * sizeof(uint64_t));
+    for (u = 0; u < xtensa_opcode_num_funcUnit_uses(s_isa, opc); u++)
+    {
+      xtensa_funcUnit_use *use = xtensa_opcode_funcUnit_use(s_isa, opc, u);
+
+      CHECK(use->stage >= 0 && use->stage < s_num_stages);
+      bit = use->unit * s_num_stages + use->stage;
+      expected[bit / 64] |= (uint64_t) 1 << (bit % 64);
+    }
+    CHECK(r != NULL && memcmp(r, expected, num_words * sizeof(uint64_t)) == 0);
+  }
+  CHECK(xtensa_resources_reservation(res, -1) == NULL);
+  CHECK(xtensa_resources_reservation(res, xtensa_isa_num_opcodes(s_isa)) == NULL);
+  free(expected);
+}
+
+// Alone, in every pair in both orders, and three times over, which is
+// where units with two copies run out
+static void check_conflicts(struct xtensa_resources *res)
+{
+  int num_opcodes = xtensa_isa_num_opcodes(s_isa);
+  xtensa_opcode opcs[3];
+  int a = 0, b = 0, conflicts = 0;
+
+  CHECK(xtensa_resources_conflict(res, opcs, 0) == 0);
+  for (a = 0; a < num_opcodes; a++)
+  {
+    opcs[0] = opcs[1] = opcs[2] = a;
+    CHECK(xtensa_resources_conflict(res, opcs, 1) == expected_conflict(opcs, 1));
+    CHECK(xtensa_resources_conflict(res, opcs, 3) == expected_conflict(opcs, 3));
+    for (b = 0; b < num_opcodes; b++)
+    {
+      opcs[1] = b;
+      CHECK(!xtensa_resources_conflict(res, opcs, 2) == !expected_conflict(opcs, 2));
+      conflicts += expected_conflict(opcs, 2);
+    }
+  }
+  // Too few conflicts, or too many, would not tell the check apart
+  CHECK(conflicts > 0 && conflicts < num_opcodes * num_opcodes);
+
+  // Opcodes out of range never issue
+  opcs[0] = 0;
+  opcs[1] = num_opcodes;
+  CHECK(xtensa_resources_conflict(res, opcs, 2) != 0);
+  opcs[1] = XTENSA_UNDEFINED;
+  CHECK(xtensa_resources_conflict(res, opcs, 2) != 0);
+}
+
+// The slots of an opcode are those xtensa_opcode_encode accepts it in,
+// by format and slot
+static void check_slot_refs(const struct xtensa_resources *res)
+{
+  xtensa_insnbuf slotbuf = calloc(xtensa_insnbuf_size(s_isa), sizeof(xtensa_insnbuf_word));
+  const struct xtensa_slot_ref *refs = NULL;
+  int opc = 0, fmt = 0, slot = 0, n = 0, k = 0;
+
+  for (opc = 0; opc < xtensa_isa_num_opcodes(s_isa); opc++)
+  {
+    n = xtensa_resources_slot_refs(res, opc, &refs);
+    k = 0;
+    for (fmt = 0; fmt < xtensa_isa_num_formats(s_isa); fmt++)
+    {
+      for (slot = 0; slot < xtensa_format_num_slots(s_isa, fmt); slot++)
+      {
+        if (xtensa_opcode_encode(s_isa, fmt, slot, slotbuf, opc) != 0)
+        {
+          continue;
+        }
+        CHECK(k < n && refs[k].format == fmt && refs[k].slot == slot);
+        k++;
+      }
+    }
+    CHECK(k == n);
+  }
+  CHECK(xtensa_resources_slot_refs(res, -1, &refs) == XTENSA_UNDEFINED);
+  CHECK(xtensa_resources_slot_refs(res, xtensa_isa_num_opcodes(s_isa), &refs) == XTENSA_UNDEFINED);
+  free(slotbuf);
+}
+
+int main(int argc, char **argv)
+{
+  struct xtensa_resources *res = NULL;
+
+  test_chip(argc, argv);
+  s_isa = (xtensa_isa) xtensa_load_config("xtensa_modules", NULL);
+  res = xtensa_resources_init(s_isa);
+  if (res == NULL)
+  {
+    abort();
+  }
+  s_num_stages = expected_num_stages();
+  s_uses = calloc(xtensa_isa_num_funcUnits(s_isa) * s_num_stages + 1, sizeof(int));
+
+  check_reservations(res);
+  check_conflicts(res);
+  check_slot_refs(res);
+
+  free(s_uses);
+  xtensa_resources_free(res);
+  return test_result("resources");
+}
@@ -0,0 +1,84 @@
+#include <stdlib.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/sched.h"
+#include "test.h"
+
+int main(int argc, char **argv)
+{
+  const struct xtensa_sched_tables *tables = NULL;
+  const struct xtensa_sched_reservation *res = NULL;
+  const xtensa_isa_internal *isa = NULL;
+  struct xtensa_sched_model *model = NULL;
+  struct xtensa_sched_state *state = NULL;
+  xtensa_opcode pair[2];
+  int issue_rate = 1, opc = 0, fmt = 0, u = 0, n = 0, first = 0, last = 0;
+
+  test_chip(argc, argv);
+  tables = xtensa_config_table("xtensa_sched_tables_data");
+  isa = xtensa_load_config("xtensa_modules", NULL);
+  CHECK(tables != NULL);
+  if (tables == NULL || (model = xtensa_sched_model_init(tables)) == NULL
+      || (state = xtensa_sched_state_alloc(model)) == NULL)
+  {
+    return test_result("sched");
+  }
+
+  // The generated tables describe the ISA
+  for (fmt = 0; fmt < isa->num_formats; fmt++)
+  {
+    issue_rate = isa->formats[fmt].num_slots > issue_rate ? isa->formats[fmt].num_slots : issue_rate;
+  }
+  CHECK(xtensa_sched_issue_rate(model) == issue_rate);
+  CHECK(tables->num_opcodes == isa->num_opcodes && tables->num_units == isa->num_funcUnits);
+  for (u = 0; u < isa->num_funcUnits; u++)
+  {
+    CHECK(tables->unit_copies[u] == isa->funcUnits[u].num_copies);
+  }
+
+  for (opc = 0; opc < isa->num_opcodes; opc++)
+  {
+    const xtensa_opcode_internal *op = &isa->opcodes[opc];
+
+    CHECK(xtensa_sched_lookup(model, op->name) == opc);
+
+    // Latency LAST - FIRST + 1 over the stages of the unit uses, and the
+    // uses relative to FIRST
+    for (u = 0, first = 0, last = 0; u < op->num_funcUnit_uses; u++)
+    {
+      first = u == 0 || op->funcUnit_uses[u].stage < first ? op->funcUnit_uses[u].stage : first;
+      last = u == 0 || op->funcUnit_uses[u].stage > last ? op->funcUnit_uses[u].stage : last;
+    }
+    CHECK(xtensa_sched_latency(model, opc) == last - first + 1);
+    n = xtensa_sched_reservations(model, opc, &res);
+    CHECK(n == op->num_funcUnit_uses);
+    for (u = 0; u < n && u < op->num_funcUnit_uses; u++)
+    {
+      CHECK(res[u].unit == op->funcUnit_uses[u].unit && res[u].cycle == op->funcUnit_uses[u].stage - first);
+    }
+
+    // Alone, an opcode takes its latency; twice, the second waits for a
+    // single-copy unit the first holds in its first cycle
+    pair[0] = pair[1] = opc;
+    CHECK(xtensa_sched_estimate_cycles(model, pair, 1) == last - first + 1);
+    xtensa_sched_state_reset(state);
+    CHECK(xtensa_sched_state_can_issue(state, opc));
+    xtensa_sched_state_issue(state, opc);
+    for (u = 0; u < n; u++)
+    {
+      if (res[u].cycle == 0 && tables->unit_copies[res[u].unit] == 1)
+      {
+        CHECK(!xtensa_sched_state_can_issue(state, opc));
+        CHECK(xtensa_sched_estimate_cycles(model, pair, 2) > last - first + 1);
+      }
+    }
+  }
+  CHECK(xtensa_sched_lookup(model, "no.such.opcode") == XTENSA_UNDEFINED);
+  CHECK(xtensa_sched_latency(model, isa->num_opcodes) == XTENSA_UNDEFINED);
+
+  xtensa_sched_state_free(state);
+  xtensa_sched_model_free(model);
+  return test_result("sched");
+}
@@ -0,0 +1,100 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "xtensaconfig/stats.h"
+#include "test.h"
+
+#define NUM_PROCESSES 3
+#define NUM_THREADS 4
+#define NUM_RUNS 2000
+
+static void *phase_thread(void *arg)
+{
+  int i = 0, phase = 0;
+
+  (void) arg;
+  for (i = 0; i < NUM_RUNS; i++)
+  {
+    for (phase = 0; phase < XTENSA_CONFIG_NUM_PHASES; phase++)
+    {
+      xtensa_config_phase_end(phase, xtensa_config_phase_begin(phase));
+    }
+  }
+  return NULL;
+}
+
+// Run every phase NUM_RUNS times on each of NUM_THREADS threads
+static void run_phases(void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i = 0;
+
+  for (i = 0; i < NUM_THREADS; i++)
+  {
+    CHECK(pthread_create(&threads[i], NULL, phase_thread, NULL) == 0);
+  }
+  for (i = 0; i < NUM_THREADS; i++)
+  {
+    pthread_join(threads[i], NULL);
+  }
+}
+
+int main(void)
+{
+  char path[] = "/tmp/xtensaconfig-trace-XXXXXX";
+  char line[512];
+  struct xtensa_config_stats stats;
+  FILE *fp = NULL;
+  pid_t children[NUM_PROCESSES - 1];
+  int fd = mkstemp(path), status = 0, lines = 0, i = 0;
+
+  CHECK(fd >= 0);
+  close(fd);
+  setenv("XTENSA_CONFIG_TRACE", path, 1);
+
+  // Several processes with several threads each share the trace file
+  for (i = 0; i < NUM_PROCESSES - 1; i++)
+  {
+    children[i] = fork();
+    if (children[i] == 0)
+    {
+      run_phases();
+      _exit(test_failures != 0);
+    }
+  }
+  run_phases();
+  for (i = 0; i < NUM_PROCESSES - 1; i++)
+  {
+    CHECK(waitpid(children[i], &status, 0) == children[i] && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+
+  // No update of the counters is lost
+  xtensa_config_stats(&stats);
+  for (i = 0; i < XTENSA_CONFIG_NUM_PHASES; i++)
+  {
+    CHECK(stats.count[i] == NUM_THREADS * NUM_RUNS);
+  }
+
+  // Every event is a whole line of its own
+  fp = fopen(path, "r");
+  CHECK(fp != NULL);
+  while (fp != NULL && fgets(line, sizeof(line), fp) != NULL)
+  {
+    size_t len = strlen(line);
+
+    lines++;
+    CHECK(strncmp(line, "{\"name\": \"", 10) == 0);
+    CHECK(len >= 2 && line[len - 2] == '}' && line[len - 1] == '\n');
+  }
+  CHECK(lines == NUM_PROCESSES * NUM_THREADS * NUM_RUNS * XTENSA_CONFIG_NUM_PHASES);
+  if (fp != NULL)
+  {
+    fclose(fp);
+  }
+  unlink(path);
+
+  return test_result("stats");
+}
@@ -0,0 +1,107 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "xtensa-tdep.h"
+#pragma GCC diagnostic pop
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/tdesc.h"
+#include "test.h"
+
+static uint32_t crc32_msb(const char *data, size_t length)
+{
+  uint32_t crc = 0xffffffff;
+  size_t i = 0;
+  int bit = 0;
+
+  for (i = 0; i < length; i++)
+  {
+    crc ^= (uint32_t) (unsigned char) data[i] << 24;
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = crc & 0x80000000 ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static int rmap_index(const xtensa_register_t *rmap, const char *name, size_t len)
+{
+  int i = 0;
+
+  for (i = 0; rmap[i].name != NULL; i++)
+  {
+    if (strlen(rmap[i].name) == len && strncmp(rmap[i].name, name, len) == 0)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int main(int argc, char **argv)
+{
+  const xtensa_register_t *rmap = NULL;
+  const struct xtensa_tdesc *tdesc = NULL;
+  const char *p = NULL;
+  int *reg_of = NULL;
+  int num_regs = 0, num_raw = 0, num_listed = 0, i = 0, j = 0;
+
+  test_chip(argc, argv);
+  rmap = xtensa_load_config("xtensa_rmap", NULL);
+  tdesc = xtensa_config_tdesc();
+  CHECK(tdesc != NULL);
+  if (tdesc == NULL)
+  {
+    return test_result("tdesc");
+  }
+  CHECK(strlen(tdesc->xml) == tdesc->length);
+  CHECK(crc32_msb(tdesc->xml, tdesc->length) == tdesc->checksum);
+
+  while (rmap[num_regs].name != NULL)
+  {
+    num_raw += rmap[num_regs].mask == NULL && rmap[num_regs].type != xtRegisterTypeWindow;
+    num_regs++;
+  }
+  reg_of = malloc(sizeof(int) * (num_regs + 1));
+  for (i = 0; i <= num_regs; i++)
+  {
+    reg_of[i] = -1;
+  }
+
+  // Every register listed is a raw one, with a number of its own
+  for (p = strstr(tdesc->xml, "<reg name=\""); p != NULL; p = strstr(p, "<reg name=\""))
+  {
+    const char *name = p + strlen("<reg name=\"");
+    const char *regnum = strstr(name, "regnum=\"");
+    int reg = rmap_index(rmap, name, strcspn(name, "\""));
+    int n = regnum ? atoi(regnum + strlen("regnum=\"")) : -1;
+
+    CHECK(reg >= 0);
+    CHECK(n >= 0 && n < num_raw);
+    if (reg >= 0 && n >= 0 && n < num_raw)
+    {
+      CHECK(rmap[reg].mask == NULL && rmap[reg].type != xtRegisterTypeWindow);
+      CHECK(reg_of[n] == -1);
+      reg_of[n] = reg;
+    }
+    num_listed++;
+    p = name;
+  }
+  CHECK(num_listed == num_raw);
+
+  // Numbered in the order of the 'g' packet
+  for (i = 0; i < num_raw; i++)
+  {
+    for (j = i + 1; j < num_raw; j++)
+    {
+      CHECK(reg_of[i] < 0 || reg_of[j] < 0 || rmap[reg_of[i]].offset <= rmap[reg_of[j]].offset);
+    }
+  }
+
+  free(reg_of);
+  return test_result("tdesc");
+}
@@ -0,0 +1,96 @@
+/* Minimal test helpers.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_TEST_H
+#define XTENSA_CONFIG_TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Every test is a program of its own that exits non-zero if a check
+   failed.  Chip tests and benchmarks get the chip to load as their
+   argument and hand it to the library through xtensaconfig_string, the
+   option value of option_gdb.c.  */
+
+extern const char *xtensaconfig_string;
+
+static int test_failures;
+
+#define CHECK(cond) \
+  do \
+  { \
+    if (!(cond)) \
+    { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      test_failures++; \
+    } \
+  } while (0)
+
+static inline int test_result(const char *name)
+{
+  printf("%s%s%s: %s\n", name, xtensaconfig_string ? " " : "", xtensaconfig_string ? xtensaconfig_string : "",
+         test_failures ? "FAIL" : "ok");
+  return test_failures != 0;
+}
+
+// The chip of a chip test or benchmark, made the one the library loads
+static inline const char *test_chip(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s CHIP\n", argv[0]);
+    exit(2);
+  }
+  xtensaconfig_string = argv[1];
+  return argv[1];
+}
+
+// Monotonic time in seconds, for the benchmarks
+static inline double test_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Path of the library of CHIP for tool VARIANT, or of the full library
+// if VARIANT is null, where the tests install them: in lib next to the
+// bin directory of the program
+static inline void test_lib_path(char *path, size_t size, const char *chip, const char *variant)
+{
+  char exe[4096];
+  ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+  char *slash = NULL;
+  int i = 0;
+
+  exe[len > 0 ? len : 0] = '\0';
+  for (i = 0; i < 2 && (slash = strrchr(exe, '/')) != NULL; i++)
+  {
+    *slash = '\0';
+  }
+  if (snprintf(path, size, "%s/lib/xtensaconfig-%s%s%s.so", exe, chip, variant ? "-" : "", variant ? variant : "")
+      >= (int) size)
+  {
+    abort();
+  }
+}
+
+#endif /* !XTENSA_CONFIG_TEST_H */
@@ -0,0 +1,145 @@
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/traits.hpp"
+#include "test.h"
+
+// Every xtensa_config value as T (prefix, member), in struct order, for
+// chip<Tag>::member and xtensa_config::prefix_member
+#define TRAITS_LIST(T) \
+  T(xchal, have_be) \
+  T(xchal, have_density) \
+  T(xchal, have_const16) \
+  T(xchal, have_abs) \
+  T(xchal, have_addx) \
+  T(xchal, have_l32r) \
+  T(xshal, use_absolute_literals) \
+  T(xshal, have_text_section_literals) \
+  T(xchal, have_mac16) \
+  T(xchal, have_mul16) \
+  T(xchal, have_mul32) \
+  T(xchal, have_mul32_high) \
+  T(xchal, have_div32) \
+  T(xchal, have_nsa) \
+  T(xchal, have_minmax) \
+  T(xchal, have_sext) \
+  T(xchal, have_loops) \
+  T(xchal, have_threadptr) \
+  T(xchal, have_release_sync) \
+  T(xchal, have_s32c1i) \
+  T(xchal, have_booleans) \
+  T(xchal, have_fp) \
+  T(xchal, have_fp_div) \
+  T(xchal, have_fp_recip) \
+  T(xchal, have_fp_sqrt) \
+  T(xchal, have_fp_rsqrt) \
+  T(xchal, have_fp_postinc) \
+  T(xchal, have_dfp) \
+  T(xchal, have_dfp_div) \
+  T(xchal, have_dfp_recip) \
+  T(xchal, have_dfp_sqrt) \
+  T(xchal, have_dfp_rsqrt) \
+  T(xchal, have_windowed) \
+  T(xchal, num_aregs) \
+  T(xchal, have_wide_branches) \
+  T(xchal, have_predicted_branches) \
+  T(xchal, icache_size) \
+  T(xchal, dcache_size) \
+  T(xchal, icache_linesize) \
+  T(xchal, dcache_linesize) \
+  T(xchal, icache_linewidth) \
+  T(xchal, dcache_linewidth) \
+  T(xchal, dcache_is_writeback) \
+  T(xchal, have_mmu) \
+  T(xchal, mmu_min_pte_page_size) \
+  T(xchal, have_debug) \
+  T(xchal, num_ibreak) \
+  T(xchal, num_dbreak) \
+  T(xchal, debuglevel) \
+  T(xchal, max_instruction_size) \
+  T(xchal, inst_fetch_width) \
+  T(xshal, abi) \
+  T(xthal, abi_windowed) \
+  T(xthal, abi_call0)
+
+#undef XTENSA_CONFIG_ENTRY
+#define XTENSA_CONFIG_ENTRY(a) 0
+static const int s_config_entries[] = {XTENSA_CONFIG_ENTRY_LIST};
+#undef XTENSA_CONFIG_ENTRY
+#define XTENSA_CONFIG_ENTRY(a) a
+
+#define TRAIT_COUNT(prefix, member) +1
+static_assert(0 TRAITS_LIST(TRAIT_COUNT) == sizeof(s_config_entries) / sizeof(s_config_entries[0]),
+              "TRAITS_LIST misses xtensa_config values");
+
+// The constexpr members of the chip are the values it loads with
+template <typename Tag>
+static void check_values(xtensa::chip<Tag>, const struct xtensa_config *config)
+{
+  const unsigned int *first = &config->xchal_have_be;
+  long i = 0;
+
+#define CHECK_TRAIT(prefix, member) \
+  CHECK(xtensa::chip<Tag>::member == config->prefix##_##member); \
+  CHECK(&config->prefix##_##member - first == i++);
+  TRAITS_LIST(CHECK_TRAIT)
+#undef CHECK_TRAIT
+}
+
+// dispatch calls F once, with the chip of Tag, for its name in a buffer
+// of its own
+template <typename Tag, typename... Tags>
+static int check_dispatch_chip(xtensa::chip_list<Tags...> list)
+{
+  char name[256];
+  int calls = 0;
+
+  CHECK(std::strlen(xtensa::chip<Tag>::name) < sizeof(name));
+  std::strncpy(name, xtensa::chip<Tag>::name, sizeof(name) - 1);
+  name[sizeof(name) - 1] = '\0';
+  CHECK(xtensa::dispatch(name,
+                         [&](auto chip)
+                         {
+                           CHECK((std::is_same<decltype(chip), xtensa::chip<Tag>>::value));
+                           calls++;
+                         },
+                         list));
+  CHECK(calls == 1);
+  return 0;
+}
+
+template <typename... Tags>
+static void check_dispatch(xtensa::chip_list<Tags...> list)
+{
+  int calls = 0;
+  auto count = [&](auto) { calls++; };
+
+  (void) std::initializer_list<int> {check_dispatch_chip<Tags>(list)...};
+
+  // Other names, and none, find no chip
+  CHECK(!xtensa::dispatch("default", count, list));
+  CHECK(!xtensa::dispatch("", count, list));
+  CHECK(!xtensa::dispatch(nullptr, count, list));
+  CHECK(calls == 0);
+}
+
+int main(int argc, char **argv)
+{
+  const char *chip = test_chip(argc, argv);
+  int calls = 0;
+
+  check_dispatch(xtensa::all_chips());
+
+  // The chip selected at runtime, with the values of its library
+  CHECK(xtensa::dispatch(
+    [&](auto traits)
+    {
+      CHECK(std::strcmp(decltype(traits)::name, chip) == 0);
+      check_values(traits, xtensa_get_config(-1));
+      calls++;
+    }));
+  CHECK(calls == 1);
+  return test_result("traits");
+}
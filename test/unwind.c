@@ -0,0 +1,87 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensaconfig/unwind.h"
+#include "winstack.h"
+#include "test.h"
+
+#define STACKS 3000
+#define MAX_FRAMES 64
+
+static int frames_equal(const struct xtensa_unwind_frame *a, const struct xtensa_unwind_frame *b)
+{
+  return a->pc == b->pc && a->sp == b->sp && memcmp(a->a, b->a, sizeof(a->a)) == 0 && a->window == b->window
+         && a->spilled == b->spilled;
+}
+
+static void check_frames(const struct test_winstack *stack, const struct xtensa_unwind_frame *frames, int n)
+{
+  int k = 0;
+
+  for (k = 0; k < n; k++)
+  {
+    CHECK(frames_equal(&frames[k], &stack->expected[k]));
+  }
+}
+
+int main(void)
+{
+  static const int num_aregs[] = { 16, 32, 64 };
+  struct xtensa_unwind_frame frames[MAX_FRAMES + 8];
+  struct test_winstack stack;
+  unsigned int seed = 1;
+  int a = 0, be = 0, i = 0, n = 0, num_frames = 0, first = 0;
+
+  for (a = 0; a < (int) (sizeof(num_aregs) / sizeof(num_aregs[0])); a++)
+  {
+    for (be = 0; be <= 1; be++)
+    {
+      for (i = 0; i < STACKS && !test_failures; i++)
+      {
+        num_frames = 1 + rand_r(&seed) % MAX_FRAMES;
+        if (test_winstack_build(&stack, num_aregs[a], num_frames, 1 + rand_r(&seed) % (num_aregs[a] / 4), be,
+                                &seed) != 0)
+        {
+          abort();
+        }
+
+        // Every frame, with one read per spilled frame
+        n = xtensa_unwind_windowed(&stack.gregs, stack.num_aregs, &stack.target, frames, MAX_FRAMES + 8);
+        CHECK(n == num_frames);
+        check_frames(&stack, frames, n);
+        CHECK(stack.reads == num_frames - stack.num_live);
+
+        // As many frames as asked for
+        n = xtensa_unwind_windowed(&stack.gregs, stack.num_aregs, &stack.target, frames, num_frames / 2);
+        CHECK(n == num_frames / 2);
+        check_frames(&stack, frames, n);
+
+        first = stack.num_live;
+        if (first < num_frames)
+        {
+          // A failed read ends the walk before the frame
+          stack.fail_addr = stack.expected[first - 1].sp - 4;
+          n = xtensa_unwind_windowed(&stack.gregs, stack.num_aregs, &stack.target, frames, MAX_FRAMES + 8);
+          CHECK(n == first);
+          check_frames(&stack, frames, n);
+          stack.fail_addr = 0;
+
+          // So does a stack pointer that goes down
+          test_winstack_store(&stack, stack.expected[first - 1].sp - 12, stack.expected[first - 1].sp - 16);
+          n = xtensa_unwind_windowed(&stack.gregs, stack.num_aregs, &stack.target, frames, MAX_FRAMES + 8);
+          CHECK(n == first);
+          check_frames(&stack, frames, n);
+        }
+        test_winstack_free(&stack);
+      }
+    }
+  }
+
+  // Register files the windowed option does not have are refused
+  memset(&stack, 0, sizeof(stack));
+  CHECK(xtensa_unwind_windowed(&stack.gregs, 8, &stack.target, frames, 1) == -1);
+  CHECK(xtensa_unwind_windowed(&stack.gregs, 48, &stack.target, frames, 1) == -1);
+
+  return test_result("unwind");
+}
@@ -0,0 +1,165 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "winstack.h"
+
+#define STACK_BASE 0x3ffb0000u
+#define STACK_MARGIN 1024
+#define ADDR_MASK 0x3fffffffu
+
+static uint32_t next_random(unsigned int *seed)
+{
+  uint32_t v = 0;
+
+  *seed = *seed * 1103515245 + 12345;
+  v = *seed >> 16;
+  *seed = *seed * 1103515245 + 12345;
+  return v | (*seed >> 16) << 16;
+}
+
+static int winstack_read(void *ctx, uint32_t addr, void *buf, size_t len)
+{
+  struct test_winstack *stack = ctx;
+
+  stack->reads++;
+  if (addr < stack->mem_base || addr - stack->mem_base > stack->mem_size
+      || len > stack->mem_size - (addr - stack->mem_base) || (stack->fail_addr != 0 && stack->fail_addr >= addr && stack->fail_addr < addr + len))
+  {
+    return -1;
+  }
+  memcpy(buf, stack->mem + (addr - stack->mem_base), len);
+  return 0;
+}
+
+void test_winstack_store(struct test_winstack *stack, uint32_t addr, uint32_t value)
+{
+  unsigned char *p = stack->mem + (addr - stack->mem_base);
+  int i = 0;
+
+  for (i = 0; i < 4; i++)
+  {
+    p[stack->target.big_endian ? 3 - i : i] = value >> (8 * i);
+  }
+}
+
+// The number of live frames: below MAX_LIVE, within one turn of the
+// windows, and so that the first spilled frame's window is not one of
+// theirs (windowstart would then claim it live)
+static int winstack_live(const struct test_winstack *stack, const int *sum, int max_live)
+{
+  int num_windows = stack->num_aregs / 4, live = 1, j = 0;
+
+  while (live < stack->num_frames && live < max_live && sum[live] < num_windows)
+  {
+    live++;
+  }
+  for (j = 1; live < stack->num_frames && j < live; j++)
+  {
+    if (stack->expected[j].window == stack->expected[live].window)
+    {
+      live = j;
+    }
+  }
+  return live;
+}
+
+int test_winstack_build(struct test_winstack *stack, int num_aregs, int num_frames, int max_live, int big_endian,
+                        unsigned int *seed)
+{
+  int num_windows = num_aregs / 4, k = 0, i = 0;
+  int *callinc = calloc(num_frames + 1, sizeof(int));
+  int *sum = calloc(num_frames + 1, sizeof(int));
+  uint32_t sp = STACK_BASE + STACK_MARGIN;
+
+  memset(stack, 0, sizeof(*stack));
+  stack->num_aregs = num_aregs;
+  stack->num_frames = num_frames;
+  stack->expected = calloc(num_frames, sizeof(*stack->expected));
+  stack->target.big_endian = big_endian;
+  stack->target.read_memory = winstack_read;
+  stack->target.ctx = stack;
+  if (callinc == NULL || sum == NULL || stack->expected == NULL)
+  {
+    free(callinc);
+    free(sum);
+    return -1;
+  }
+
+  // Frames from the innermost out, each with a growing stack pointer
+  for (k = 0; k < num_frames; k++)
+  {
+    struct xtensa_unwind_frame *f = &stack->expected[k];
+
+    callinc[k] = k + 1 < num_frames ? 1 + next_random(seed) % 3 : 0;
+    sum[k + 1] = sum[k] + callinc[k];
+    f->window = k == 0 ? (int) (next_random(seed) % num_windows)
+                       : (stack->expected[k - 1].window - callinc[k - 1] + num_windows) % num_windows;
+    f->pc = 0x40080000u | (next_random(seed) & 0x7fffc);
+    f->sp = sp;
+    sp += 32 + 16 * (next_random(seed) % 8);
+  }
+  for (k = 0; k < num_frames; k++)
+  {
+    struct xtensa_unwind_frame *f = &stack->expected[k];
+
+    f->a[0] = k + 1 < num_frames ? (uint32_t) callinc[k] << 30 | (stack->expected[k + 1].pc & ADDR_MASK) : 0;
+    f->a[1] = f->sp;
+    f->a[2] = next_random(seed);
+    f->a[3] = next_random(seed);
+  }
+  stack->num_live = winstack_live(stack, sum, max_live);
+
+  stack->mem_base = STACK_BASE;
+  stack->mem_size = sp + STACK_MARGIN - STACK_BASE;
+  stack->mem = malloc(stack->mem_size);
+  if (stack->mem == NULL)
+  {
+    free(callinc);
+    free(sum);
+    return -1;
+  }
+  for (i = 0; i < (int) stack->mem_size; i++)
+  {
+    stack->mem[i] = next_random(seed);
+  }
+
+  // Live frames in the register file, spilled ones below their callee's
+  // stack pointer
+  stack->gregs.pc = stack->expected[0].pc;
+  stack->gregs.windowbase = stack->expected[0].window;
+  for (i = 0; i < num_aregs; i++)
+  {
+    stack->gregs.ar[i] = next_random(seed);
+  }
+  for (k = 0; k < num_frames; k++)
+  {
+    struct xtensa_unwind_frame *f = &stack->expected[k];
+
+    f->spilled = k >= stack->num_live;
+    for (i = 0; i < 4; i++)
+    {
+      if (f->spilled)
+      {
+        test_winstack_store(stack, stack->expected[k - 1].sp - 16 + 4 * i, f->a[i]);
+      }
+      else
+      {
+        stack->gregs.ar[(f->window * 4 + i) % num_aregs] = f->a[i];
+      }
+    }
+    if (!f->spilled)
+    {
+      stack->gregs.windowstart |= 1u << f->window;
+    }
+  }
+  free(callinc);
+  free(sum);
+  return 0;
+}
+
+void test_winstack_free(struct test_winstack *stack)
+{
+  free(stack->expected);
+  free(stack->mem);
+}
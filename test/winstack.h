@@ -0,0 +1,58 @@
+/* Synthetic windowed ABI call stacks, for tests.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef XTENSA_CONFIG_TEST_WINSTACK_H
+#define XTENSA_CONFIG_TEST_WINSTACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arch/xtensa.h"
+#include "xtensaconfig/unwind.h"
+
+/* A chain of NUM_FRAMES windowed calls of random increments, frame 0
+   the innermost: the frames the unwinder must find, the registers with
+   the first NUM_LIVE frames still in the register file, and the stack
+   memory with the base save areas of the others.  Stack reads go
+   through TARGET and are counted.  */
+
+struct test_winstack
+{
+  int num_aregs;
+  int num_frames;
+  int num_live;
+  xtensa_elf_gregset_t gregs;
+  struct xtensa_unwind_frame *expected;
+  struct xtensa_unwind_target target;
+  uint32_t mem_base;
+  uint32_t mem_size;
+  unsigned char *mem;
+  uint32_t fail_addr;		/* Reads covering it fail, if not 0.  */
+  long reads;
+};
+
+/* Build STACK with at most MAX_LIVE live frames from *SEED; return 0,
+   or -1 if out of memory.  */
+int test_winstack_build (struct test_winstack *stack, int num_aregs,
+			 int num_frames, int max_live, int big_endian,
+			 unsigned int *seed);
+void test_winstack_free (struct test_winstack *stack);
+
+/* Store the 32-bit VALUE at ADDR of the stack memory.  */
+void test_winstack_store (struct test_winstack *stack, uint32_t addr,
+			  uint32_t value);
+
+#endif /* !XTENSA_CONFIG_TEST_WINSTACK_H */
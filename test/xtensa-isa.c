@@ -0,0 +1,252 @@
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+
+// The part of the xtensa-isa.h API the generic decoder, the prologue
+// analysis and the resources test use, for tests linked without binutils:
+// little-endian and straight over the tables, without the argument checks
+// of bfd/xtensa-isa.c
+
+#define INTISA(isa) ((xtensa_isa_internal *) (isa))
+
+static xtensa_slot_internal *format_slot(xtensa_isa isa, xtensa_format fmt, int slot)
+{
+  return &INTISA(isa)->slots[INTISA(isa)->formats[fmt].slot_id[slot]];
+}
+
+static xtensa_operand_internal *opcode_operand(xtensa_isa isa, xtensa_opcode opc, int opnd)
+{
+  xtensa_iclass_internal *iclass = &INTISA(isa)->iclasses[INTISA(isa)->opcodes[opc].iclass_id];
+
+  return &INTISA(isa)->operands[iclass->operands[opnd].u.operand_id];
+}
+
+int xtensa_isa_num_formats(xtensa_isa isa)
+{
+  return INTISA(isa)->num_formats;
+}
+
+int xtensa_isa_num_opcodes(xtensa_isa isa)
+{
+  return INTISA(isa)->num_opcodes;
+}
+
+int xtensa_isa_num_funcUnits(xtensa_isa isa)
+{
+  return INTISA(isa)->num_funcUnits;
+}
+
+int xtensa_insnbuf_size(xtensa_isa isa)
+{
+  return INTISA(isa)->insnbuf_size;
+}
+
+int xtensa_isa_length_from_chars(xtensa_isa isa, const unsigned char *cp)
+{
+  return INTISA(isa)->length_decode_fn(cp);
+}
+
+void xtensa_insnbuf_from_chars(xtensa_isa isa, xtensa_insnbuf insn, const unsigned char *cp, int num_chars)
+{
+  int i = 0;
+
+  memset(insn, 0, INTISA(isa)->insnbuf_size * sizeof(xtensa_insnbuf_word));
+  for (i = 0; i < num_chars; i++)
+  {
+    insn[i / 4] |= (xtensa_insnbuf_word) cp[i] << ((i & 3) * 8);
+  }
+}
+
+int xtensa_insnbuf_to_chars(xtensa_isa isa, const xtensa_insnbuf insn, unsigned char *cp, int num_chars)
+{
+  int i = 0;
+
+  (void) isa;
+  for (i = 0; i < num_chars; i++)
+  {
+    cp[i] = (insn[i / 4] >> ((i & 3) * 8)) & 0xff;
+  }
+  return num_chars;
+}
+
+xtensa_format xtensa_format_decode(xtensa_isa isa, const xtensa_insnbuf insn)
+{
+  return INTISA(isa)->format_decode_fn(insn);
+}
+
+int xtensa_format_encode(xtensa_isa isa, xtensa_format fmt, xtensa_insnbuf insn)
+{
+  memset(insn, 0, INTISA(isa)->insnbuf_size * sizeof(xtensa_insnbuf_word));
+  INTISA(isa)->formats[fmt].encode_fn(insn);
+  return 0;
+}
+
+int xtensa_format_length(xtensa_isa isa, xtensa_format fmt)
+{
+  return INTISA(isa)->formats[fmt].length;
+}
+
+int xtensa_format_num_slots(xtensa_isa isa, xtensa_format fmt)
+{
+  return INTISA(isa)->formats[fmt].num_slots;
+}
+
+int xtensa_format_get_slot(xtensa_isa isa, xtensa_format fmt, int slot, const xtensa_insnbuf insn,
+                           xtensa_insnbuf slotbuf)
+{
+  format_slot(isa, fmt, slot)->get_fn(insn, slotbuf);
+  return 0;
+}
+
+int xtensa_format_set_slot(xtensa_isa isa, xtensa_format fmt, int slot, xtensa_insnbuf insn,
+                           const xtensa_insnbuf slotbuf)
+{
+  format_slot(isa, fmt, slot)->set_fn(insn, slotbuf);
+  return 0;
+}
+
+xtensa_opcode xtensa_opcode_decode(xtensa_isa isa, xtensa_format fmt, int slot, const xtensa_insnbuf slotbuf)
+{
+  return format_slot(isa, fmt, slot)->opcode_decode_fn(slotbuf);
+}
+
+int xtensa_opcode_encode(xtensa_isa isa, xtensa_format fmt, int slot, xtensa_insnbuf slotbuf, xtensa_opcode opc)
+{
+  xtensa_opcode_encode_fn encode_fn = NULL;
+
+  if (opc < 0 || opc >= INTISA(isa)->num_opcodes)
+  {
+    return -1;
+  }
+  encode_fn = INTISA(isa)->opcodes[opc].encode_fns[INTISA(isa)->formats[fmt].slot_id[slot]];
+  if (encode_fn == NULL)
+  {
+    return -1;
+  }
+  encode_fn(slotbuf);
+  return 0;
+}
+
+int xtensa_opcode_num_operands(xtensa_isa isa, xtensa_opcode opc)
+{
+  return INTISA(isa)->iclasses[INTISA(isa)->opcodes[opc].iclass_id].num_operands;
+}
+
+int xtensa_operand_get_field(xtensa_isa isa, xtensa_opcode opc, int opnd, xtensa_format fmt, int slot,
+                             const xtensa_insnbuf slotbuf, uint32 *valp)
+{
+  int field_id = opcode_operand(isa, opc, opnd)->field_id;
+  xtensa_get_field_fn get_fn = NULL;
+
+  if (field_id == XTENSA_UNDEFINED || (get_fn = format_slot(isa, fmt, slot)->get_field_fns[field_id]) == NULL)
+  {
+    return -1;
+  }
+  *valp = get_fn(slotbuf);
+  return 0;
+}
+
+int xtensa_operand_set_field(xtensa_isa isa, xtensa_opcode opc, int opnd, xtensa_format fmt, int slot,
+                             xtensa_insnbuf slotbuf, uint32 val)
+{
+  int field_id = opcode_operand(isa, opc, opnd)->field_id;
+  xtensa_set_field_fn set_fn = NULL;
+
+  if (field_id == XTENSA_UNDEFINED || (set_fn = format_slot(isa, fmt, slot)->set_field_fns[field_id]) == NULL)
+  {
+    return -1;
+  }
+  set_fn(slotbuf, val);
+  return 0;
+}
+
+xtensa_opcode xtensa_opcode_lookup(xtensa_isa isa, const char *opname)
+{
+  int opc = 0;
+
+  for (opc = 0; opc < INTISA(isa)->num_opcodes; opc++)
+  {
+    if (strcasecmp(INTISA(isa)->opcodes[opc].name, opname) == 0)
+    {
+      return opc;
+    }
+  }
+  return XTENSA_UNDEFINED;
+}
+
+static int opcode_flag(xtensa_isa isa, xtensa_opcode opc, uint32 flag)
+{
+  return (INTISA(isa)->opcodes[opc].flags & flag) != 0;
+}
+
+int xtensa_opcode_is_branch(xtensa_isa isa, xtensa_opcode opc)
+{
+  return opcode_flag(isa, opc, XTENSA_OPCODE_IS_BRANCH);
+}
+
+int xtensa_opcode_is_jump(xtensa_isa isa, xtensa_opcode opc)
+{
+  return opcode_flag(isa, opc, XTENSA_OPCODE_IS_JUMP);
+}
+
+int xtensa_opcode_is_loop(xtensa_isa isa, xtensa_opcode opc)
+{
+  return opcode_flag(isa, opc, XTENSA_OPCODE_IS_LOOP);
+}
+
+int xtensa_opcode_is_call(xtensa_isa isa, xtensa_opcode opc)
+{
+  return opcode_flag(isa, opc, XTENSA_OPCODE_IS_CALL);
+}
+
+char xtensa_operand_inout(xtensa_isa isa, xtensa_opcode opc, int opnd)
+{
+  return INTISA(isa)->iclasses[INTISA(isa)->opcodes[opc].iclass_id].operands[opnd].inout;
+}
+
+int xtensa_operand_decode(xtensa_isa isa, xtensa_opcode opc, int opnd, uint32 *valp)
+{
+  xtensa_operand_internal *operand = opcode_operand(isa, opc, opnd);
+
+  return operand->decode != NULL && operand->decode(valp) ? -1 : 0;
+}
+
+int xtensa_operand_is_register(xtensa_isa isa, xtensa_opcode opc, int opnd)
+{
+  return (opcode_operand(isa, opc, opnd)->flags & XTENSA_OPERAND_IS_REGISTER) != 0;
+}
+
+xtensa_regfile xtensa_operand_regfile(xtensa_isa isa, xtensa_opcode opc, int opnd)
+{
+  return opcode_operand(isa, opc, opnd)->regfile;
+}
+
+const char *xtensa_regfile_shortname(xtensa_isa isa, xtensa_regfile rf)
+{
+  return INTISA(isa)->regfiles[rf].shortname;
+}
+
+int xtensa_operand_encode(xtensa_isa isa, xtensa_opcode opc, int opnd, uint32 *valp)
+{
+  xtensa_operand_internal *operand = opcode_operand(isa, opc, opnd);
+
+  return operand->encode != NULL && operand->encode(valp) ? -1 : 0;
+}
+
+int xtensa_opcode_num_funcUnit_uses(xtensa_isa isa, xtensa_opcode opc)
+{
+  return INTISA(isa)->opcodes[opc].num_funcUnit_uses;
+}
+
+xtensa_funcUnit_use *xtensa_opcode_funcUnit_use(xtensa_isa isa, xtensa_opcode opc, int u)
+{
+  return &INTISA(isa)->opcodes[opc].funcUnit_uses[u];
+}
+
+int xtensa_funcUnit_num_copies(xtensa_isa isa, xtensa_funcUnit fun)
+{
+  return INTISA(isa)->funcUnits[fun].num_copies;
+}
@@ -0,0 +1,122 @@
+// Compatibility matrix of chip libraries.
+//
+// Loads every xtensaconfig-<chip>.so or build-machine
+// xtensaconfig-<chip>-host.so given on the command line, prints for each
+// pair whether code built for the row chip is valid ("ok"), identical ("=")
+// or invalid ("-") for the column chip, and then the classes of chips for
+// which code generation is identical, so that chip-independent libraries
+// can be built once per class.  The scheduling tables count when the
+// libraries have them.
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/compat.h"
+#include "xtensaconfig/sched.h"
+
+static void print_chip(const char *path)
+{
+  static const char prefix[] = "xtensaconfig-";
+  const char *base = strrchr(path, '/');
+  const char *name = strstr(base ? base + 1 : path, prefix);
+  const char *end = NULL;
+
+  name = name ? name + sizeof(prefix) - 1 : path;
+  end = strstr(name, "-host.so");
+  end = end ? end : strstr(name, ".so");
+  printf("%.*s", (int) (end ? end - name : (long) strlen(name)), name);
+}
+
+int main(int argc, char **argv)
+{
+  int n = argc - 1, i = 0, j = 0, num_classes = 0;
+  const struct xtensa_config **configs = NULL;
+  const struct xtensa_sched_tables **scheds = NULL;
+  int *class_ids = NULL;
+
+  if (n < 1)
+  {
+    fprintf(stderr, "usage: %s <xtensaconfig-chip.so>...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  configs = calloc(n, sizeof(*configs));
+  scheds = calloc(n, sizeof(*scheds));
+  class_ids = calloc(n, sizeof(*class_ids));
+  if (!configs || !scheds || !class_ids)
+  {
+    fprintf(stderr, "out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    void *handle = dlopen(argv[i + 1], RTLD_LAZY | RTLD_LOCAL);
+
+    if (!handle)
+    {
+      fprintf(stderr, "%s\n", dlerror());
+      return EXIT_FAILURE;
+    }
+    configs[i] = dlsym(handle, "xtensa_config");
+    if (!configs[i])
+    {
+      fprintf(stderr, "%s: no xtensa_config\n", argv[i + 1]);
+      return EXIT_FAILURE;
+    }
+    if (configs[i]->config_size != sizeof(struct xtensa_config))
+    {
+      fprintf(stderr, "%s: config size %lu, expected %lu\n", argv[i + 1], configs[i]->config_size,
+              (unsigned long) sizeof(struct xtensa_config));
+      return EXIT_FAILURE;
+    }
+    scheds[i] = dlsym(handle, "xtensa_sched_tables_data");
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    print_chip(argv[i + 1]);
+    printf(":");
+    for (j = 0; j < n; j++)
+    {
+      const char *field = NULL;
+
+      switch (xtensa_config_compare(configs[i], scheds[i], configs[j], scheds[j], &field))
+      {
+      case XTENSA_CONFIG_IDENTICAL:
+        printf(" =");
+        break;
+      case XTENSA_CONFIG_COMPATIBLE:
+        printf(" ok(%s)", field);
+        break;
+      default:
+        printf(" -(%s)", field);
+        break;
+      }
+    }
+    printf("\n");
+  }
+
+  num_classes = xtensa_config_classes(configs, scheds, n, class_ids);
+  for (i = 0; i < num_classes; i++)
+  {
+    printf("class %d:", i);
+    for (j = 0; j < n; j++)
+    {
+      if (class_ids[j] == i)
+      {
+        printf(" ");
+        print_chip(argv[j + 1]);
+      }
+    }
+    printf("\n");
+  }
+
+  free(class_ids);
+  free(scheds);
+  free(configs);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,1446 @@
+// Build-time generator for per-chip tables.
+//
+// It is linked with the sources of one chip library and runs on the build
+// host; every command prints a C source file to stdout that is then
+// compiled into the chip library.
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "xtensa-isa.h"
+#include "xtensa-isa-internal.h"
+#include "xtensaconfig/dynconfig.h"
+#include "xtensaconfig/fingerprint.h"
+#include "xtensaconfig/decoder.h"
+#include "xtensaconfig/regseq.h"
+#include "xtensaconfig/gpacket.h"
+#include "xtensaconfig/composite.h"
+#include "xtensaconfig/regindex.h"
+#include "xtensaconfig/sched.h"
+#include "xtensa-tdep.h"
+
+extern struct xtensa_config xtensa_config;
+extern const char *xtensa_config_strings[];
+extern xtensa_isa_internal xtensa_modules;
+extern xtensa_register_t xtensa_rmap[];
+
+// Chip name, passed by the Makefile
+#ifndef XTENSACONFIG_CHIP
+#define XTENSACONFIG_CHIP "default"
+#endif
+
+#undef XTENSA_CONFIG_ENTRY
+#define XTENSA_CONFIG_ENTRY(a) #a
+static const char *const s_config_names[] =
+{
+  XTENSA_CONFIG_ENTRY_LIST
+};
+#undef XTENSA_CONFIG_ENTRY
+
+static void print_header(FILE *out)
+{
+  fprintf(out, "/* Generated by xtensaconfig-gen, do not edit.  */\n\n");
+}
+
+static int gen_fingerprint(FILE *out)
+{
+  struct xtensa_fingerprint fp;
+  int i = 0;
+
+  xtensa_fingerprint_compute(&fp, &xtensa_config, xtensa_config_strings, &xtensa_modules);
+
+  print_header(out);
+  fprintf(out, "#include \"xtensaconfig/fingerprint.h\"\n\n");
+  fprintf(out, "const struct xtensa_fingerprint xtensa_config_fingerprint_data =\n{\n  {");
+  for (i = 0; i < XTENSA_FINGERPRINT_SIZE; i++)
+  {
+    fprintf(out, "%s0x%02x", i ? ", " : " ", fp.bytes[i]);
+  }
+  fprintf(out, " }\n};\n");
+  return 0;
+}
+
+// C++ keywords and alternative tokens, which no traits name may be
+static const char *const s_cxx_keywords[] =
+{
+  "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch", "char",
+  "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr", "constinit",
+  "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete", "do", "double",
+  "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto", "if",
+  "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or",
+  "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "requires", "return", "short",
+  "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this",
+  "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual",
+  "void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+};
+
+#define TRAITS_MAX_NAME 128
+
+// Whether NAME can be declared as is in a C++ scope: an identifier that
+// is no keyword and not reserved to the implementation
+static int traits_identifier(const char *name)
+{
+  const char *c = name;
+  size_t i = 0;
+
+  if (!isalpha((unsigned char) *c) || strstr(name, "__") != NULL)
+  {
+    return 0;
+  }
+  for (; *c; c++)
+  {
+    if (!isalnum((unsigned char) *c) && *c != '_')
+    {
+      return 0;
+    }
+  }
+  for (i = 0; i < sizeof(s_cxx_keywords) / sizeof(s_cxx_keywords[0]); i++)
+  {
+    if (strcmp(name, s_cxx_keywords[i]) == 0)
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// C++ traits of the chip for xtensaconfig/traits.hpp: XCHAL_HAVE_LOOPS
+// becomes chip<tag>::have_loops.  Names that are no identifiers, or that
+// clash with another member or with the declarations of traits.hpp, fail
+// the build rather than the compilation of some later tool
+static int gen_traits(FILE *out)
+{
+  static const char *const traits_names[] = {"chip", "chip_list", "all_chips", "dispatch"};
+  const unsigned int *fields = &xtensa_config.xchal_have_be;
+  size_t num_names = sizeof(s_config_names) / sizeof(s_config_names[0]);
+  char (*names)[TRAITS_MAX_NAME] = calloc(num_names, TRAITS_MAX_NAME);
+  size_t i = 0, j = 0;
+  int ret = 0;
+
+  if (names == NULL)
+  {
+    fprintf(stderr, "xtensaconfig-gen: %s: out of memory\n", XTENSACONFIG_CHIP);
+    return 1;
+  }
+  if (!traits_identifier(XTENSACONFIG_CHIP))
+  {
+    fprintf(stderr, "xtensaconfig-gen: %s: chip name is not a usable C++ identifier\n", XTENSACONFIG_CHIP);
+    ret = 1;
+  }
+  for (i = 0; i < sizeof(traits_names) / sizeof(traits_names[0]); i++)
+  {
+    if (strcmp(XTENSACONFIG_CHIP, traits_names[i]) == 0)
+    {
+      fprintf(stderr, "xtensaconfig-gen: %s: chip name clashes with xtensa::%s\n", XTENSACONFIG_CHIP,
+              traits_names[i]);
+      ret = 1;
+    }
+  }
+
+  for (i = 0; i < num_names; i++)
+  {
+    const char *c = strchr(s_config_names[i], '_');
+
+    if (c == NULL || strlen(c + 1) >= TRAITS_MAX_NAME)
+    {
+      fprintf(stderr, "xtensaconfig-gen: %s: no traits name for %s\n", XTENSACONFIG_CHIP, s_config_names[i]);
+      ret = 1;
+      continue;
+    }
+    for (c++, j = 0; *c; c++, j++)
+    {
+      names[i][j] = tolower((unsigned char) *c);
+    }
+    if (!traits_identifier(names[i]) || strcmp(names[i], "name") == 0)
+    {
+      fprintf(stderr, "xtensaconfig-gen: %s: traits name %s of %s is not a member name\n", XTENSACONFIG_CHIP,
+              names[i], s_config_names[i]);
+      ret = 1;
+    }
+    for (j = 0; j < i; j++)
+    {
+      if (strcmp(names[i], names[j]) == 0)
+      {
+        fprintf(stderr, "xtensaconfig-gen: %s: %s and %s are both traits %s\n", XTENSACONFIG_CHIP,
+                s_config_names[j], s_config_names[i], names[i]);
+        ret = 1;
+      }
+    }
+  }
+
+  if (ret == 0)
+  {
+    print_header(out);
+    fprintf(out, "namespace xtensa\n{\n\nstruct %s {};\n\n", XTENSACONFIG_CHIP);
+    fprintf(out, "template <>\nstruct chip<%s>\n{\n", XTENSACONFIG_CHIP);
+    fprintf(out, "  static constexpr const char *name = \"%s\";\n", XTENSACONFIG_CHIP);
+    for (i = 0; i < num_names; i++)
+    {
+      fprintf(out, "  static constexpr unsigned int %s = %u;\n", names[i], fields[i]);
+    }
+    fprintf(out, "};\n\n}\n");
+  }
+  free(names);
+  return ret;
+}
+
+// Shape of the ISA for lib_src/xtensa-decoder.c: every format with its
+// length and slot ids, so the decoder can unroll its slot loops; chips the
+// specialized decoder cannot handle get XTENSA_DECODER_SUPPORTED 0
+static int gen_decoder(FILE *out)
+{
+  const xtensa_isa_internal *isa = &xtensa_modules;
+  int supported = !isa->is_big_endian;
+  int i = 0, j = 0;
+
+  for (i = 0; i < isa->num_formats; i++)
+  {
+    supported &= isa->formats[i].num_slots <= XTENSA_DECODED_MAX_SLOTS;
+  }
+  for (i = 0; i < isa->num_iclasses; i++)
+  {
+    supported &= isa->iclasses[i].num_operands <= XTENSA_DECODED_MAX_OPERANDS;
+  }
+
+  print_header(out);
+  fprintf(out, "#define XTENSA_DECODER_SUPPORTED %d\n", supported);
+  fprintf(out, "#define XTENSA_DECODER_INSNBUF_SIZE %d\n\n", isa->insnbuf_size);
+
+  fprintf(out, "/* F (format, length, num_slots) for every format.  */\n#define XTENSA_DECODER_FORMATS(F)");
+  for (i = 0; i < isa->num_formats; i++)
+  {
+    fprintf(out, " \\\n  F (%d, %d, %d)", i, isa->formats[i].length, isa->formats[i].num_slots);
+  }
+  fprintf(out, "\n");
+
+  for (i = 0; i < isa->num_formats; i++)
+  {
+    fprintf(out, "\n/* S (slot, slot_id) for every slot of %s.  */\n", isa->formats[i].name);
+    fprintf(out, "#define XTENSA_DECODER_FORMAT_SLOTS_%d(S)", i);
+    for (j = 0; j < isa->formats[i].num_slots; j++)
+    {
+      fprintf(out, " \\\n  S (%d, %d)", j, isa->formats[i].slot_id[j]);
+    }
+    fprintf(out, "\n");
+  }
+  return 0;
+}
+
+// Assembler for the rmap fetch and store strings, encoding straight
+// through the chip tables like the specialized encoder does
+
+#define REGSEQ_MAX_BYTES 256
+#define REGSEQ_MAX_PATCHES 32
+#define REGSEQ_MAX_TEXT 256
+
+static xtensa_opcode regseq_opcode(const char *name)
+{
+  const xtensa_isa_internal *isa = &xtensa_modules;
+  int i = 0;
+
+  for (i = 0; i < isa->num_opcodes; i++)
+  {
+    if (strcasecmp(isa->opcodes[i].name, name) == 0)
+    {
+      return i;
+    }
+  }
+  return XTENSA_UNDEFINED;
+}
+
+// Encode OPC with the field values FIELDS (by iclass operand) into BUF in
+// the shortest format that has a slot for it, the other slots holding
+// their nop; returns the length or XTENSA_UNDEFINED
+static int regseq_encode(xtensa_opcode opc, const uint32 *fields, unsigned char *buf)
+{
+  const xtensa_isa_internal *isa = &xtensa_modules;
+  xtensa_iclass_internal *iclass = &isa->iclasses[isa->opcodes[opc].iclass_id];
+  xtensa_insnbuf_word insn[16], slotbuf[16];
+  int fmt = XTENSA_UNDEFINED, slot = 0, f = 0, s = 0, i = 0;
+
+  if (isa->insnbuf_size > 16)
+  {
+    return XTENSA_UNDEFINED;
+  }
+
+  for (f = 0; f < isa->num_formats; f++)
+  {
+    for (s = 0; s < isa->formats[f].num_slots; s++)
+    {
+      if (isa->opcodes[opc].encode_fns[isa->formats[f].slot_id[s]] != NULL
+          && (fmt == XTENSA_UNDEFINED || isa->formats[f].length < isa->formats[fmt].length))
+      {
+        fmt = f;
+        slot = s;
+      }
+    }
+  }
+  if (fmt == XTENSA_UNDEFINED)
+  {
+    return XTENSA_UNDEFINED;
+  }
+
+  memset(insn, 0, sizeof(insn));
+  isa->formats[fmt].encode_fn(insn);
+  for (s = 0; s < isa->formats[fmt].num_slots; s++)
+  {
+    int slot_id = isa->formats[fmt].slot_id[s];
+    xtensa_slot_internal *slot_int = &isa->slots[slot_id];
+    xtensa_opcode slot_opc = s == slot ? opc : regseq_opcode(slot_int->nop_name ? slot_int->nop_name : "");
+
+    if (slot_opc == XTENSA_UNDEFINED || isa->opcodes[slot_opc].encode_fns[slot_id] == NULL)
+    {
+      return XTENSA_UNDEFINED;
+    }
+    memset(slotbuf, 0, sizeof(slotbuf));
+    isa->opcodes[slot_opc].encode_fns[slot_id](slotbuf);
+    for (i = 0; s == slot && i < iclass->num_operands; i++)
+    {
+      xtensa_operand_internal *op = &isa->operands[iclass->operands[i].u.operand_id];
+
+      if (op->field_id == XTENSA_UNDEFINED || (op->flags & XTENSA_OPERAND_IS_INVISIBLE))
+      {
+        continue;
+      }
+      if (slot_int->set_field_fns[op->field_id] == NULL)
+      {
+        return XTENSA_UNDEFINED;
+      }
+      slot_int->set_field_fns[op->field_id](slotbuf, fields[i]);
+    }
+    slot_int->set_fn(insn, slotbuf);
+  }
+
+  // Byte order of xtensa_insnbuf_to_chars
+  for (i = 0; i < isa->formats[fmt].length; i++)
+  {
+    int byte = isa->is_big_endian ? isa->insn_size - 1 - i : i;
+
+    buf[i] = (insn[byte / 4] >> ((byte & 3) * 8)) & 0xff;
+  }
+  return isa->formats[fmt].length;
+}
+
+static int regseq_operand_value(xtensa_operand_internal *op, uint32 raw, uint32 *value)
+{
+  *value = raw;
+  return op->encode != NULL && op->encode(value) != 0 ? -1 : 0;
+}
+
+// Assemble one instruction TEXT into SEQ at *LENGTH, recording its
+// address register operands in PATCHES
+static int regseq_insn(char *text, unsigned char *seq, int *length, struct xtensa_regseq_patch *patches,
+                       int *num_patches)
+{
+  const xtensa_isa_internal *isa = &xtensa_modules;
+  xtensa_iclass_internal *iclass = NULL;
+  xtensa_opcode opc = XTENSA_UNDEFINED;
+  char *mnemonic = strtok(text, " \t");
+  char *args = strtok(NULL, "");
+  char *arg = NULL;
+  uint32 raw[XTENSA_DECODED_MAX_OPERANDS], fields[XTENSA_DECODED_MAX_OPERANDS];
+  unsigned char probe[REGSEQ_MAX_BYTES];
+  int len = 0, i = 0, k = 0, b = 0;
+
+  opc = regseq_opcode(mnemonic);
+  if (opc == XTENSA_UNDEFINED)
+  {
+    return -1;
+  }
+  iclass = &isa->iclasses[isa->opcodes[opc].iclass_id];
+  if (iclass->num_operands > XTENSA_DECODED_MAX_OPERANDS)
+  {
+    return -1;
+  }
+
+  memset(fields, 0, sizeof(fields));
+  arg = args ? strtok(args, ",") : NULL;
+  for (i = 0; i < iclass->num_operands; i++)
+  {
+    xtensa_operand_internal *op = &isa->operands[iclass->operands[i].u.operand_id];
+    char *end = NULL;
+
+    if (op->flags & XTENSA_OPERAND_IS_INVISIBLE)
+    {
+      continue;
+    }
+    if (arg == NULL || (op->flags & XTENSA_OPERAND_IS_PCRELATIVE))
+    {
+      return -1;
+    }
+    while (isspace((unsigned char) *arg))
+    {
+      arg++;
+    }
+
+    if (op->flags & XTENSA_OPERAND_IS_REGISTER)
+    {
+      xtensa_regfile_internal *rf = NULL;
+      size_t n = 0;
+
+      if (op->regfile < 0 || op->regfile >= isa->num_regfiles)
+      {
+        return -1;
+      }
+      rf = &isa->regfiles[op->regfile];
+      n = strlen(rf->shortname);
+      if (strncasecmp(arg, rf->shortname, n) != 0 || !isdigit((unsigned char) arg[n]))
+      {
+        return -1;
+      }
+      raw[i] = strtoul(arg + n, &end, 10);
+      if (raw[i] >= (uint32) rf->num_entries)
+      {
+        return -1;
+      }
+    }
+    else
+    {
+      raw[i] = strtol(arg, &end, 0);
+    }
+    while (isspace((unsigned char) *end))
+    {
+      end++;
+    }
+    if (*end != '\0' || regseq_operand_value(op, raw[i], &fields[i]) != 0)
+    {
+      return -1;
+    }
+    arg = strtok(NULL, ",");
+  }
+  if (arg != NULL || *length + isa->insn_size > REGSEQ_MAX_BYTES)
+  {
+    return -1;
+  }
+
+  len = regseq_encode(opc, fields, seq + *length);
+  if (len == XTENSA_UNDEFINED)
+  {
+    return -1;
+  }
+
+  // Find where each bit of an address register number lands by flipping
+  // it; the field functions only move bits, so exactly one bit changes
+  for (i = 0; i < iclass->num_operands; i++)
+  {
+    xtensa_operand_internal *op = &isa->operands[iclass->operands[i].u.operand_id];
+    struct xtensa_regseq_patch *patch = &patches[*num_patches];
+    uint32 saved = fields[i];
+
+    if (!(op->flags & XTENSA_OPERAND_IS_REGISTER) || (op->flags & XTENSA_OPERAND_IS_INVISIBLE)
+        || strcasecmp(isa->regfiles[op->regfile].shortname, "a") != 0)
+    {
+      continue;
+    }
+    if (*num_patches == REGSEQ_MAX_PATCHES)
+    {
+      return -1;
+    }
+
+    memset(patch, 0, sizeof(*patch));
+    patch->reg = raw[i];
+    // The ISA may count the physical registers, 64 say, but an operand
+    // names one of a0 to a15
+    while (patch->num_bits < XTENSA_REGSEQ_PATCH_BITS && (1 << patch->num_bits) < XTENSA_REGSEQ_NUM_AREGS
+           && (1 << patch->num_bits) < isa->regfiles[op->regfile].num_entries)
+    {
+      int changed = -1;
+
+      k = patch->num_bits;
+      if (regseq_operand_value(op, raw[i] ^ (1u << k), &fields[i]) != 0
+          || regseq_encode(opc, fields, probe) != len)
+      {
+        return -1;
+      }
+      for (b = 0; b < len * 8; b++)
+      {
+        if (((probe[b / 8] ^ seq[*length + b / 8]) >> (b % 8)) & 1)
+        {
+          if (changed != -1)
+          {
+            return -1;
+          }
+          changed = b;
+        }
+      }
+      if (changed == -1)
+      {
+        return -1;
+      }
+      patch->bits[patch->num_bits++] = *length * 8 + changed;
+    }
+    fields[i] = saved;
+    (*num_patches)++;
+  }
+
+  *length += len;
+  return 0;
+}
+
+struct regseq_shape
+{
+  int length;
+  int num_patches;
+};
+
+// Print the code and patches of the KIND string TEXT of register REG as
+// KIND_REG and KIND_REG_patches
+static struct regseq_shape regseq_print(FILE *out, int reg, const char *kind, const char *text)
+{
+  struct regseq_shape shape = { 0, 0 };
+  unsigned char seq[REGSEQ_MAX_BYTES];
+  struct xtensa_regseq_patch patches[REGSEQ_MAX_PATCHES];
+  char buf[REGSEQ_MAX_TEXT];
+  char *insn = NULL, *next = NULL;
+  int length = 0, num_patches = 0, i = 0, k = 0;
+
+  if (text == NULL)
+  {
+    return shape;
+  }
+  if (strlen(text) >= sizeof(buf))
+  {
+    fprintf(stderr, "xtensaconfig-gen: %s: %s of %s is too long\n", XTENSACONFIG_CHIP, kind, xtensa_rmap[reg].name);
+    return shape;
+  }
+  strcpy(buf, text);
+
+  for (insn = buf; insn != NULL; insn = next)
+  {
+    next = strpbrk(insn, ";\n");
+    if (next != NULL)
+    {
+      *next++ = '\0';
+    }
+    while (isspace((unsigned char) *insn))
+    {
+      insn++;
+    }
+    if (*insn != '\0' && regseq_insn(insn, seq, &length, patches, &num_patches) != 0)
+    {
+      // The debugger falls back to the string
+      fprintf(stderr, "xtensaconfig-gen: %s: cannot assemble %s \"%s\" of %s\n", XTENSACONFIG_CHIP, kind, text,
+              xtensa_rmap[reg].name);
+      return shape;
+    }
+  }
+  if (length == 0)
+  {
+    return shape;
+  }
+
+  fprintf(out, "static const unsigned char %s_%d[] =\n{", kind, reg);
+  for (i = 0; i < length; i++)
+  {
+    fprintf(out, "%s0x%02x", i ? ", " : " ", seq[i]);
+  }
+  fprintf(out, " };\n");
+  if (num_patches > 0)
+  {
+    fprintf(out, "static const struct xtensa_regseq_patch %s_%d_patches[] =\n{\n", kind, reg);
+    for (i = 0; i < num_patches; i++)
+    {
+      fprintf(out, "  { %d, %d, {", patches[i].reg, patches[i].num_bits);
+      for (k = 0; k < patches[i].num_bits; k++)
+      {
+        fprintf(out, "%s%d", k ? ", " : " ", patches[i].bits[k]);
+      }
+      fprintf(out, " } },\n");
+    }
+    fprintf(out, "};\n");
+  }
+  fprintf(out, "\n");
+
+  shape.length = length;
+  shape.num_patches = num_patches;
+  return shape;
+}
+
+static void regseq_print_entry(FILE *out, int reg, const char *kind, struct regseq_shape shape)
+{
+  if (shape.length == 0)
+  {
+    fprintf(out, "{ 0, 0, 0, 0 }");
+  }
+  else if (shape.num_patches == 0)
+  {
+    fprintf(out, "{ %s_%d, %d, 0, 0 }", kind, reg, shape.length);
+  }
+  else
+  {
+    fprintf(out, "{ %s_%d, %d, %s_%d_patches, %d }", kind, reg, shape.length, kind, reg, shape.num_patches);
+  }
+}
+
+// xtensa_regseq_data: the rmap fetch and store strings pre-assembled
+static int gen_regseq(FILE *out)
+{
+  struct regseq_shape *shapes = NULL;
+  int num_regs = 0, i = 0;
+
+  while (xtensa_rmap[num_regs].name != NULL)
+  {
+    num_regs++;
+  }
+  shapes = calloc(2 * num_regs + 1, sizeof(*shapes));
+  if (shapes == NULL)
+  {
+    return -1;
+  }
+
+  print_header(out);
+  fprintf(out, "#include \"xtensaconfig/regseq.h\"\n\n");
+  for (i = 0; i < num_regs; i++)
+  {
+    shapes[2 * i] = regseq_print(out, i, "fetch", xtensa_rmap[i].fetch);
+    shapes[2 * i + 1] = regseq_print(out, i, "store", xtensa_rmap[i].store);
+  }
+
+  fprintf(out, "static const struct xtensa_regseq_entry regs[%d] =\n{\n", num_regs > 0 ? num_regs : 1);
+  for (i = 0; i < num_regs; i++)
+  {
+    fprintf(out, "  /* %s */\n  { ", xtensa_rmap[i].name);
+    regseq_print_entry(out, i, "fetch", shapes[2 * i]);
+    fprintf(out, ",\n    ");
+    regseq_print_entry(out, i, "store", shapes[2 * i + 1]);
+    fprintf(out, " },\n");
+  }
+  fprintf(out, "};\n\n");
+  fprintf(out, "const struct xtensa_regseq_table xtensa_regseq_data = { %d, regs };\n", num_regs);
+  free(shapes);
+  return 0;
+}
+
+// 'g' packet layout: every register at its rmap offset in the packet and
+// at the next multiple of its alignment in the image
+
+static void gpacket_move(const struct xtensa_gpacket_run *run, unsigned char *dst, const unsigned char *src, int swap)
+{
+  unsigned int i = 0;
+
+  for (i = 0; i < run->length; i++)
+  {
+    dst[i] = swap ? src[i - i % run->elem + run->elem - 1 - i % run->elem] : src[i];
+  }
+}
+
+// Merge RUNS in place where both sides are contiguous (and, if SAME_ELEM,
+// the registers are of one size); returns the new number of runs
+static int gpacket_merge(struct xtensa_gpacket_run *runs, int n, int same_elem)
+{
+  int i = 0, m = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    struct xtensa_gpacket_run *last = m > 0 ? &runs[m - 1] : NULL;
+
+    if (runs[i].length == 0)
+    {
+      continue;
+    }
+    if (last != NULL && last->packet + last->length == runs[i].packet && last->image + last->length == runs[i].image
+        && (!same_elem || last->elem == runs[i].elem))
+    {
+      last->length += runs[i].length;
+    }
+    else
+    {
+      runs[m++] = runs[i];
+    }
+  }
+  return m;
+}
+
+static void gpacket_fill(unsigned char *buf, unsigned int size, unsigned int seed)
+{
+  unsigned int i = 0;
+
+  for (i = 0; i < size; i++)
+  {
+    buf[i] = i * 131 + (i >> 8) * 7 + seed;
+  }
+}
+
+// The merged runs must move the same bytes as the registers one by one
+// when unpacking and when packing, where registers sharing packet bytes
+// are stored in rmap order, and a packet unpacked and packed again must
+// come back wherever a register covers it
+static int gpacket_check(const struct xtensa_gpacket_run *regs, int num_regs, const struct xtensa_gpacket_run *runs,
+                         int num_runs, unsigned int packet_size, unsigned int image_size, int swap)
+{
+  unsigned int size = packet_size > image_size ? packet_size : image_size;
+  unsigned char *source = malloc(size + 1);
+  unsigned char *expected = malloc(size + 1);
+  unsigned char *result = malloc(size + 1);
+  unsigned char *again = malloc(size + 1);
+  unsigned int i = 0;
+  int ok = source && expected && result && again;
+
+  // Unpack
+  if (ok)
+  {
+    gpacket_fill(source, packet_size, 1);
+    memset(expected, 0, image_size);
+    memset(result, 0, image_size);
+  }
+  for (i = 0; ok && i < (unsigned int) num_regs; i++)
+  {
+    gpacket_move(&regs[i], expected + regs[i].image, source + regs[i].packet, swap);
+  }
+  for (i = 0; ok && i < (unsigned int) num_runs; i++)
+  {
+    gpacket_move(&runs[i], result + runs[i].image, source + runs[i].packet, swap);
+  }
+  ok = ok && memcmp(result, expected, image_size) == 0;
+
+  // Pack the unpacked image again
+  if (ok)
+  {
+    memset(again, 0, packet_size);
+  }
+  for (i = 0; ok && i < (unsigned int) num_runs; i++)
+  {
+    gpacket_move(&runs[i], again + runs[i].packet, result + runs[i].image, swap);
+  }
+  for (i = 0; ok && i < (unsigned int) num_regs; i++)
+  {
+    ok = memcmp(again + regs[i].packet, source + regs[i].packet, regs[i].length) == 0;
+  }
+
+  // Pack
+  if (ok)
+  {
+    gpacket_fill(source, image_size, 2);
+    memset(expected, 0, packet_size);
+    memset(result, 0, packet_size);
+  }
+  for (i = 0; ok && i < (unsigned int) num_regs; i++)
+  {
+    gpacket_move(&regs[i], expected + regs[i].packet, source + regs[i].image, swap);
+  }
+  for (i = 0; ok && i < (unsigned int) num_runs; i++)
+  {
+    gpacket_move(&runs[i], result + runs[i].packet, source + runs[i].image, swap);
+  }
+  ok = ok && memcmp(result, expected, packet_size) == 0;
+
+  free(source);
+  free(expected);
+  free(result);
+  free(again);
+  return ok ? 0 : -1;
+}
+
+static void gpacket_print_runs(FILE *out, const char *name, const struct xtensa_gpacket_run *runs, int n)
+{
+  int i = 0;
+
+  fprintf(out, "static const struct xtensa_gpacket_run %s[%d] =\n{\n", name, n > 0 ? n : 1);
+  for (i = 0; i < n; i++)
+  {
+    fprintf(out, "  { %u, %u, %u, %u },\n", runs[i].packet, runs[i].image, runs[i].length, runs[i].elem);
+  }
+  fprintf(out, "};\n\n");
+}
+
+// Place the NUM_REGS rmap registers in REGS: at their offset in the
+// packet and at the next multiple of their alignment in the image
+static void gpacket_place(struct xtensa_gpacket_run *regs, int num_regs, unsigned int *packet_size,
+                          unsigned int *image_size, unsigned int *image_align)
+{
+  int i = 0;
+
+  *packet_size = 0;
+  *image_size = 0;
+  *image_align = 1;
+  for (i = 0; i < num_regs; i++)
+  {
+    const xtensa_register_t *r = &xtensa_rmap[i];
+    unsigned int align = r->align > 0 ? r->align : 1;
+
+    if (r->mask != NULL || r->byte_size <= 0)
+    {
+      continue;
+    }
+    *image_size = (*image_size + align - 1) / align * align;
+    regs[i].packet = r->offset;
+    regs[i].image = *image_size;
+    regs[i].length = r->byte_size;
+    regs[i].elem = r->byte_size;
+    *image_size += r->byte_size;
+    if (align > *image_align)
+    {
+      *image_align = align;
+    }
+    if (regs[i].packet + regs[i].length > *packet_size)
+    {
+      *packet_size = regs[i].packet + regs[i].length;
+    }
+  }
+  *image_size = (*image_size + *image_align - 1) / *image_align * *image_align;
+}
+
+// Lay out the NUM_REGS registers into REGS and write the layout using
+// the scratch arrays COPY_RUNS and SWAP_RUNS
+static int gpacket_layout(FILE *out, struct xtensa_gpacket_run *regs, struct xtensa_gpacket_run *copy_runs,
+                          struct xtensa_gpacket_run *swap_runs, int num_regs)
+{
+  unsigned int packet_size = 0, image_size = 0, image_align = 1;
+  int num_copy = 0, num_swap = 0, i = 0;
+
+  gpacket_place(regs, num_regs, &packet_size, &image_size, &image_align);
+
+  memcpy(copy_runs, regs, num_regs * sizeof(*regs));
+  memcpy(swap_runs, regs, num_regs * sizeof(*regs));
+  num_copy = gpacket_merge(copy_runs, num_regs, 0);
+  num_swap = gpacket_merge(swap_runs, num_regs, 1);
+  for (i = 0; i < num_copy; i++)
+  {
+    copy_runs[i].elem = 1;
+  }
+
+  if (gpacket_check(regs, num_regs, copy_runs, num_copy, packet_size, image_size, 0) != 0
+      || gpacket_check(regs, num_regs, swap_runs, num_swap, packet_size, image_size, 1) != 0)
+  {
+    fprintf(stderr, "xtensaconfig-gen: %s: 'g' packet runs do not match the registers\n", XTENSACONFIG_CHIP);
+    return -1;
+  }
+
+  print_header(out);
+  fprintf(out, "#include \"xtensaconfig/gpacket.h\"\n\n");
+  gpacket_print_runs(out, "regs", regs, num_regs);
+  gpacket_print_runs(out, "copy_runs", copy_runs, num_copy);
+  gpacket_print_runs(out, "swap_runs", swap_runs, num_swap);
+  fprintf(out, "const struct xtensa_gpacket_layout xtensa_gpacket_layout_data =\n{\n");
+  fprintf(out, "  %u, %u, %u, %u,\n", xtensa_config.xchal_have_be, packet_size, image_size, image_align);
+  fprintf(out, "  %d, regs,\n  %d, copy_runs,\n  %d, swap_runs\n};\n", num_regs, num_copy, num_swap);
+  return 0;
+}
+
+static int gen_gpacket(FILE *out)
+{
+  struct xtensa_gpacket_run *regs = NULL, *copy_runs = NULL, *swap_runs = NULL;
+  int num_regs = 0, ret = -1;
+
+  while (xtensa_rmap[num_regs].name != NULL)
+  {
+    num_regs++;
+  }
+  regs = calloc(num_regs + 1, sizeof(*regs));
+  copy_runs = calloc(num_regs + 1, sizeof(*copy_runs));
+  swap_runs = calloc(num_regs + 1, sizeof(*swap_runs));
+  if (regs != NULL && copy_runs != NULL && swap_runs != NULL)
+  {
+    ret = gpacket_layout(out, regs, copy_runs, swap_runs, num_regs);
+  }
+  free(regs);
+  free(copy_runs);
+  free(swap_runs);
+  return ret;
+}
+
+// Composite registers compiled to shift-and-or code over the register
+// image laid out by gpacket_place
+
+static int composite_compilable(const xtensa_register_t *r, int num_regs)
+{
+  int bits = 0, i = 0;
+
+  for (i = 0; i < r->mask->count; i++)
+  {
+    const xtensa_reg_mask_t *m = &r->mask->mask[i];
+    const xtensa_register_t *part = NULL;
+
+    if (m->reg_num < 0 || m->reg_num >= num_regs)
+    {
+      return 0;
+    }
+    part = &xtensa_rmap[m->reg_num];
+    if (part->mask != NULL || (part->byte_size != 1 && part->byte_size != 2 && part->byte_size != 4 && part->byte_size != 8)
+        || m->bit_size <= 0 || m->bit_start < 0 || m->bit_start + m->bit_size > part->byte_size * 8)
+    {
+      return 0;
+    }
+    bits += m->bit_size;
+  }
+  return bits > 0 && bits <= 64;
+}
+
+static void composite_print_mask(FILE *out, int bit_size)
+{
+  fprintf(out, "0x%llxull", bit_size == 64 ? ~0ull : (1ull << bit_size) - 1);
+}
+
+static void composite_print(FILE *out, int reg, const struct xtensa_gpacket_run *image)
+{
+  const xtensa_mask_t *mask = xtensa_rmap[reg].mask;
+  int shift = 0, i = 0;
+
+  fprintf(out, "/* %s */\n\nstatic uint64_t\nread_%d (const unsigned char *image)\n{\n  return", xtensa_rmap[reg].name, reg);
+  for (i = 0; i < mask->count; i++)
+  {
+    const xtensa_reg_mask_t *m = &mask->mask[i];
+
+    fprintf(out, "%s((load%d (image + %u) >> %d) & ", i ? "\n    | " : " ", image[m->reg_num].length * 8,
+            image[m->reg_num].image, m->bit_start);
+    composite_print_mask(out, m->bit_size);
+    fprintf(out, ") << %d", shift);
+    shift += m->bit_size;
+  }
+  fprintf(out, ";\n}\n\n");
+
+  fprintf(out, "static void\nwrite_%d (unsigned char *image, uint64_t value)\n{\n", reg);
+  for (shift = 0, i = 0; i < mask->count; i++)
+  {
+    const xtensa_reg_mask_t *m = &mask->mask[i];
+    int size = image[m->reg_num].length * 8;
+    unsigned int offset = image[m->reg_num].image;
+
+    fprintf(out, "  store%d (image + %u, (load%d (image + %u) & ~(", size, offset, size, offset);
+    composite_print_mask(out, m->bit_size);
+    fprintf(out, " << %d))\n\t   | ((value >> %d) & ", m->bit_start, shift);
+    composite_print_mask(out, m->bit_size);
+    fprintf(out, ") << %d);\n", m->bit_start);
+    shift += m->bit_size;
+  }
+  fprintf(out, "}\n\n");
+}
+
+static int composite_tables(FILE *out, struct xtensa_gpacket_run *image, int *composite_of, int num_regs)
+{
+  unsigned int packet_size = 0, image_size = 0, image_align = 0;
+  int num_composites = 0, num_compiled = 0, size = 0, i = 0;
+
+  gpacket_place(image, num_regs, &packet_size, &image_size, &image_align);
+
+  print_header(out);
+  fprintf(out, "#include <stdint.h>\n#include <string.h>\n\n#include \"xtensaconfig/composite.h\"\n\n");
+  for (size = 8; size <= 64; size *= 2)
+  {
+    fprintf(out, "static inline uint64_t\nload%d (const unsigned char *p)\n{\n", size);
+    fprintf(out, "  uint%d_t v;\n\n  memcpy (&v, p, sizeof (v));\n  return v;\n}\n\n", size);
+    fprintf(out, "static inline void\nstore%d (unsigned char *p, uint64_t value)\n{\n", size);
+    fprintf(out, "  uint%d_t v = value;\n\n  memcpy (p, &v, sizeof (v));\n}\n\n", size);
+  }
+
+  for (i = 0; i < num_regs; i++)
+  {
+    composite_of[i] = -1;
+    if (xtensa_rmap[i].mask != NULL)
+    {
+      composite_of[i] = num_composites++;
+      if (composite_compilable(&xtensa_rmap[i], num_regs))
+      {
+        composite_print(out, i, image);
+      }
+    }
+  }
+
+  fprintf(out, "static void\nread_all (const unsigned char *image, uint64_t *values)\n{\n");
+  for (i = 0; i < num_regs; i++)
+  {
+    if (composite_of[i] >= 0 && composite_compilable(&xtensa_rmap[i], num_regs))
+    {
+      fprintf(out, "  values[%d] = read_%d (image);\n", composite_of[i], i);
+      num_compiled++;
+    }
+  }
+  fprintf(out, "%s}\n\n", num_compiled ? "" : "  (void) image;\n  (void) values;\n");
+
+  fprintf(out, "static const struct xtensa_composite composites[%d] =\n{\n", num_composites > 0 ? num_composites : 1);
+  for (i = 0; i < num_regs; i++)
+  {
+    if (composite_of[i] < 0)
+    {
+      continue;
+    }
+    if (composite_compilable(&xtensa_rmap[i], num_regs))
+    {
+      int bits = 0, k = 0;
+
+      for (k = 0; k < xtensa_rmap[i].mask->count; k++)
+      {
+        bits += xtensa_rmap[i].mask->mask[k].bit_size;
+      }
+      fprintf(out, "  { %d, %d, read_%d, write_%d },\n", i, bits, i, i);
+    }
+    else
+    {
+      fprintf(out, "  { %d, 0, 0, 0 },\n", i);
+    }
+  }
+  fprintf(out, "};\n\nstatic const int composite_of[%d] =\n{", num_regs > 0 ? num_regs : 1);
+  for (i = 0; i < num_regs; i++)
+  {
+    fprintf(out, "%s%d", i % 16 ? ", " : "\n  ", composite_of[i]);
+  }
+  fprintf(out, "\n};\n\n");
+  fprintf(out, "const struct xtensa_composite_table xtensa_composite_data =\n{\n");
+  fprintf(out, "  %d, composites,\n  %d, composite_of,\n  read_all\n};\n", num_composites, num_regs);
+  return 0;
+}
+
+static int gen_composite(FILE *out)
+{
+  struct xtensa_gpacket_run *image = NULL;
+  int *composite_of = NULL;
+  int num_regs = 0, ret = -1;
+
+  while (xtensa_rmap[num_regs].name != NULL)
+  {
+    num_regs++;
+  }
+  image = calloc(num_regs + 1, sizeof(*image));
+  composite_of = calloc(num_regs + 1, sizeof(int));
+  if (image != NULL && composite_of != NULL)
+  {
+    ret = composite_tables(out, image, composite_of, num_regs);
+  }
+  free(image);
+  free(composite_of);
+  return ret;
+}
+
+// Hash index over the rmap by name and target number, filled with the
+// hashes of src/regindex.c
+
+static int regindex_tables(FILE *out, int *by_name, int *by_number, unsigned int num_slots, int num_regs)
+{
+  unsigned int mask = num_slots - 1, slot = 0;
+  int i = 0;
+
+  for (slot = 0; slot < num_slots; slot++)
+  {
+    by_name[slot] = by_number[slot] = -1;
+  }
+  // First in rmap order wins, like a scan
+  for (i = 0; i < num_regs; i++)
+  {
+    const xtensa_register_t *r = &xtensa_rmap[i];
+
+    slot = xtensa_regindex_hash_name(r->name) & mask;
+    while (by_name[slot] >= 0 && strcmp(xtensa_rmap[by_name[slot]].name, r->name) != 0)
+    {
+      slot = (slot + 1) & mask;
+    }
+    if (by_name[slot] < 0)
+    {
+      by_name[slot] = i;
+    }
+
+    slot = xtensa_regindex_hash_number(r->target_number) & mask;
+    while (by_number[slot] >= 0 && xtensa_rmap[by_number[slot]].target_number != r->target_number)
+    {
+      slot = (slot + 1) & mask;
+    }
+    if (by_number[slot] < 0)
+    {
+      by_number[slot] = i;
+    }
+  }
+
+  print_header(out);
+  fprintf(out, "#include \"xtensaconfig/regindex.h\"\n\n");
+  fprintf(out, "static const struct xtensa_regindex_name by_name[%u] =\n{\n", num_slots);
+  for (slot = 0; slot < num_slots; slot++)
+  {
+    if (by_name[slot] >= 0)
+    {
+      fprintf(out, "  { \"%s\", %d },\n", xtensa_rmap[by_name[slot]].name, by_name[slot]);
+    }
+    else
+    {
+      fprintf(out, "  { 0, -1 },\n");
+    }
+  }
+  fprintf(out, "};\n\nstatic const struct xtensa_regindex_number by_number[%u] =\n{\n", num_slots);
+  for (slot = 0; slot < num_slots; slot++)
+  {
+    if (by_number[slot] >= 0)
+    {
+      fprintf(out, "  { 0x%x, %d },\n", xtensa_rmap[by_number[slot]].target_number, by_number[slot]);
+    }
+    else
+    {
+      fprintf(out, "  { 0, -1 },\n");
+    }
+  }
+  fprintf(out, "};\n\nconst struct xtensa_regindex xtensa_regindex_data =\n{\n");
+  fprintf(out, "  %d, %u,\n  by_name,\n  by_number\n};\n", num_regs, num_slots);
+  return 0;
+}
+
+static int gen_regindex(FILE *out)
+{
+  int *by_name = NULL, *by_number = NULL;
+  unsigned int num_slots = 2;
+  int num_regs = 0, ret = -1;
+
+  while (xtensa_rmap[num_regs].name != NULL)
+  {
+    num_regs++;
+  }
+  // At most half full, so probe sequences stay short
+  while (num_slots < 2u * num_regs)
+  {
+    num_slots *= 2;
+  }
+  by_name = calloc(num_slots, sizeof(int));
+  by_number = calloc(num_slots, sizeof(int));
+  if (by_name != NULL && by_number != NULL)
+  {
+    ret = regindex_tables(out, by_name, by_number, num_slots, num_regs);
+  }
+  free(by_name);
+  free(by_number);
+  return ret;
+}
+
+// GDB target-description XML of the rmap, rendered into a growing
+// buffer and printed as one string literal
+
+struct tdesc_text
+{
+  char *data;
+  size_t length;
+  size_t size;
+  int failed;
+};
+
+static void tdesc_printf(struct tdesc_text *text, const char *fmt, ...)
+{
+  va_list va;
+  char *data = NULL;
+  int n = 0;
+
+  for (;;)
+  {
+    va_start(va, fmt);
+    n = text->failed ? -1 : vsnprintf(text->data + text->length, text->size - text->length, fmt, va);
+    va_end(va);
+    if (n < 0)
+    {
+      text->failed = 1;
+      return;
+    }
+    if (text->length + n < text->size)
+    {
+      text->length += n;
+      return;
+    }
+    data = realloc(text->data, text->size * 2 + n + 1);
+    if (data == NULL)
+    {
+      text->failed = 1;
+      return;
+    }
+    text->data = data;
+    text->size = text->size * 2 + n + 1;
+  }
+}
+
+// Register names are identifiers in practice, escape them all the same
+static void tdesc_name(struct tdesc_text *text, const char *name)
+{
+  for (; *name; name++)
+  {
+    switch (*name)
+    {
+      case '&':
+        tdesc_printf(text, "&amp;");
+        break;
+      case '<':
+        tdesc_printf(text, "&lt;");
+        break;
+      case '>':
+        tdesc_printf(text, "&gt;");
+        break;
+      case '"':
+        tdesc_printf(text, "&quot;");
+        break;
+      default:
+        tdesc_printf(text, "%c", *name);
+        break;
+    }
+  }
+}
+
+static const char *tdesc_group(const xtensa_register_t *r)
+{
+  if (r->group & xtRegisterGroupFloat)
+  {
+    return "float";
+  }
+  if (r->group & xtRegisterGroupVectra)
+  {
+    return "vector";
+  }
+  if (r->group & (xtRegisterGroupGeneral | xtRegisterGroupAddrReg))
+  {
+    return "general";
+  }
+  if (r->group & xtRegisterGroupSystem)
+  {
+    return "system";
+  }
+  if (r->group & xtRegisterGroupUser)
+  {
+    return "user";
+  }
+  return NULL;
+}
+
+// Raw registers are the ones the stub sends in the 'g' packet: not
+// composite, and not the a0..a15 window, which the debugger computes
+// from windowbase and the ar registers
+static int tdesc_is_raw(const xtensa_register_t *r)
+{
+  return r->mask == NULL && r->type != xtRegisterTypeWindow;
+}
+
+// GDB number of every rmap register, or -1: raw registers numbered in
+// the order of their offsets in the 'g' packet, as GDB expects the
+// packet to be laid out
+static void tdesc_regnums(int *regnum, int num_regs)
+{
+  int i = 0, j = 0;
+
+  for (i = 0; i < num_regs; i++)
+  {
+    regnum[i] = -1;
+    if (!tdesc_is_raw(&xtensa_rmap[i]))
+    {
+      continue;
+    }
+    regnum[i] = 0;
+    for (j = 0; j < num_regs; j++)
+    {
+      if (tdesc_is_raw(&xtensa_rmap[j])
+          && (xtensa_rmap[j].offset < xtensa_rmap[i].offset
+              || (xtensa_rmap[j].offset == xtensa_rmap[i].offset && j < i)))
+      {
+        regnum[i]++;
+      }
+    }
+  }
+}
+
+static void tdesc_reg(struct tdesc_text *text, int reg, int regnum)
+{
+  const xtensa_register_t *r = &xtensa_rmap[reg];
+  const char *group = tdesc_group(r);
+
+  tdesc_printf(text, "    <reg name=\"");
+  tdesc_name(text, r->name);
+  tdesc_printf(text, "\" bitsize=\"%d\" regnum=\"%d\"", r->bit_size, regnum);
+  if (strcmp(r->name, "pc") == 0)
+  {
+    tdesc_printf(text, " type=\"code_ptr\"");
+  }
+  else if (r->bit_size == 8 || r->bit_size == 16 || r->bit_size == 32 || r->bit_size == 64 || r->bit_size == 128)
+  {
+    tdesc_printf(text, " type=\"uint%d\"", r->bit_size);
+  }
+  if (group != NULL)
+  {
+    tdesc_printf(text, " group=\"%s\"", group);
+  }
+  tdesc_printf(text, "/>\n");
+}
+
+// Raw registers of coprocessor CP (-2 for the base, -1 for other options)
+static void tdesc_feature(struct tdesc_text *text, int cp, const int *regnum)
+{
+  int opened = 0, i = 0;
+
+  for (i = 0; xtensa_rmap[i].name != NULL; i++)
+  {
+    if (regnum[i] < 0 || (xtensa_rmap[i].coprocessor < -1 ? -2 : xtensa_rmap[i].coprocessor) != cp)
+    {
+      continue;
+    }
+    if (!opened)
+    {
+      if (cp >= 0)
+      {
+        tdesc_printf(text, "  <feature name=\"org.gnu.gdb.xtensa.cp%d\">\n", cp);
+      }
+      else
+      {
+        tdesc_printf(text, "  <feature name=\"org.gnu.gdb.xtensa.%s\">\n", cp == -2 ? "core" : "ncp");
+      }
+      opened = 1;
+    }
+    tdesc_reg(text, i, regnum[i]);
+  }
+  if (opened)
+  {
+    tdesc_printf(text, "  </feature>\n");
+  }
+}
+
+// GDB's xcrc32
+static uint32_t tdesc_crc32(const char *data, size_t length)
+{
+  uint32_t crc = 0xffffffff;
+  size_t i = 0;
+  int bit = 0;
+
+  for (i = 0; i < length; i++)
+  {
+    crc ^= (uint32_t) (unsigned char) data[i] << 24;
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = crc & 0x80000000 ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static int gen_tdesc(FILE *out)
+{
+  struct tdesc_text text = { malloc(4096), 0, 4096, 0 };
+  int *regnum = NULL;
+  size_t i = 0;
+  int num_regs = 0, cp = 0;
+
+  while (xtensa_rmap[num_regs].name != NULL)
+  {
+    num_regs++;
+  }
+  regnum = calloc(num_regs + 1, sizeof(int));
+  text.failed = text.data == NULL || regnum == NULL;
+  if (regnum != NULL)
+  {
+    tdesc_regnums(regnum, num_regs);
+  }
+  tdesc_printf(&text, "<?xml version=\"1.0\"?>\n<!DOCTYPE target SYSTEM \"gdb-target.dtd\">\n");
+  tdesc_printf(&text, "<target version=\"1.0\">\n  <architecture>xtensa</architecture>\n");
+  for (cp = -2; cp < XTENSA_MAX_COPROCESSOR && !text.failed; cp++)
+  {
+    tdesc_feature(&text, cp, regnum);
+  }
+  tdesc_printf(&text, "</target>\n");
+  free(regnum);
+  if (text.failed)
+  {
+    fprintf(stderr, "xtensaconfig-gen: %s: out of memory\n", XTENSACONFIG_CHIP);
+    free(text.data);
+    return -1;
+  }
+
+  print_header(out);
+  fprintf(out, "#include \"xtensaconfig/tdesc.h\"\n\nstatic const char xml[] =");
+  for (i = 0; i < text.length; i++)
+  {
+    if (i == 0 || text.data[i - 1] == '\n')
+    {
+      fprintf(out, "\n  \"");
+    }
+    if (text.data[i] == '\n')
+    {
+      fprintf(out, "\\n\"");
+    }
+    else
+    {
+      fprintf(out, "%s%c", text.data[i] == '"' || text.data[i] == '\\' ? "\\" : "", text.data[i]);
+    }
+  }
+  fprintf(out, ";\n\nconst struct xtensa_tdesc xtensa_tdesc_data =\n{\n");
+  fprintf(out, "  xml,\n  sizeof (xml) - 1,\n  0x%08x\n};\n", (unsigned int) tdesc_crc32(text.data, text.length));
+  free(text.data);
+  return 0;
+}
+
+// Scheduling tables of xtensaconfig/sched.h: the functional-unit uses of
+// every opcode, so that the compiler's model needs no ISA tables
+static int gen_sched(FILE *out)
+{
+  const xtensa_isa_internal *isa = &xtensa_modules;
+  int issue_rate = 1, total = 0, fmt = 0, opc = 0, u = 0;
+
+  for (fmt = 0; fmt < isa->num_formats; fmt++)
+  {
+    if (isa->formats[fmt].num_slots > issue_rate)
+    {
+      issue_rate = isa->formats[fmt].num_slots;
+    }
+  }
+
+  print_header(out);
+  fprintf(out, "#include \"xtensaconfig/sched.h\"\n\nstatic const struct xtensa_sched_use uses[] =\n{\n");
+  for (opc = 0; opc < isa->num_opcodes; opc++)
+  {
+    const xtensa_opcode_internal *op = &isa->opcodes[opc];
+
+    for (u = 0; u < op->num_funcUnit_uses; u++)
+    {
+      fprintf(out, "  { %d, %d },\n", op->funcUnit_uses[u].unit, op->funcUnit_uses[u].stage);
+      total++;
+    }
+  }
+  fprintf(out, "%s};\n\nstatic const int unit_copies[] =\n{\n", total ? "" : "  { 0, 0 }\n");
+  for (u = 0; u < isa->num_funcUnits; u++)
+  {
+    fprintf(out, "  %d, /* %s */\n", isa->funcUnits[u].num_copies, isa->funcUnits[u].name);
+  }
+  fprintf(out, "%s};\n\nstatic const struct xtensa_sched_opcode opcodes[] =\n{\n",
+          isa->num_funcUnits ? "" : "  0\n");
+  for (opc = 0, total = 0; opc < isa->num_opcodes; opc++)
+  {
+    fprintf(out, "  { \"%s\", %d, &uses[%d] },\n", isa->opcodes[opc].name, isa->opcodes[opc].num_funcUnit_uses,
+            total);
+    total += isa->opcodes[opc].num_funcUnit_uses;
+  }
+  fprintf(out, "%s};\n\nconst struct xtensa_sched_tables xtensa_sched_tables_data =\n{\n",
+          isa->num_opcodes ? "" : "  { 0, 0, 0 }\n");
+  fprintf(out, "  %d,\n  %d,\n  unit_copies,\n  %d,\n  opcodes\n};\n", issue_rate, isa->num_funcUnits,
+          isa->num_opcodes);
+  return 0;
+}
+
+static const struct
+{
+  const char *name;
+  int (*gen)(FILE *out);
+} s_commands[] =
+{
+  { "fingerprint", gen_fingerprint },
+  { "traits", gen_traits },
+  { "decoder", gen_decoder },
+  { "regseq", gen_regseq },
+  { "gpacket", gen_gpacket },
+  { "composite", gen_composite },
+  { "regindex", gen_regindex },
+  { "tdesc", gen_tdesc },
+  { "sched", gen_sched },
+};
+
+int main(int argc, char **argv)
+{
+  size_t i = 0;
+
+  if (argc == 2)
+  {
+    for (i = 0; i < sizeof(s_commands) / sizeof(s_commands[0]); i++)
+    {
+      if (strcmp(argv[1], s_commands[i].name) == 0)
+      {
+        return s_commands[i].gen(stdout) || fflush(stdout) ? EXIT_FAILURE : EXIT_SUCCESS;
+      }
+    }
+  }
+
+  fprintf(stderr, "usage: %s <command>\ncommands:", argv[0]);
+  for (i = 0; i < sizeof(s_commands) / sizeof(s_commands[0]); i++)
+  {
+    fprintf(stderr, " %s", s_commands[i].name);
+  }
+  fprintf(stderr, "\n");
+  return EXIT_FAILURE;
+}